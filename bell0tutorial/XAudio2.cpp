@@ -7,6 +7,10 @@
 #pragma comment(lib, "mfplat.lib")
 #pragma comment(lib, "mfuuid")
 
+// memory streams
+#include <Shlwapi.h>
+#pragma comment(lib, "Shlwapi.lib")
+
 // multithreading
 #include <thread>
 
@@ -19,13 +23,16 @@
 // bell0bytes audio
 #include "audioComponent.h"
 
+// bell0bytes file system
+#include "fileSystemComponent.h"
+
 namespace audio
 {
 
 	/////////////////////////////////////////////////////////////////////////////////////////
 	////////////////////////////// Constructor //////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
-	AudioEngine::AudioEngine() : dev(NULL), masterVoice(NULL)
+	AudioEngine::AudioEngine(const fileSystem::FileSystemComponent& fileSystemComponent) : dev(NULL), masterVoice(NULL), fileSystemComponent(fileSystemComponent)
 	{
 		util::Expected<void> result = initialize();
 
@@ -94,24 +101,95 @@ namespace audio
 	/////////////////////////////////////////////////////////////////////////////////////////
 	//////////////////////////////////////// Load ///////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
-	util::Expected<void> AudioEngine::loadFile(const std::wstring& filename, std::vector<BYTE>& audioData, WAVEFORMATEX** waveFormatEx, unsigned int& waveFormatLength)
+	util::Expected<void> AudioEngine::createSourceReader(const std::wstring& filename, IMFSourceReader** sourceReader)
 	{
 		// handle errors
 		HRESULT hr = S_OK;
 
-		// stream index
-		DWORD streamIndex = (DWORD)MF_SOURCE_READER_FIRST_AUDIO_STREAM;
+		// loose files are read by Media Foundation
+		if (GetFileAttributesW(filename.c_str()) != INVALID_FILE_ATTRIBUTES)
+		{
+			hr = MFCreateSourceReaderFromURL(filename.c_str(), sourceReaderConfiguration.Get(), sourceReader);
+			if (FAILED(hr))
+				return std::runtime_error("Critical error: Unable to create source reader from URL!");
+
+			// return success
+			return { };
+		}
+
+		// the other files are read from the pack archive
+		fileSystem::FileData fileData;
+		util::Expected<void> result = fileSystemComponent.readFile(filename, fileData);
+		if (!result.isValid())
+			return result;
+
+		return createSourceReader(fileData, filename, sourceReader);
+	}
+	util::Expected<void> AudioEngine::createSourceReader(const fileSystem::FileData& fileData, const std::wstring& filename, IMFSourceReader** sourceReader)
+	{
+		// handle errors
+		HRESULT hr = S_OK;
+
+		// Media Foundation reads from a stream in memory, which holds a copy of the file data
+		Microsoft::WRL::ComPtr<IStream> stream;
+		stream.Attach(SHCreateMemStream(fileData.getData(), (UINT)fileData.getSize()));
+		if (!stream)
+			return std::runtime_error("Critical error: Unable to create a memory stream!");
+
+		Microsoft::WRL::ComPtr<IMFByteStream> byteStream;
+		hr = MFCreateMFByteStreamOnStream(stream.Get(), byteStream.GetAddressOf());
+		if (FAILED(hr))
+			return std::runtime_error("Critical error: Unable to create a byte stream!");
 
+		// the file name helps Media Foundation to find the right decoder
+		Microsoft::WRL::ComPtr<IMFAttributes> byteStreamAttributes;
+		if (SUCCEEDED(byteStream.As(&byteStreamAttributes)))
+			byteStreamAttributes->SetString(MF_BYTESTREAM_ORIGIN_NAME, filename.c_str());
+
+		hr = MFCreateSourceReaderFromByteStream(byteStream.Get(), sourceReaderConfiguration.Get(), sourceReader);
+		if (FAILED(hr))
+			return std::runtime_error("Critical error: Unable to create source reader from byte stream!");
+
+		// return success
+		return { };
+	}
+	util::Expected<void> AudioEngine::loadFile(const std::wstring& filename, std::vector<BYTE>& audioData, WAVEFORMATEX** waveFormatEx, unsigned int& waveFormatLength)
+	{
 		// the source reader to synchronous mode
-		hr = sourceReaderConfiguration->SetUnknown(MF_SOURCE_READER_ASYNC_CALLBACK, NULL);
+		HRESULT hr = sourceReaderConfiguration->SetUnknown(MF_SOURCE_READER_ASYNC_CALLBACK, NULL);
 		if (FAILED(hr))
 			return std::runtime_error("Critical error: Unable to set the source reader callback class for synchronous read!");
 
 		// create the source reader
 		Microsoft::WRL::ComPtr<IMFSourceReader> sourceReader;
-		hr = MFCreateSourceReaderFromURL(filename.c_str(), sourceReaderConfiguration.Get(), sourceReader.GetAddressOf());
+		util::Expected<void> result = createSourceReader(filename, sourceReader.GetAddressOf());
+		if (!result.isValid())
+			return result;
+
+		return readAudioData(sourceReader.Get(), audioData, waveFormatEx, waveFormatLength);
+	}
+	util::Expected<void> AudioEngine::loadFile(const fileSystem::FileData& fileData, const std::wstring& filename, std::vector<BYTE>& audioData, WAVEFORMATEX** waveFormatEx, unsigned int& waveFormatLength)
+	{
+		// the source reader to synchronous mode
+		HRESULT hr = sourceReaderConfiguration->SetUnknown(MF_SOURCE_READER_ASYNC_CALLBACK, NULL);
 		if (FAILED(hr))
-			return std::runtime_error("Critical error: Unable to create source reader from URL!");
+			return std::runtime_error("Critical error: Unable to set the source reader callback class for synchronous read!");
+
+		// create the source reader
+		Microsoft::WRL::ComPtr<IMFSourceReader> sourceReader;
+		util::Expected<void> result = createSourceReader(fileData, filename, sourceReader.GetAddressOf());
+		if (!result.isValid())
+			return result;
+
+		return readAudioData(sourceReader.Get(), audioData, waveFormatEx, waveFormatLength);
+	}
+	util::Expected<void> AudioEngine::readAudioData(IMFSourceReader* const sourceReader, std::vector<BYTE>& audioData, WAVEFORMATEX** waveFormatEx, unsigned int& waveFormatLength)
+	{
+		// handle errors
+		HRESULT hr = S_OK;
+
+		// stream index
+		DWORD streamIndex = (DWORD)MF_SOURCE_READER_FIRST_AUDIO_STREAM;
 
 		// select the first audio stream, and deselect all other streams
 		hr = sourceReader->SetStreamSelection((DWORD)MF_SOURCE_READER_ALL_STREAMS, false);
@@ -372,9 +450,9 @@ namespace audio
 			return std::runtime_error("Critical error: Unable to set the source reader callback class for asynchronous read!");
 
 		// create the source reader
-		hr = MFCreateSourceReaderFromURL(filename.c_str(), sourceReaderConfiguration.Get(), sourceReader);
-		if (FAILED(hr))
-			return std::runtime_error("Critical error: Unable to create source reader from URL!");
+		util::Expected<void> result = createSourceReader(filename, sourceReader);
+		if (!result.isValid())
+			return result;
 
 		// stream index
 		DWORD streamIndex = (DWORD)MF_SOURCE_READER_FIRST_AUDIO_STREAM;
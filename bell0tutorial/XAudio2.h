@@ -6,7 +6,8 @@
 *
 * Desc:		XAudio2
 *
-* History:
+* History:	- 16/09/2019: the audio files can be read from the pack archive
+*			- 20/09/2019: the audio files can be decoded from file data that was already read
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
@@ -30,6 +31,12 @@
 #include "expected.h"
 
 // CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace fileSystem
+{
+	class FileSystemComponent;
+	class FileData;
+}
+
 namespace audio
 {
 	class AudioComponent;
@@ -118,6 +125,7 @@ namespace audio
 		Microsoft::WRL::ComPtr<IXAudio2> dev;							// the main XAudio2 engine
 		IXAudio2MasteringVoice* masterVoice;							// a mastering voice
 		Microsoft::WRL::ComPtr<IMFAttributes> sourceReaderConfiguration;// Windows Media Foundation Source Reader Configuration
+		const fileSystem::FileSystemComponent& fileSystemComponent;		// reads the audio files that are only in the pack archive
 
 		// streaming variables
 		SourceReaderCallback sourceReaderCallback;						// callback structure for the source reader
@@ -128,8 +136,14 @@ namespace audio
 		// initialization
 		util::Expected<void> initialize();								// this function initializes the XAudio2 interface
 		
+		// creates a source reader for a loose file, or for a file in the pack archive
+		util::Expected<void> createSourceReader(const std::wstring& filename, IMFSourceReader** sourceReader);
+		util::Expected<void> createSourceReader(const fileSystem::FileData& fileData, const std::wstring& filename, IMFSourceReader** sourceReader);	// reads from a copy of the file data in memory; the file name helps to find the decoder
+
 		// read audio data from the harddrive
 		util::Expected<void> loadFile(const std::wstring& filename, std::vector<BYTE>& audioData, WAVEFORMATEX** wafeFormatEx, unsigned int& waveLength);	// load audio file from disk
+		util::Expected<void> loadFile(const fileSystem::FileData& fileData, const std::wstring& filename, std::vector<BYTE>& audioData, WAVEFORMATEX** wafeFormatEx, unsigned int& waveLength);	// decode an audio file that was already read
+		util::Expected<void> readAudioData(IMFSourceReader* const sourceReader, std::vector<BYTE>& audioData, WAVEFORMATEX** wafeFormatEx, unsigned int& waveLength);	// decodes the first audio stream of the source reader
 		
 		// stream audio
 		util::Expected<void> createAsyncReader(const std::wstring& filename, IMFSourceReader** sourceReader, WAVEFORMATEX* wfx, size_t wfxSize);			// creates a source reader in asynchrononous mode
@@ -138,7 +152,7 @@ namespace audio
 
 	public:
 		// constructor and destructor
-		AudioEngine();
+		AudioEngine(const fileSystem::FileSystemComponent& fileSystemComponent);
 		~AudioEngine();
 
 		friend class AudioComponent;
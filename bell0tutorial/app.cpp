@@ -3,6 +3,14 @@
 // the header
 #include "app.h"
 
+// C++ includes
+#include <algorithm>
+#include <fstream>
+
+// Windows includes
+#include <shellapi.h>
+#pragma comment(lib, "Shell32.lib")
+
 // bell0bytes core
 #include "coreComponent.h"
 #include "timer.h"
@@ -11,6 +19,7 @@
 
 // bell0bytes file system
 #include "fileSystemComponent.h"
+#include "fileIOService.h"
 
 // bell0bytes graphics
 #include "graphicsComponent.h"
@@ -25,6 +34,7 @@
 
 // bell0bytes util
 #include "serviceLocator.h"
+#include "logFilter.h"
 
 // bell0bytes audio
 #include "audioComponent.h"
@@ -32,13 +42,27 @@
 // bell0bytes number theory
 #include "numberTheory.h"
 
+// bell0bytes physics
+#include "particleBudget.h"
+#include "particleSystem.h"
+
 // CLASS METHODS ////////////////////////////////////////////////////////////////////////
 namespace core
 {
 	/////////////////////////////////////////////////////////////////////////////////////////
 	////////////////////////////// Constructors /////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
-	DirectXApp::DirectXApp() : applicationIsPaused(true), fps(0), mspf(0.0), dt(1.0f/10000.0f), maxSkipFrames(100), applicationStarted(false), showFPS(true), stateStackChanged(false), audioComponent(nullptr), coreComponent(nullptr), fileSystemComponent(nullptr), graphicsComponent(nullptr), inputComponent(nullptr), numberTheory(nullptr) { }
+	DirectXApp::DirectXApp() : applicationIsPaused(true), fps(0), mspf(0.0), dt(1.0f/10000.0f), maxSkipFrames(100), applicationStarted(false), showFPS(true), stateStackChanged(false), subscribersChanged(true), gameTime(0.0), hotReload(false), audioComponent(nullptr), coreComponent(nullptr), fileSystemComponent(nullptr), fileIOService(nullptr), graphicsComponent(nullptr), inputComponent(nullptr), numberTheory(nullptr)
+	{
+#if DEPESCHE_STATISTICS
+		messageStatistics.reset(new DepescheStatistics());
+#endif
+
+		// debug builds reload the configuration files by default
+#ifndef NDEBUG
+		hotReload = true;
+#endif
+	}
 	DirectXApp::~DirectXApp()
 	{
 		shutdown();
@@ -52,6 +76,10 @@ namespace core
 		// initialize file system components
 		try { fileSystemComponent = new fileSystem::FileSystemComponent(manufacturerName, applicationName, applicationVersion); }
 		catch (std::runtime_error& e) { return e; }
+
+		// the workers that read files asynchronously
+		try { fileIOService = new fileSystem::FileIOService(*this, *fileSystemComponent); }
+		catch (std::system_error& e) { return e; }
 			
 		// create the core components (mainly the window and timer class)
 		try { coreComponent = new CoreComponent(*this, hInstance, windowTitle); }
@@ -69,19 +97,142 @@ namespace core
 		// initialize audio component
 		try { audioComponent = new audio::AudioComponent(*this); }
 		catch (std::runtime_error& e) { return e; }
+
+		// the audio component listens to all audio messages
+		subscribe(DepescheTypes::PlaySoundEvent, *audioComponent);
+		subscribe(DepescheTypes::StopSoundEvent, *audioComponent);
+		subscribe(DepescheTypes::BeginStream, *audioComponent);
+		subscribe(DepescheTypes::EndStream, *audioComponent);
 	
 		// start the application
 		if (!coreComponent->timer->start().wasSuccessful())
 			return std::runtime_error("Unable to start timer!");
 		applicationIsPaused = false;
 
+		// record or replay the events
+		util::Expected<void> result = readCommandLine();
+		if (!result.isValid())
+			return result;
+
 		// log and return success
 		applicationStarted = true;
 		util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("The DirectX application initialization was successful.");
 		return {};
 	}
+	util::Expected<void> DirectXApp::readCommandLine()
+	{
+		int nArguments = 0;
+		LPWSTR* arguments = CommandLineToArgvW(GetCommandLineW(), &nArguments);
+		if (arguments == NULL)
+			return { };
+
+		util::Expected<void> result;
+		for (int i = 1; i < nArguments && result.isValid(); i++)
+		{
+			if (wcscmp(arguments[i], L"-hotreload") == 0)
+				hotReload = true;
+			else if (i + 1 >= nArguments)
+				break;
+			else if (wcscmp(arguments[i], L"-record") == 0)
+			{
+				result = eventRecorder.startRecording(arguments[++i]);
+				if (result.isValid())
+					util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("Recording the events.");
+			}
+			else if (wcscmp(arguments[i], L"-replay") == 0)
+			{
+				result = eventRecorder.startReplay(arguments[++i]);
+				if (result.isValid())
+					util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("Replaying the recorded events.");
+			}
+		}
+
+		LocalFree(arguments);
+		return result;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// Hot Reload ///////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	util::Expected<void> DirectXApp::startHotReload()
+	{
+		// the user preferences are parsed by the watcher thread, the observers of the changed parts are notified between two frames
+		const std::wstring prefsFile = fileSystemComponent->getPathToConfigurationFiles() + L"\\" + fileSystemComponent->getPrefsFile();
+		fileWatcher.watchFile(prefsFile, [this](const std::wstring& file, util::FileWatcher::ApplyFunction& apply) -> util::Expected<void>
+		{
+			fileSystem::Configuration configuration;
+			util::Expected<void> result = fileSystem::readConfigurationFile(file, configuration);
+			if (!result.isValid())
+				return result;
+
+			apply = [this, configuration]() { return applyReloadedConfiguration(configuration); };
+			return { };
+		});
+
+		// the key bindings are deserialized directly into the key maps of the input handler, thus they are loaded between two frames
+		if (inputComponent)
+		{
+			const std::wstring* keyBindingFiles[] = { &fileSystemComponent->getKeyboardFile(), &fileSystemComponent->getJoystickFile(), &fileSystemComponent->getGamepadFile() };
+			for (const std::wstring* keyBindingFile : keyBindingFiles)
+				fileWatcher.watchFile(*keyBindingFile, [this](const std::wstring& /*file*/, util::FileWatcher::ApplyFunction& apply) -> util::Expected<void>
+				{
+					apply = [this]() { return inputComponent->getInputHandler().loadGameCommands(); };
+					return { };
+				});
+		}
+
+		util::Expected<void> result = fileWatcher.start();
+		if (!result.isValid())
+			return result;
+
+		if (fileWatcher.usesNativeNotifications())
+			LOG_INFO(FileSystemLog, "Watching the configuration files for changes.");
+		else
+			LOG_INFO(FileSystemLog, "Polling the configuration files for changes.");
+
+		// return success
+		return { };
+	}
+
+	util::Expected<void> DirectXApp::applyReloadedConfiguration(const fileSystem::Configuration& configuration)
+	{
+		// the file already holds the new configuration
+		util::Expected<void> result = fileSystemComponent->getConfigService().apply(configuration, false);
+		if (!result.isValid())
+			return result;
+
+		// the observers of the configuration apply what they can, i.e. an unsupported resolution or a missing game controller is ignored
+		if (graphicsComponent)
+		{
+			if (graphicsComponent->getCurrentWidth() != configuration.width || graphicsComponent->getCurrentHeight() != configuration.height)
+				LOG_WARNING(FileSystemLog, "The reloaded resolution could not be applied: %u x %u.", configuration.width, configuration.height);
+			if (graphicsComponent->getFullscreenState() != configuration.fullscreen)
+				LOG_WARNING(FileSystemLog, "The reloaded fullscreen mode could not be applied: %s.", configuration.fullscreen ? "true" : "false");
+		}
+
+		if (inputComponent)
+		{
+			const input::InputHandler& inputHandler = inputComponent->getInputHandler();
+			if (inputHandler.activeJoystick != configuration.enableJoystick)
+				LOG_WARNING(FileSystemLog, "The reloaded joystick state could not be applied: %s.", configuration.enableJoystick ? "true" : "false");
+			if (inputHandler.activeGamepad != configuration.enableGamepad)
+				LOG_WARNING(FileSystemLog, "The reloaded gamepad state could not be applied: %s.", configuration.enableGamepad ? "true" : "false");
+		}
+
+		// return success
+		return { };
+	}
+
 	void DirectXApp::shutdown(const util::Expected<void>* /*expected*/)
 	{
+		// stop watching the configuration files before the components are deleted
+		fileWatcher.stop();
+
+		// stop the file workers before the components that receive their messages are deleted
+		if (fileIOService)
+			delete fileIOService;
+		fileIOService = nullptr;
+
 		while (!gameStates.empty())
 			gameStates.pop_back();
 
@@ -101,6 +252,13 @@ namespace core
 		if (coreComponent)
 			delete coreComponent;
 
+		// write the remaining recorded events
+		eventRecorder.stop();
+
+		// the message statistics are written to the log folder
+		if (fileSystemComponent)
+			dumpMessageStatistics();
+
 		if (fileSystemComponent->activeFileLogger)
 		{
 			util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("The DirectX application was shutdown successfully.");
@@ -113,9 +271,8 @@ namespace core
 	/////////////////////////////////////////////////////////////////////////////////////////
 	util::Expected<int> DirectXApp::run()
 	{
-#ifndef NDEBUG
-		util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("Entering the game loop...");
-#endif
+		LOG_DEBUG(CoreLog, "Entering the game loop...");
+
 		// error handling
 		util::Expected<void> voidResult;
 		util::Expected<int> intResult(0);
@@ -125,6 +282,14 @@ namespace core
 		if (!voidResult.isValid())
 			throw voidResult;
 		
+		// reload the configuration files when they change
+		if (hotReload)
+		{
+			voidResult = startHotReload();
+			if (!voidResult.isValid())
+				throw voidResult;
+		}
+
 		double accumulatedTime = 0.0;		// stores the time accumulated by the renderer
 		int nLoops = 0;						// the number of completed loops while updating the game
 
@@ -158,18 +323,43 @@ namespace core
 				if (!voidResult.isValid())
 					throw voidResult;
 
+				// the time of this frame; while replaying, the recorded time is used, such that the game is updated exactly as during the recording
+				double frameTime = coreComponent->timer->getDeltaTime();
+				eventRecorder.beginFrame(frameTime);
+
+				// let the particle budget adapt to the current frame time
+				physics::particles::ParticleBudget::getInstance().reportFrameTime(frameTime * 1000.0);
+
+				// advance the time of the particle environment, i.e. the turbulence
+				physics::particles::Environment::getInstance().update(frameTime);
+
+				// apply the configuration files that changed on the disk; a broken file is reported, but the game continues
+				util::Expected<void> reloadResult = fileWatcher.applyChanges();
+				if (!reloadResult.isValid())
+				{
+					try { reloadResult.get(); }
+					catch (std::exception& e) { LOG_WARNING(FileSystemLog, "Unable to reload a configuration file: %s", e.what()); }
+				}
+
 				// acquire input
 				voidResult = acquireInput();
 				if (!voidResult.isValid())
 					throw voidResult;
 
+				// add the timed messages that are due to the queue
+				gameTime += frameTime;
+				messageScheduler.advance(gameTime, [this](Depesche& depesche) { addMessage(depesche); });
+
 				// dispatch message
 				voidResult = dispatchMessages();
 				if (!voidResult.isValid())
 					throw voidResult;
+
+				// the results of the asynchronous reads were taken by the receivers of the messages
+				fileIOService->nextFrame();
 				
 				// accumulate the elapsed time since the last frame
-				accumulatedTime += coreComponent->timer->getDeltaTime();
+				accumulatedTime += frameTime;
 
 				// now update the game logic with fixed dt as often as possible
 				nLoops = 0;
@@ -187,12 +377,20 @@ namespace core
 				intResult = render(accumulatedTime / dt);
 				if (!intResult.isValid())
 					return intResult;
+
+				// quit once all recorded events were replayed
+				if (eventRecorder.replayHasEnded())
+				{
+					std::stringstream message;
+					message << "The replay has ended; " << eventRecorder.getNumberOfDivergences() << " messages diverged from the recording.";
+					util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>(message.str());
+					eventRecorder.stop();
+					quitGame();
+				}
 			}
 		}
 
-#ifndef NDEBUG
-		util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("Leaving the game loop...");
-#endif
+		LOG_DEBUG(CoreLog, "Leaving the game loop...");
 		return (int)msg.wParam;
 	}
 
@@ -229,6 +427,7 @@ namespace core
 			return result;
 
 		stateStackChanged = true;
+		subscribersChanged = true;
 
 		// return success
 		return { };
@@ -245,6 +444,7 @@ namespace core
 			return result;
 
 		stateStackChanged = true;
+		subscribersChanged = true;
 
 		// return success
 		return { };
@@ -269,6 +469,7 @@ namespace core
 			return result;
 
 		stateStackChanged = true;
+		subscribersChanged = true;
 		
 		// return success
 		return { };
@@ -296,6 +497,7 @@ namespace core
 		}
 
 		stateStackChanged = true;
+		subscribersChanged = true;
 
 		// return success
 		return { };
@@ -439,6 +641,10 @@ namespace core
 	{
 		return *fileSystemComponent;
 	}
+	fileSystem::FileIOService& DirectXApp::getFileIOService() const
+	{
+		return *fileIOService;
+	}
 	graphics::GraphicsComponent& DirectXApp::getGraphicsComponent() const
 	{
 		return *graphicsComponent;
@@ -472,26 +678,141 @@ namespace core
 		// error handling
 		util::Expected<void> result;
 
-		while (!eventQueue.isEmpty())
+		// messages sent from now on allocate their payloads from the other half of the arena
+		messageArena.nextFrame();
+
+		// the subscriber lists only change with the state stack
+		if (subscribersChanged)
+			rebuildSubscribers();
+
+		// hand all messages to their receivers, stop at the first error
+		size_t nMessages = eventQueue.drain([this, &result](const Depesche& depesche)
 		{
-			// get the front message
-			Depesche depesche = eventQueue.dequeue();
+#if DEPESCHE_STATISTICS
+			const int64_t dispatchTime = DepescheStatistics::now();
+#endif
+			// record the message, or compare it to the recording
+			eventRecorder.recordMessage(depesche);
 
 			// check whether the receiver actually exists
 			DepescheDestination* destination = depesche.destination;
 			if (destination)
 				// the destination is valid
 				result = destination->onMessage(depesche);
+			else
+			{
+				// a previous message might have changed the state stack
+				if (subscribersChanged)
+					rebuildSubscribers();
 
-			if (!result.isValid())
-				return result;
-		}
+				// multicast: deliver the message to each subscriber
+				for (DepescheDestination* subscriber : subscribers[depesche.type])
+				{
+					result = subscriber->onMessage(depesche);
+					if (!result.isValid())
+						break;
+				}
+			}
+
+#if DEPESCHE_STATISTICS
+			messageStatistics->messageDispatched(depesche.type, dispatchTime - depesche.timeStamp, DepescheStatistics::now() - dispatchTime);
+#endif
+			// the message was handled, its payload may be overwritten once the arena switches buffers
+			if (depesche.hasArenaPayload())
+				messageArena.release(depesche.getPayloadData());
+
+			return result.isValid();
+		});
+
+#if DEPESCHE_STATISTICS
+		messageStatistics->frameDispatched(nMessages);
+#else
+		(void)nMessages;
+#endif
+
+		if (!result.isValid())
+			return result;
 
 		return { };
 	}
 
 	void DirectXApp::addMessage(Depesche& depesche)
 	{
-		eventQueue.enqueue(depesche);
+#if DEPESCHE_STATISTICS
+		depesche.timeStamp = DepescheStatistics::now();
+#endif
+
+		// the queue is bounded: if the main thread does not keep up, the message is dropped
+		if (!eventQueue.tryPush(depesche))
+		{
+			if (depesche.hasArenaPayload())
+				messageArena.release(depesche.getPayloadData());
+			dropMessage(depesche.type);
+		}
+#if DEPESCHE_STATISTICS
+		else
+			messageStatistics->messageAdded(depesche.type, eventQueue.size());
+#endif
+	}
+
+	uint64_t DirectXApp::scheduleDepesche(const Depesche& depesche, const double delay)
+	{
+		return messageScheduler.scheduleAt(depesche, gameTime + delay);
+	}
+
+	void DirectXApp::subscribe(const DepescheTypes type, DepescheDestination& destination)
+	{
+		permanentSubscribers.push_back(std::make_pair(type, &destination));
+		subscribersChanged = true;
+	}
+
+	void DirectXApp::unsubscribe(const DepescheTypes type, DepescheDestination& destination)
+	{
+		permanentSubscribers.erase(std::remove(permanentSubscribers.begin(), permanentSubscribers.end(), std::make_pair(type, &destination)), permanentSubscribers.end());
+		subscribersChanged = true;
+	}
+
+	void DirectXApp::rebuildSubscribers()
+	{
+		for (auto& list : subscribers)
+			list.clear();
+
+		// the active states, top to bottom
+		for (std::deque<GameState*>::reverse_iterator it = gameStates.rbegin(); it != gameStates.rend(); it++)
+			if (!(*it)->isPaused)
+				for (unsigned int type = 0; type < nDepescheTypes; type++)
+					if ((*it)->isSubscribedTo((DepescheTypes)type))
+						subscribers[type].push_back(*it);
+
+		// the permanent subscribers
+		for (auto& subscription : permanentSubscribers)
+			subscribers[subscription.first].push_back(subscription.second);
+
+		subscribersChanged = false;
+	}
+
+	void DirectXApp::dropMessage(const DepescheTypes type) const
+	{
+		std::stringstream warning;
+		warning << "The event queue or the message arena is full! A message of type " << (int)type << " was dropped.";
+		util::ServiceLocator::getFileLogger()->print<util::SeverityType::warning>(warning.str());
+
+#if DEPESCHE_STATISTICS
+		messageStatistics->messageDropped(type);
+#endif
+	}
+
+	util::Expected<void> DirectXApp::dumpMessageStatistics() const
+	{
+#if DEPESCHE_STATISTICS
+		std::ofstream out(fileSystemComponent->pathToLogFiles + L"\\bell0messages.json", std::ios::out | std::ios::trunc);
+		if (!out.good())
+			return std::runtime_error("Unable to write the message statistics!");
+
+		messageStatistics->writeJSON(out);
+		if (!out.good())
+			return std::runtime_error("Unable to write the message statistics!");
+#endif
+		return { };
 	}
 }
\ No newline at end of file
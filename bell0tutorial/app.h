@@ -10,22 +10,41 @@
 *			- 03/06/18: now observes events from the Window and Direct3D classes
 *			- 21/06/18: changed the state stack to allow overlays
 *			- 27/06/18: sliced the app class into several components
+*			- 03/09/19: the event queue is a lock-free ring buffer
+*			- 04/09/19: typed messages, large payloads are stored in a per-frame arena
+*			- 05/09/19: multicast messages to all subscribers of a message type
+*			- 06/09/19: messages can be scheduled for later delivery
+*			- 07/09/19: statistics of the event queue
+*			- 09/09/19: frames, input and messages can be recorded and replayed
+*			- 15/09/19: configuration files are reloaded when they change on the disk
+*			- 17/09/19: data files can be read asynchronously
+*			- 20/09/19: arena payloads are released once their messages were dispatched or dropped
+*			- 20/09/19: reloaded preferences are applied by the observers of the configuration, settings that could not be applied are reported
+*			- 20/09/19: the timed messages are driven by the time of the frames, thus they are delivered on the same frames while replaying
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
 
 // c++ containers
 #include <deque>			// deque for the stack of game states
+#include <vector>			// vector for the subscribers of each message type
+
+// c++ includes
+#include <memory>			// unique pointer to the message statistics
 
 // Windows includes
 #include <Windows.h>		// Windows definitions
 
 // bell0bytes utilities
 #include "observer.h"		// the observer pattern
-#include "safeQueue.h"		// a thread-safe queue
+#include "mpscQueue.h"		// a lock-free multi-producer single-consumer queue
+#include "fileWatcher.h"	// reloads changed files
 
 // bell0bytes core
 #include "depesche.h"		// event queue data
+#include "timingWheel.h"	// timed messages
+#include "depescheStatistics.h"	// statistics of the event queue
+#include "eventRecorder.h"	// recording and replaying events
 
 
 // CLASSES //////////////////////////////////////////////////////////////////////////////
@@ -44,6 +63,8 @@ namespace graphics
 namespace fileSystem
 {
 	class FileSystemComponent;
+	class FileIOService;
+	struct Configuration;
 }
 
 namespace audio
@@ -69,7 +90,34 @@ namespace core
 	{
 	private:
 		// the main message queue
-		util::ThreadSafeQueue<Depesche> eventQueue;	// thread-safe message queue
+		util::MPSCQueue<Depesche> eventQueue;		// lock-free message queue; any thread may add messages, only the main thread dispatches them
+		DepescheArena messageArena;					// memory for message payloads that are too large to be stored inline
+
+		// multicast
+		std::vector<DepescheDestination*> subscribers[nDepescheTypes];			// the receivers of each message type: the active states, top to bottom, then the permanent subscribers
+		std::vector<std::pair<DepescheTypes, DepescheDestination*> > permanentSubscribers;	// subscribers that do not depend on the state stack, i.e. components
+		bool subscribersChanged;					// true iff the subscriber lists must be rebuilt
+		void rebuildSubscribers();					// rebuilds the subscriber lists from the state stack and the permanent subscribers
+
+		// timed messages
+		TimingWheel messageScheduler;				// the messages to be delivered at a later time, driven by the game time
+		double gameTime;							// the sum of the times of all frames that were not paused; while replaying, the sum of the recorded frame times
+		uint64_t scheduleDepesche(const Depesche& depesche, const double delay);	// returns the handle of the scheduled message
+
+		// recording and replaying
+		EventRecorder eventRecorder;				// records or replays the frame times, the input and the messages
+		util::Expected<void> readCommandLine();		// starts recording or replaying if requested on the command line: -record <file> or -replay <file>
+
+		// hot reload
+		util::FileWatcher fileWatcher;				// reloads the configuration files when they change on the disk
+		bool hotReload;								// true iff the configuration files are watched; default: debug builds only, enabled by -hotreload
+		util::Expected<void> startHotReload();		// watches the user preferences and the key bindings
+		util::Expected<void> applyReloadedConfiguration(const fileSystem::Configuration& configuration);	// logs a warning for each setting that could not be applied
+
+#if DEPESCHE_STATISTICS
+		// statistics of the event queue
+		std::unique_ptr<DepescheStatistics> messageStatistics;
+#endif
 		
 		// game update variables
 		const double dt;						// constant game update rate for better physics simulation (less rounding errors in mathematical computations)
@@ -92,6 +140,7 @@ namespace core
 		
 		// dispatch the messages in the event queue
 		util::Expected<void> dispatchMessages();
+		void dropMessage(const DepescheTypes type) const;	// logs that a message could not be sent
 
 		// pause and resume the application
 		util::Expected<void> pauseApplication();
@@ -104,6 +153,7 @@ namespace core
 		// components
 		CoreComponent* coreComponent;							// core components: timer, window...
 		fileSystem::FileSystemComponent* fileSystemComponent;	// file system components
+		fileSystem::FileIOService* fileIOService;				// asynchronous file reads
 		graphics::GraphicsComponent* graphicsComponent;			// 2D and 3D graphics
 		input::InputComponent* inputComponent;					// input components
 		audio::AudioComponent* audioComponent;					// AudioEngine audio component
@@ -141,6 +191,65 @@ namespace core
 		// event queue
 		void addMessage(Depesche&);		// add a message to the queue
 
+		// add a message with a payload to the queue, the type of the payload is determined by the type of the message
+		template<DepescheTypes type>
+		void addMessage(DepescheSender& sender, DepescheDestination& destination, const typename DepeschePayload<type>::Type& payload = typename DepeschePayload<type>::Type())
+		{
+			Depesche depesche(sender, destination, type);
+			if (depesche.setPayload<type>(payload, messageArena))
+				addMessage(depesche);
+			else
+				dropMessage(type);
+		}
+
+		// publish a message to all subscribers of its type
+		template<DepescheTypes type>
+		void publishMessage(DepescheSender& sender, const typename DepeschePayload<type>::Type& payload = typename DepeschePayload<type>::Type())
+		{
+			Depesche depesche(sender, type);
+			if (depesche.setPayload<type>(payload, messageArena))
+				addMessage(depesche);
+			else
+				dropMessage(type);
+		}
+
+		// schedule a message to be added to the queue after the given delay in seconds of game time (main thread only)
+		// the payload must be stored inline, as the arena only holds payloads for a frame; returns a handle to cancel the message
+		template<DepescheTypes type>
+		uint64_t scheduleMessage(const double delay, DepescheSender& sender, DepescheDestination& destination, const typename DepeschePayload<type>::Type& payload = typename DepeschePayload<type>::Type())
+		{
+			typedef typename DepeschePayload<type>::Type Payload;
+			static_assert(sizeof(Payload) <= Depesche::inlineSize && alignof(Payload) <= 8, "Only messages with inline payloads can be scheduled!");
+
+			Depesche depesche(sender, destination, type);
+			depesche.setPayload<type>(payload, messageArena);
+			return scheduleDepesche(depesche, delay);
+		}
+
+		// schedule a message to be published to all subscribers of its type after the given delay in seconds of game time (main thread only)
+		template<DepescheTypes type>
+		uint64_t schedulePublishMessage(const double delay, DepescheSender& sender, const typename DepeschePayload<type>::Type& payload = typename DepeschePayload<type>::Type())
+		{
+			typedef typename DepeschePayload<type>::Type Payload;
+			static_assert(sizeof(Payload) <= Depesche::inlineSize && alignof(Payload) <= 8, "Only messages with inline payloads can be scheduled!");
+
+			Depesche depesche(sender, type);
+			depesche.setPayload<type>(payload, messageArena);
+			return scheduleDepesche(depesche, delay);
+		}
+
+		bool cancelScheduledMessage(const uint64_t handle) { return messageScheduler.cancel(handle); };	// returns false if the message was already delivered or cancelled
+
+		// the event recorder, i.e. for the input handler to record or replay the input
+		EventRecorder& getEventRecorder() { return eventRecorder; };
+
+		// writes the statistics of the event queue to bell0messages.json in the log folder; does nothing if the statistics are compiled out
+		util::Expected<void> dumpMessageStatistics() const;
+
+		// permanent subscriptions (main thread only)
+		void subscribe(const DepescheTypes type, DepescheDestination& destination);
+		void unsubscribe(const DepescheTypes type, DepescheDestination& destination);
+
 		// manage the game states
 		util::Expected<void> changeGameState(GameState* const gameState);	// change game state (deletes all previous states)
 		util::Expected<void> overlayGameState(GameState* const gameState);	// add new game state on top of the existing one; do not pause anything
@@ -164,6 +273,7 @@ namespace core
 		// get the components
 		graphics::GraphicsComponent& getGraphicsComponent() const;
 		fileSystem::FileSystemComponent& getFileSystemComponent() const;
+		fileSystem::FileIOService& getFileIOService() const;
 		input::InputComponent& getInputComponent() const;
 		CoreComponent& getCoreComponent() const;
 		audio::AudioComponent& getAudioComponent() const;
@@ -0,0 +1,52 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		18/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		interned assets: a data file, given by its data folder and its name, is resolved once to a 32-bit id
+*			the file system component caches the path of the file and where it is found (loose file or pack archive),
+*			thus the loaders that accept ids neither build strings nor search for the file again
+*			the ids are valid for the lifetime of the file system component
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <string>
+#include <cstdint>
+
+// folder data
+#include "folders.h"
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace fileSystem
+{
+	namespace pack
+	{
+		struct Entry;
+	}
+
+	// the id of an interned asset, zero is not a valid id
+	struct AssetId
+	{
+		uint32_t value = 0;
+
+		bool isValid() const { return value != 0; };
+		bool operator==(const AssetId& id) const { return value == id.value; };
+		bool operator!=(const AssetId& id) const { return value != id.value; };
+	};
+
+	// what is known about an asset once it was resolved
+	struct Asset
+	{
+		DataFolders folder;
+		std::wstring name;
+		std::wstring path;							// the path to the file, as returned by openFile
+		bool loose = false;							// true iff there is a loose file, which overrides the pack archive
+		const pack::Entry* packedEntry = nullptr;	// the entry in the pack archive, null if the file is not packed
+		uint64_t size = 0;							// the size of the file in bytes
+	};
+}
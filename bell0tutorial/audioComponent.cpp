@@ -12,17 +12,7 @@
 
 // bell0bytes util
 #include "serviceLocator.h"
-#include "stringConverter.h"
-
-// Lua and Sol
-
-// warning supression no longer needed with C++-17
-//#pragma warning( push )
-//#pragma warning( disable : 4127)	// disable constant if expr warning
-//#pragma warning( disable : 4702)	// disable unreachable code warning
-#include <sol.hpp>
-//#pragma warning( pop ) 
-#pragma comment(lib, "liblua53.a")
+#include "logFilter.h"
 
 namespace audio
 {
@@ -31,7 +21,7 @@ namespace audio
 	/////////////////////////////////////////////////////////////////////////////////////////
 	AudioComponent::AudioComponent(const core::DirectXApp& dxApp) : dxApp(dxApp), streamingThread(nullptr)
 	{
-		try { engine = new AudioEngine(); }
+		try { engine = new AudioEngine(dxApp.getFileSystemComponent()); }
 		catch (std::runtime_error& e) { throw e; }
 
 		// create the submix voices
@@ -54,10 +44,15 @@ namespace audio
 			throw std::runtime_error("Failed to load volume level!");
 		soundsSubmix->SetVolume(soundEffectsVolume);
 		musicSubmix->SetVolume(musicVolume);
+
+		// listen to changes of the volume
+		dxApp.getFileSystemComponent().getConfigService().addObserver(this, util::Subject::eventBit(fileSystem::ConfigurationParts::AudioConfiguration));
 	}
 
 	AudioComponent::~AudioComponent()
 	{
+		dxApp.getFileSystemComponent().getConfigService().removeObserver(this);
+
 		endStream();
 
 		ZeroMemory(&soundsSendList, sizeof(soundsSendList));
@@ -111,7 +106,6 @@ namespace audio
 	{
 		// handle errors
 		util::Expected<void> result;
-		HRESULT hr = S_OK;
 
 		// load file into wave
 		WAVEFORMATEX* waveFormatEx;
@@ -120,6 +114,42 @@ namespace audio
 			return result;
 		soundEvent.waveFormat = *waveFormatEx;
 		
+		return createSourceVoice(soundEvent, soundType);
+	}
+	util::Expected<void> AudioComponent::loadFile(const fileSystem::FileData& soundData, const std::wstring& fileName, SoundEvent& soundEvent, const AudioTypes& soundType)
+	{
+		// handle errors
+		util::Expected<void> result;
+
+		// decode the file into wave
+		WAVEFORMATEX* waveFormatEx;
+		result = engine->loadFile(soundData, fileName, soundEvent.audioData, &waveFormatEx, soundEvent.waveLength);
+		if (!result.isValid())
+			return result;
+		soundEvent.waveFormat = *waveFormatEx;
+
+		return createSourceVoice(soundEvent, soundType);
+	}
+	util::Expected<void> AudioComponent::loadFile(const fileSystem::AssetId soundAsset, SoundEvent& soundEvent, const AudioTypes& soundType)
+	{
+		// the path was resolved when the asset was interned, the file is read directly from its location
+		const fileSystem::FileSystemComponent& fileSystemComponent = dxApp.getFileSystemComponent();
+		const fileSystem::Asset* asset = fileSystemComponent.getAsset(soundAsset);
+		if (asset == nullptr)
+			return std::runtime_error("Critical error: Unknown sound asset!");
+
+		fileSystem::FileData soundData;
+		util::Expected<void> result = fileSystemComponent.readFile(soundAsset, soundData);
+		if (!result.isValid())
+			return result;
+
+		return loadFile(soundData, asset->path, soundEvent, soundType);
+	}
+	util::Expected<void> AudioComponent::createSourceVoice(SoundEvent& soundEvent, const AudioTypes& soundType)
+	{
+		// handle errors
+		HRESULT hr = S_OK;
+
 		// create source voice
 		if(soundType == AudioTypes::Sound)
 			hr = engine->dev->CreateSourceVoice(&soundEvent.sourceVoice, &soundEvent.waveFormat, 0, XAUDIO2_DEFAULT_FREQ_RATIO, nullptr, &soundsSendList, NULL);
@@ -199,32 +229,33 @@ namespace audio
 			// handle errors
 			HRESULT hr = S_OK;
 
-			if (depesche.message == nullptr)
+			SoundEvent* const soundEvent = depesche.getPayload<core::DepescheTypes::PlaySoundEvent>();
+			if (soundEvent == nullptr)
 				return std::runtime_error("Critical error: depesche was empty!");
 
 			// submit the audio buffer to the source voice
-			hr = ((SoundEvent*)depesche.message)->sourceVoice->SubmitSourceBuffer(&((SoundEvent*)depesche.message)->audioBuffer);
+			hr = soundEvent->sourceVoice->SubmitSourceBuffer(&soundEvent->audioBuffer);
 			if (FAILED(hr))
 				return std::runtime_error("Critical error: Unable to submit source buffer!");
 
 			// start the source voice
-			((SoundEvent*)depesche.message)->sourceVoice->Start();
+			soundEvent->sourceVoice->Start();
 		}
 		else if (depesche.type == core::DepescheTypes::StopSoundEvent)
 		{
-			if (depesche.message == nullptr)
+			SoundEvent* const soundEvent = depesche.getPayload<core::DepescheTypes::StopSoundEvent>();
+			if (soundEvent == nullptr)
 				return std::runtime_error("Critical error: depesche was empty!");
 			
 			// simply stop the source voice
-			((SoundEvent*)depesche.message)->sourceVoice->Stop();
+			soundEvent->sourceVoice->Stop();
 		}
 		else if (depesche.type == core::DepescheTypes::BeginStream)
 		{
 			// begin streaming music
-			if (depesche.message == nullptr)
-				return std::runtime_error("Critical error: depesche was empty!");
+			const StreamEvent& streamEvent = depesche.getPayload<core::DepescheTypes::BeginStream>();
 
-			util::Expected<void> result = streamFile(((StreamEvent*)depesche.message)->filename, ((StreamEvent*)depesche.message)->type, ((StreamEvent*)depesche.message)->loop, ((StreamEvent*)depesche.message)->frequency);
+			util::Expected<void> result = streamFile(streamEvent.filename, streamEvent.type, streamEvent.loop, streamEvent.frequency);
 			if (!result.isValid())
 				return result;
 		}
@@ -265,30 +296,23 @@ namespace audio
 	// load volume from preference file
 	util::Expected<void> AudioComponent::loadVolume()
 	{
-		if (dxApp.getFileSystemComponent().hasValidConfigurationFile())
+		// the configuration file was read by the configuration service
+		const fileSystem::Configuration& configuration = dxApp.getFileSystemComponent().getConfigService().getConfiguration();
+		musicVolume = configuration.musicVolume;
+		soundEffectsVolume = configuration.soundEffectsVolume;
+		LOG_DEBUG(AudioLog, "The volume was read from the configuration: %g x %g.", musicVolume, soundEffectsVolume);
+
+		// return success
+		return { };
+	}
+
+	util::Expected<void> AudioComponent::onNotify(const int event)
+	{
+		if (event == fileSystem::ConfigurationParts::AudioConfiguration)
 		{
-			// configuration file exists, try to read from it
-			std::wstring pathToPrefFile = dxApp.getFileSystemComponent().getPathToConfigurationFiles() + L"\\bell0prefs.lua";
-
-			try
-			{
-				sol::state lua;
-				if (!lua.script_file(util::StringConverter::ws2s(pathToPrefFile)).valid())
-					return std::runtime_error("Unable to open lua script file!");
-
-				// read from the configuration file, default to 1920 x 1080
-				musicVolume = lua["config"]["musicVolume"].get_or(1.0f);
-				soundEffectsVolume = lua["config"]["soundEffectsVolume"].get_or(1.0f);
-#ifndef NDEBUG
-				std::stringstream res;
-				res << "The volume was read from the Lua configuration file: " << musicVolume << " x " << soundEffectsVolume << ".";
-				util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>(res.str());
-#endif
-			}
-			catch (std::exception)
-			{
-				util::ServiceLocator::getFileLogger()->print<util::SeverityType::warning>("Unable to read configuration file. Starting with default volume: 1.0f");
-			}
+			const fileSystem::Configuration& configuration = dxApp.getFileSystemComponent().getConfigService().getConfiguration();
+			setVolume(AudioTypes::Music, configuration.musicVolume);
+			setVolume(AudioTypes::Sound, configuration.soundEffectsVolume);
 		}
 
 		// return success
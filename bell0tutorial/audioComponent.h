@@ -6,7 +6,10 @@
 *
 * Desc:		audio component
 *
-* History:
+* History:	- 04/09/2019: typed message payloads
+*			- 13/09/2019: the volume is read from the configuration service, which notifies the component of changes
+*			- 18/09/2019: sounds can be loaded from interned assets
+*			- 20/09/2019: interned sounds are decoded from the file data, without resolving their path again
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
@@ -24,6 +27,7 @@
 // bell0bytes util
 #include "expected.h"
 #include "depesche.h"
+#include "observer.h"
 
 // DEFINITIONS //////////////////////////////////////////////////////////////////////////
 
@@ -33,6 +37,12 @@ namespace core
 	class DirectXApp;
 }
 
+namespace fileSystem
+{
+	struct AssetId;
+	class FileData;
+}
+
 namespace audio
 {
 	enum AudioTypes { Music, Sound };
@@ -59,22 +69,34 @@ namespace audio
 		friend class AudioComponent;
 	};
 
+	// the stream event is sent by value as the payload of a message, thus it must be trivially copyable
 	struct StreamEvent
 	{
-		std::wstring filename;
+		wchar_t filename[MAX_PATH] = { };
 		bool loop = false;
 		AudioTypes type = AudioTypes::Music;
 
 		float frequency = 1.0f;
 
-		StreamEvent() : filename(L""), loop(false), type(AudioTypes::Music) {};
-		StreamEvent(const std::wstring& filename, const bool loop, const AudioTypes type) : filename(filename), loop(loop), type(type) { };
-		~StreamEvent() {};
+		StreamEvent() {};
+		StreamEvent(const std::wstring& filename, const bool loop, const AudioTypes type) : loop(loop), type(type) { wcsncpy_s(this->filename, filename.c_str(), _TRUNCATE); };
 
 		friend class AudioComponent;
 	};
+}
+
+namespace core
+{
+	// the payloads of the audio messages
+	template<> struct DepeschePayload<DepescheTypes::PlaySoundEvent> { typedef audio::SoundEvent* Type; };	// the sound must stay loaded until the message was dispatched
+	template<> struct DepeschePayload<DepescheTypes::StopSoundEvent> { typedef audio::SoundEvent* Type; };
+	template<> struct DepeschePayload<DepescheTypes::BeginStream> { typedef audio::StreamEvent Type; };		// too large to be stored inline, thus stored in the message arena
+	template<> struct DepeschePayload<DepescheTypes::EndStream> { typedef EmptyPayload Type; };
+}
 
-	class AudioComponent : public core::DepescheDestination
+namespace audio
+{
+	class AudioComponent : public core::DepescheDestination, public util::Observer
 	{
 	private:
 		// address of the main DirectXApp
@@ -103,9 +125,15 @@ namespace audio
 		// handle message
 		util::Expected<void> onMessage(const core::Depesche& depesche);
 
-		// load volume from prev file
+		// load volume from the configuration
 		util::Expected<void> loadVolume();
 
+		// the audio configuration changed
+		util::Expected<void> onNotify(const int event) override;
+
+		// creates the source voice and the buffer of a loaded sound
+		util::Expected<void> createSourceVoice(SoundEvent& soundEvent, const AudioTypes& soundType);
+
 	public:
 		// constructor and destructor
 		AudioComponent(const core::DirectXApp& dxApp);
@@ -113,6 +141,8 @@ namespace audio
 
 		// load file from disk
 		util::Expected<void> loadFile(const std::wstring fileName, SoundEvent& soundEvent, const AudioTypes& soundType);
+		util::Expected<void> loadFile(const fileSystem::AssetId soundAsset, SoundEvent& soundEvent, const AudioTypes& soundType);
+		util::Expected<void> loadFile(const fileSystem::FileData& soundData, const std::wstring& fileName, SoundEvent& soundEvent, const AudioTypes& soundType);	// decodes a file that was already read; the file name helps to find the decoder
 		
 		// play sound
 		util::Expected<void> playSoundEvent(const SoundEvent& soundEvent);
@@ -48,6 +48,7 @@
 *			- 23/07/2019 - line segment collision detection
 *			- 24/07/2019 - particle system
 *			- 25/07/2019 - cleanup
+*			- 20/09/2019 - the image of the mouse cursor is read asynchronously
 *
 * ToDo:		- add physFS support
 *
@@ -61,6 +62,7 @@
 
 // bell0bytes filesystem
 #include "fileSystemComponent.h"
+#include "fileIOService.h"
 
 // bell0bytes graphics
 #include "graphicsComponent.h"					// graphics component of the DirectXApp class
@@ -98,11 +100,16 @@ public:
 };
 
 // the core game class, derived from DirectXApp
-class DirectXGame : core::DirectXApp
+class DirectXGame : core::DirectXApp, core::DepescheDestination
 {
 private:
-	// initialize mouse cursor sprite
-	util::Expected<void> createMouseCursor();
+	// initialize mouse cursor sprite, once its image was read by the file IO service
+	uint64_t mouseCursorRequest;									// the request to read the image of the mouse cursor, 0 if there is none
+	util::Expected<void> requestMouseCursor();
+	util::Expected<void> createMouseCursor(const fileSystem::FileData& cursorImage);
+
+	// messages
+	util::Expected<void> onMessage(const core::Depesche& depesche) override;
 
 public:
 	// constructor and destructor
@@ -194,7 +201,7 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE /*hPrevInstance*
 ////////////////////////////// Game Initialization //////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////
 // constructor and destructor
-DirectXGame::DirectXGame() : DirectXApp(), gameInput(nullptr)
+DirectXGame::DirectXGame() : DirectXApp(), mouseCursorRequest(0), gameInput(nullptr)
 { }
 
 // initialize the game
@@ -233,7 +240,7 @@ util::Expected<void> DirectXGame::initGraphics()
 	util::Expected<void> result;
 
 	// create mouse cursor sprite
-	result = createMouseCursor();
+	result = requestMouseCursor();
 	if (!result.isValid())
 		return result;
 
@@ -488,7 +495,20 @@ util::Expected<int> DirectXGame::render(const double farSeer)
 /////////////////////////////////////////////////////////////////////////////////////////
 ///////////////////////////////// Mouse Cursor //////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////
-util::Expected<void> DirectXGame::createMouseCursor()
+util::Expected<void> DirectXGame::requestMouseCursor()
+{
+	// the standard cursor is shown until the image was read
+	const fileSystem::AssetId cursorImage = fileSystemComponent->getAssetId(fileSystem::DataFolders::Cursors, L"cursorHand.png");
+	if (!cursorImage.isValid())
+		return std::runtime_error("Unable to find the image of the mouse cursor!");
+
+	mouseCursorRequest = fileIOService->readFile(cursorImage, fileSystem::IOPriorities::CriticalIO, this);
+
+	// return success
+	return { };
+}
+
+util::Expected<void> DirectXGame::createMouseCursor(const fileSystem::FileData& cursorImage)
 {
 	// error handling
 	util::Expected<void> result;
@@ -522,7 +542,7 @@ util::Expected<void> DirectXGame::createMouseCursor()
 	cursorAnimationsCycles.push_back(cycle);
 
 	// create cursor animations
-	if (!graphicsComponent->createNewAnimationData(cursorAnimationsCycles, fileSystemComponent->openFile(fileSystem::DataFolders::Cursors, L"cursorHand.png"), &cursorAnimations).isValid())
+	if (!graphicsComponent->createNewAnimationData(cursorAnimationsCycles, cursorImage, &cursorAnimations).isValid())
 		return std::runtime_error("Unable to create animation data for the mouse cursor!");
 
 	// create cursor sprite
@@ -538,3 +558,25 @@ util::Expected<void> DirectXGame::createMouseCursor()
 	// return success
 	return { };
 }
+
+/////////////////////////////////////////////////////////////////////////////////////////
+///////////////////////////////// Messages //////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////////////////
+util::Expected<void> DirectXGame::onMessage(const core::Depesche& depesche)
+{
+	if (depesche.type != core::DepescheTypes::FileLoaded)
+		return { };
+
+	// the image of the mouse cursor
+	const fileSystem::FileLoadedPayload& payload = depesche.getPayload<core::DepescheTypes::FileLoaded>();
+	if (mouseCursorRequest == 0 || payload.request != mouseCursorRequest)
+		return { };
+	mouseCursorRequest = 0;
+
+	fileSystem::FileData cursorImage;
+	util::Expected<void> result = fileIOService->takeResult(payload.request, cursorImage);
+	if (!result.isValid())
+		return result;
+
+	return createMouseCursor(cursorImage);
+}
@@ -12,6 +12,10 @@
 #include <array>
 #include "inputComponent.h"
 #include "inputHandler.h"
+#include "serviceLocator.h"
+#include "psExplosion.h"
+#include "particleBudget.h"
+#include <algorithm>
 
 
 
@@ -25,7 +29,7 @@ namespace game
 	/////////////////////////////////////////////////////////////////////////////////////////
 	////////////////////////////////// Constructor //////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
-	GameBoard::GameBoard(core::DirectXApp& dxApp) : dxApp(dxApp)
+	GameBoard::GameBoard(core::DirectXApp& dxApp) : dxApp(dxApp), paddleX(hudWidth + 0.5f * N * blockWidth)
 	{
 		// initialize the bucket
 		
@@ -49,20 +53,53 @@ namespace game
 		// stop menu music
 
 		// delete highscore table
+
+		// the explosions return their particles to the budget
+		explosions.clear();
 	}
 
 	void GameBoard::initializeGame()
 	{
+		// empty the bucket
+		for (unsigned int i = 0; i < N; i++)
+			for (unsigned int j = 0; j < M; j++)
+				board[i][j] = PositionStatus::PositionFree;
+
+		// center the paddle
+		paddleX = hudWidth + 0.5f * N * blockWidth;
+		paddleDirection = 0;
+		explosions.clear();
+
+		// load the first level
+		loadLevel();
+
 		// initialize the random number generator
 
 		// initialize score structure
+		currentScore = Score();
 	
 		// initialize highscore table
+		if (!highscoreTable.load(dxApp.getFileSystemComponent().getHighscoreFile()).isValid())
+			util::ServiceLocator::getFileLogger()->print<util::SeverityType::warning>("Non-existent or invalid highscore file. Starting with an empty highscore table.");
 	}
 
 	void GameBoard::loadLevel(const unsigned int level)
 	{
 
+		// the geometry of the level is static, build the collision grid once
+		buildCollisionGrid();
+	}
+
+	void GameBoard::buildCollisionGrid()
+	{
+		collisionGrid = physics::CollisionGrid((float)hudWidth, (float)heightOffset, (float)blockWidth, (float)blockHeight, N, M);
+
+		for (unsigned int i = 0; i < N; i++)
+			for (unsigned int j = 0; j < M; j++)
+				collisionGrid.setSolid(i, j, board[i][j] == PositionStatus::PositionFilled);
+
+		// the paddle is not part of the grid, it is updated whenever it moves
+		collisionGrid.setPaddle(getPaddleRectangle());
 	}
 
 	util::Expected<void> GameBoard::initializeBrushes()
@@ -108,6 +145,18 @@ namespace game
 	/////////////////////////////////////////////////////////////////////////////////////////
 	void GameBoard::update(const double deltaTime)
 	{
+		// move the paddle
+		updatePaddle(deltaTime);
+
+		// update the explosions, the ones without particles left are removed
+		for (auto it = explosions.begin(); it != explosions.end();)
+		{
+			if ((*it)->update(deltaTime))
+				it++;
+			else
+				it = explosions.erase(it);
+		}
+
 		// update animation status
 		
 		// check for new level
@@ -125,17 +174,72 @@ namespace game
 	/////////////////////////////////////////////////////////////////////////////////////////
 	void GameBoard::moveLeft()
 	{
-
+		paddleDirection = -1;
 	}
 
 	void GameBoard::moveRight()
 	{
+		paddleDirection = 1;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////// Paddle ///////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void GameBoard::updatePaddle(const double deltaTime)
+	{
+		// the paddle stays inside of the bucket
+		const float minX = hudWidth + 0.5f * paddleWidth;
+		const float maxX = hudWidth + (float)(N * blockWidth) - 0.5f * paddleWidth;
+		paddleX = std::min(maxX, std::max(minX, paddleX + (float)(paddleDirection * paddleSpeed * deltaTime)));
+		paddleDirection = 0;
+
+		// the particles bounce off the paddle
+		const mathematics::geometry::Rectangle2D paddle = getPaddleRectangle();
+		collisionGrid.setPaddle(paddle);
+
+		// the level of detail of the particles is measured from the paddle
+		physics::particles::ParticleBudget::getInstance().setFocus(mathematics::linearAlgebra::Vector2F(paddleX, 0.5f * (paddle.upperLeft.y + paddle.lowerRight.y)));
+	}
+
+	mathematics::geometry::Rectangle2D GameBoard::getPaddleRectangle() const
+	{
+		// the paddle floats just above the bottom of the bucket
+		const float bottom = (float)(heightOffset + M * blockHeight) - 10.0f;
+		return mathematics::geometry::Rectangle2D(mathematics::linearAlgebra::Vector2F(paddleX - 0.5f * paddleWidth, bottom - paddleHeight), mathematics::linearAlgebra::Vector2F(paddleX + 0.5f * paddleWidth, bottom));
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////////// Blocks ///////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void GameBoard::destroyBlock(const unsigned int column, const unsigned int row)
+	{
+		if (column >= N || row >= M || board[column][row] == PositionStatus::PositionFree)
+			return;
+
+		board[column][row] = PositionStatus::PositionFree;
+		collisionGrid.setSolid(column, row, false);
 
+		// the explosion asks the particle budget how many particles it may spawn
+		const mathematics::linearAlgebra::Vector2F center((float)getPixelX(column) + 0.5f * blockWidth, (float)getPixelY(row) + 0.5f * blockHeight);
+		explosions.push_back(std::make_unique<physics::particles::ExplosionPS>(dxApp, dxApp.getGraphicsComponent().get2DComponent(), center, mathematics::linearAlgebra::Vector2F(150.0f, 150.0f), physics::particles::EmitterPriority::Normal));
+
+		// the particles bounce off the walls, the remaining blocks and the paddle
+		explosions.back()->enableCollisions(collisionGrid);
 	}
 
 	/////////////////////////////////////////////////////////////////////////////////////////
 	////////////////////////////////// Render ///////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
+	const unsigned int GameBoard::getPixelX(const unsigned int position) const
+	{
+		return hudWidth + position * blockWidth;
+	}
+
+	const unsigned int GameBoard::getPixelY(const unsigned int position) const
+	{
+		return heightOffset + position * blockHeight;
+	}
+
 	void GameBoard::drawBoard(float opacity) const
 	{
 
@@ -147,5 +251,13 @@ namespace game
 
 		// left border
 		dxApp.getGraphicsComponent().get2DComponent().drawRectangle(hudWidth - 1, 0, hudWidth + 1, 1080);
+
+		// paddle
+		const mathematics::geometry::Rectangle2D paddle = getPaddleRectangle();
+		dxApp.getGraphicsComponent().get2DComponent().drawRectangle(paddle.upperLeft.x, paddle.upperLeft.y, paddle.lowerRight.x, paddle.lowerRight.y);
+
+		// explosions
+		for (const auto& explosion : explosions)
+			explosion->draw(0.0);
 	}
 }
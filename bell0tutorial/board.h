@@ -6,7 +6,10 @@
 *
 * Desc:		class to define the Arkanoid game world
 *
-* Hist:
+* Hist:		- 28/08/2019: the board builds a collision grid for particles once per level
+*			- 19/09/2019: the highscore table is loaded from a binary save file
+*			- 20/09/2019: the paddle is the focus of the particle budget, destroyed blocks explode
+*			- 20/09/2019: the explosions collide with the collision grid, which tracks the paddle
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
@@ -14,6 +17,8 @@
 // C++ includes
 #include <set>
 #include <array>
+#include <vector>
+#include <memory>
 
 // windows includes
 #include <wrl.h>
@@ -22,15 +27,13 @@
 #include "expected.h"
 #include "depesche.h"
 
-// DEFINITIONS //////////////////////////////////////////////////////////////////////////
-namespace boost
-{
-	namespace serialization
-	{
-		class access;
-	}
-}
+// bell0bytes physics
+#include "collisionGrid.h"
 
+// bell0bytes game
+#include "highscores.h"
+
+// DEFINITIONS //////////////////////////////////////////////////////////////////////////
 namespace core
 {
 	class DepescheSender;
@@ -43,11 +46,16 @@ namespace audio
 	struct StreamEvent;
 }
 
-namespace game
+namespace physics
 {
-	struct Score;
-	class HighscoreTable;
+	namespace particles
+	{
+		class ExplosionPS;
+	}
+}
 
+namespace game
+{
 	// different block types
 	// - normal: just a normal block that disappears when hit once
 	// - study: sturdy blocks have to be hit multiple times
@@ -96,15 +104,24 @@ namespace game
 		const unsigned int hudHeight = 1080;				// the height of each hud
 		const unsigned int heightOffset = 60;				// height offset
 
+		// the paddle
+		const float paddleWidth = 120.0f;					// the width of the paddle
+		const float paddleHeight = 20.0f;					// the height of the paddle
+		const float paddleSpeed = 600.0f;					// the speed of the paddle (in pixels per second)
+		float paddleX;										// the horizontal position of the center of the paddle
+		int paddleDirection = 0;							// -1 to move left, 1 to move right; set by the input of the current frame
+
 		// highscore table
-		//HighscoreTable* highscoreTable;					// stores the high scores
-		//Score* currentScore;								// keeps track of the score of the current player
+		HighscoreTable highscoreTable;						// stores the high scores
+		Score currentScore;									// keeps track of the score of the current player
 		
 		// game features
 
 		// enum to define whether a position is free or already filled
 		enum PositionStatus { PositionFree, PositionFilled };	// PositionFree: no tetronimo block here ; PositionFilled: a block of a tetronimo is occupying this space
 		PositionStatus board[N][M];								// the array to define the bucket
+		physics::CollisionGrid collisionGrid;					// static collision geometry of the current level, used by the particle systems
+		std::vector<std::unique_ptr<physics::particles::ExplosionPS> > explosions;	// the explosions of the destroyed blocks, limited by the particle budget
 
 		bool gameOver = false;								// true iff the game is over
 		bool levelChanged = false;							// true iff the level just changed
@@ -129,12 +146,17 @@ namespace game
 
 		// load level from file
 		void loadLevel(const unsigned int level = 0);	// read level file from hard drive
+		void buildCollisionGrid();						// rebuilds the collision grid from the board, called once per level
 	
 		// render
 		void drawBoard(float opacity) const;
 
 		// update score
 		void updateScore(const unsigned int nRows);
+
+		// paddle
+		void updatePaddle(const double deltaTime);		// moves the paddle and sets the focus of the particle budget
+		mathematics::geometry::Rectangle2D getPaddleRectangle() const;
 	
 	public:
 		GameBoard(core::DirectXApp& dxApp);
@@ -152,16 +174,20 @@ namespace game
 		void moveLeft();
 		void moveRight();
 
+		// blocks
+		void destroyBlock(const unsigned int column, const unsigned int row);	// removes the block and lets it explode
+
 		// render
 		const unsigned int getPixelX(const unsigned int position) const;
 		const unsigned int getPixelY(const unsigned int position) const;
 		void draw() const;		// draws the game board
 
-		// get score
-		//Score* const getCurrentScore() const { return currentScore; };
-		//const Score& getCurrentHighscore() const;
-		//HighscoreTable& getHighscoreTable() const;
+		// collisions
+		const physics::CollisionGrid& getCollisionGrid() const { return collisionGrid; };
 
-		friend class boost::serialization::access;
+		// get score
+		const Score& getCurrentScore() const { return currentScore; };
+		const Score* getCurrentHighscore() const { return highscoreTable.getHighscore(); };	// null if there are no highscores yet
+		const HighscoreTable& getHighscoreTable() const { return highscoreTable; };
 	};
 }
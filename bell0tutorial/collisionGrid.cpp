@@ -0,0 +1,104 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// C++ includes
+#include <cmath>
+#include <algorithm>
+
+// the header
+#include "collisionGrid.h"
+
+namespace physics
+{
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// CONSTRUCTORS ////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	CollisionGrid::CollisionGrid() : CollisionGrid(0.0f, 0.0f, 1.0f, 1.0f, 0, 0) {};
+
+	CollisionGrid::CollisionGrid(const float originX, const float originY, const float cellWidth, const float cellHeight, const unsigned int nColumns, const unsigned int nRows) : originX(originX), originY(originY), cellWidth(cellWidth), cellHeight(cellHeight), invCellWidth(1.0f / cellWidth), invCellHeight(1.0f / cellHeight), nColumns((int)nColumns), nRows((int)nRows), cells(nColumns * nRows, 0)
+	{ }
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// BUILD ///////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void CollisionGrid::clear()
+	{
+		std::fill(cells.begin(), cells.end(), (unsigned char)0);
+	}
+
+	void CollisionGrid::setSolid(const unsigned int column, const unsigned int row, const bool solid)
+	{
+		if ((int)column < nColumns && (int)row < nRows)
+			cells[row * nColumns + column] = solid ? 1 : 0;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// QUERIES /////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	bool CollisionGrid::isSolidCell(const int column, const int row) const
+	{
+		// the walls: everything outside of the grid is solid
+		if (column < 0 || row < 0 || column >= nColumns || row >= nRows)
+			return true;
+
+		return cells[row * nColumns + column] != 0;
+	}
+
+	bool CollisionGrid::isSolid(const float x, const float y) const
+	{
+		return isSolidCell((int)std::floor((x - originX) * invCellWidth), (int)std::floor((y - originY) * invCellHeight));
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// COLLISION ///////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	bool CollisionGrid::collide(mathematics::linearAlgebra::Vector2F& position, mathematics::linearAlgebra::Vector2F& velocity, const mathematics::linearAlgebra::Vector2F& previousPosition, const float restitution) const
+	{
+		// the axes along which the velocity is reflected
+		bool reflectX = false;
+		bool reflectY = false;
+
+		// the common case: a single lookup into the grid
+		int column = (int)std::floor((position.x - originX) * invCellWidth);
+		int row = (int)std::floor((position.y - originY) * invCellHeight);
+		if (isSolidCell(column, row))
+		{
+			// find the side of the cell that was crossed by checking which move alone would have entered a solid cell
+			int previousColumn = (int)std::floor((previousPosition.x - originX) * invCellWidth);
+			int previousRow = (int)std::floor((previousPosition.y - originY) * invCellHeight);
+
+			// points that were already inside a solid cell, i.e. spawned inside a block, are left alone
+			if (isSolidCell(previousColumn, previousRow))
+				return false;
+
+			reflectX = column != previousColumn && isSolidCell(column, previousRow);
+			reflectY = row != previousRow && isSolidCell(previousColumn, row);
+
+			// if neither move alone hits, the point hit the corner of the cell and bounces back along both axes
+			if (!reflectX && !reflectY)
+				reflectX = reflectY = true;
+		}
+		else if (hasPaddle && position.x >= paddle.upperLeft.x && position.x <= paddle.lowerRight.x && position.y >= paddle.upperLeft.y && position.y <= paddle.lowerRight.y)
+		{
+			// the paddle: coming from above or below reflects vertically, else horizontally
+			if (previousPosition.y < paddle.upperLeft.y || previousPosition.y > paddle.lowerRight.y)
+				reflectY = true;
+			else
+				reflectX = true;
+		}
+		else
+			// no collision
+			return false;
+
+		// reflect the velocity, each side that was hit negates the velocity along its axis, and lose energy
+		if (reflectX)
+			velocity.x = -velocity.x;
+		if (reflectY)
+			velocity.y = -velocity.y;
+		velocity *= restitution;
+
+		// move the point back out of the solid cell
+		position = previousPosition;
+
+		return true;
+	}
+}
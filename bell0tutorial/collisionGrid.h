@@ -0,0 +1,60 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		28/08/2019 - Lenningen - Luxembourg
+*
+* Desc:		a static uniform grid to collide large numbers of small objects, i.e. particles, with the game world
+*			the grid is built once per level, everything outside of the grid is considered to be a wall;
+*			the paddle moves, thus it is not part of the grid, but stored as a single rectangle
+*
+* History:
+*
+* ToDo:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// C++ includes
+#include <vector>
+
+// bell0bytes mathematics
+#include "vectors.h"
+#include "geometry.h"
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace physics
+{
+	class CollisionGrid
+	{
+	private:
+		float originX, originY;						// the upper left corner of the grid (in pixels)
+		float cellWidth, cellHeight;				// the size of each cell (in pixels)
+		float invCellWidth, invCellHeight;			// reciprocals of the cell size
+		int nColumns, nRows;						// the number of cells in each direction
+		std::vector<unsigned char> cells;			// true iff the cell is solid, stored row by row
+
+		bool hasPaddle = false;						// true iff a paddle was set
+		mathematics::geometry::Rectangle2D paddle;	// the paddle
+
+		// cell lookup
+		bool isSolidCell(const int column, const int row) const;		// cells outside of the grid are solid
+
+	public:
+		CollisionGrid();
+		CollisionGrid(const float originX, const float originY, const float cellWidth, const float cellHeight, const unsigned int nColumns, const unsigned int nRows);
+
+		// build the grid
+		void clear();													// marks all cells as free
+		void setSolid(const unsigned int column, const unsigned int row, const bool solid = true);
+		void setPaddle(const mathematics::geometry::Rectangle2D& rect) { paddle = rect; hasPaddle = true; };
+		void removePaddle() { hasPaddle = false; };
+
+		// queries
+		bool isSolid(const float x, const float y) const;				// returns true iff the point is inside a solid cell or outside of the grid
+
+		// collides a moving point with the grid, if there was a collision, the point is moved back to its previous position and the velocity is reflected and damped by the restitution
+		// returns true iff there was a collision
+		bool collide(mathematics::linearAlgebra::Vector2F& position, mathematics::linearAlgebra::Vector2F& velocity, const mathematics::linearAlgebra::Vector2F& previousPosition, const float restitution) const;
+	};
+}
@@ -0,0 +1,165 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// the header
+#include "compression.h"
+
+// c++ includes
+#include <cstring>
+
+namespace util
+{
+	namespace
+	{
+		const size_t minMatch = 4;				// shorter matches are stored as literals
+		const size_t maxOffset = 65535;			// the offsets are stored in two bytes
+		const unsigned int hashBits = 12;		// the size of the table of recent positions
+
+		inline uint32_t read32(const uint8_t* const p)
+		{
+			uint32_t value;
+			std::memcpy(&value, p, sizeof(value));
+			return value;
+		}
+
+		inline uint32_t hashPosition(const uint8_t* const p)
+		{
+			return (read32(p) * 2654435761u) >> (32 - hashBits);
+		}
+
+		// lengths of 15 and more are continued by bytes of 255
+		inline void writeLength(std::vector<uint8_t>& out, size_t length)
+		{
+			for (; length >= 255; length -= 255)
+				out.push_back(255);
+			out.push_back((uint8_t)length);
+		}
+
+		inline bool readLength(const uint8_t*& in, const uint8_t* const inEnd, size_t& length)
+		{
+			uint8_t byte;
+			do
+			{
+				if (in >= inEnd)
+					return false;
+				byte = *in++;
+				length += byte;
+			} while (byte == 255);
+			return true;
+		}
+
+		void writeSequence(std::vector<uint8_t>& out, const uint8_t* const literals, const size_t nLiterals, const size_t matchLength, const size_t offset)
+		{
+			const size_t literalNibble = nLiterals < 15 ? nLiterals : 15;
+			const size_t matchNibble = matchLength == 0 ? 0 : (matchLength - minMatch < 15 ? matchLength - minMatch : 15);
+			out.push_back((uint8_t)((literalNibble << 4) | matchNibble));
+			if (literalNibble == 15)
+				writeLength(out, nLiterals - 15);
+			out.insert(out.end(), literals, literals + nLiterals);
+
+			if (matchLength == 0)
+				return;
+
+			out.push_back((uint8_t)(offset & 0xFF));
+			out.push_back((uint8_t)(offset >> 8));
+			if (matchNibble == 15)
+				writeLength(out, matchLength - minMatch - 15);
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// Compression /////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	std::vector<uint8_t> compressBlock(const uint8_t* const input, const size_t inputSize)
+	{
+		std::vector<uint8_t> out;
+		out.reserve(inputSize / 2 + 16);
+
+		// the last position of each hashed sequence of four bytes
+		std::vector<uint32_t> table((size_t)1 << hashBits, 0);
+
+		const uint8_t* const end = input + inputSize;
+		const uint8_t* literals = input;
+		const uint8_t* p = input;
+
+		while (inputSize >= minMatch && p <= end - minMatch)
+		{
+			const uint32_t hash = hashPosition(p);
+			const uint8_t* candidate = input + table[hash];
+			table[hash] = (uint32_t)(p - input);
+
+			if (candidate >= p || (size_t)(p - candidate) > maxOffset || read32(candidate) != read32(p))
+			{
+				p++;
+				continue;
+			}
+
+			// extend the match
+			size_t matchLength = minMatch;
+			while (p + matchLength < end && candidate[matchLength] == p[matchLength])
+				matchLength++;
+
+			writeSequence(out, literals, (size_t)(p - literals), matchLength, (size_t)(p - candidate));
+			p += matchLength;
+			literals = p;
+		}
+
+		// the remaining bytes are literals
+		writeSequence(out, literals, (size_t)(end - literals), 0, 0);
+		return out;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// Decompression ///////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	bool decompressBlock(const uint8_t* const input, const size_t inputSize, uint8_t* const output, const size_t outputSize)
+	{
+		const uint8_t* in = input;
+		const uint8_t* const inEnd = input + inputSize;
+		uint8_t* out = output;
+		uint8_t* const outEnd = output + outputSize;
+
+		while (in < inEnd)
+		{
+			const uint8_t token = *in++;
+
+			// literals
+			size_t nLiterals = token >> 4;
+			if (nLiterals == 15 && !readLength(in, inEnd, nLiterals))
+				return false;
+			if (nLiterals > (size_t)(inEnd - in) || nLiterals > (size_t)(outEnd - out))
+				return false;
+			std::memcpy(out, in, nLiterals);
+			in += nLiterals;
+			out += nLiterals;
+
+			// the last sequence has no match
+			if (in == inEnd)
+				break;
+
+			// match
+			if (inEnd - in < 2)
+				return false;
+			const size_t offset = (size_t)in[0] | ((size_t)in[1] << 8);
+			in += 2;
+
+			size_t matchLength = token & 0x0F;
+			if (matchLength == 15 && !readLength(in, inEnd, matchLength))
+				return false;
+			matchLength += minMatch;
+
+			if (offset == 0 || offset > (size_t)(out - output) || matchLength > (size_t)(outEnd - out))
+				return false;
+
+			// a match that overlaps the output repeats the last bytes, thus it is copied byte by byte
+			const uint8_t* match = out - offset;
+			if (offset >= matchLength)
+				std::memcpy(out, match, matchLength);
+			else
+				for (size_t i = 0; i < matchLength; i++)
+					out[i] = match[i];
+			out += matchLength;
+		}
+
+		return out == outEnd;
+	}
+}
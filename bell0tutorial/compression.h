@@ -0,0 +1,31 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		16/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		a small and fast LZ77 block compression, in the spirit of LZ4, used by the pack archives
+*			the compressed block is a list of sequences; each sequence starts with a token byte, whose high nibble is the number
+*			of literals and whose low nibble is the length of the match minus 4 (a nibble of 15 is continued by bytes of 255),
+*			followed by the literals and the offset of the match (2 bytes, little endian); the last sequence only has literals
+*			decompression is a simple copy loop that checks all bounds, thus a corrupt block can not write past the output
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// FUNCTIONS ////////////////////////////////////////////////////////////////////////////
+namespace util
+{
+	// compresses a block of data; the compressed block can be larger than the input for data that does not compress
+	std::vector<uint8_t> compressBlock(const uint8_t* const input, const size_t inputSize);
+
+	// decompresses a block into a buffer of exactly the uncompressed size, returns false if the block is corrupt
+	bool decompressBlock(const uint8_t* const input, const size_t inputSize, uint8_t* const output, const size_t outputSize);
+}
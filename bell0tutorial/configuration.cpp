@@ -0,0 +1,143 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// Lua and Sol
+#include <sol.hpp>
+#pragma comment(lib, "liblua53.a")
+
+// the header
+#include "configuration.h"
+
+// c++ includes
+#include <cstdio>
+
+// bell0bytes util
+#include "stringConverter.h"
+
+// bell0bytes file system
+#include "saveFile.h"
+
+namespace fileSystem
+{
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// SERIALIZATION ///////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	std::string serializeConfiguration(const Configuration& configuration)
+	{
+		char text[512];
+		const int length = snprintf(text, sizeof(text),
+			"config =\r\n"
+			"{\r\n"
+			"\tfullscreen = %s,\r\n"
+			"\tresolution = { width = %u, height = %u, index = %d },\r\n"
+			"\tjoystick = %s,\r\n"
+			"\tgamepad = %s,\r\n"
+			"\tmusicVolume = %g,\r\n"
+			"\tsoundEffectsVolume = %g\r\n"
+			"}\r\n",
+			configuration.fullscreen ? "true" : "false", configuration.width, configuration.height, configuration.modeIndex, configuration.enableJoystick ? "true" : "false", configuration.enableGamepad ? "true" : "false", configuration.musicVolume, configuration.soundEffectsVolume);
+
+		return std::string(text, length > 0 && length < (int)sizeof(text) ? length : 0);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// ATOMIC WRITE ////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	util::Expected<void> writeConfigurationFile(const std::wstring& file, const Configuration& configuration)
+	{
+		const std::string text = serializeConfiguration(configuration);
+		if (text.empty())
+			return std::runtime_error("Unable to serialize the configuration!");
+
+		return writeFileAtomically(file, text.data(), text.size());
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// PARSING /////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	util::Expected<void> readConfigurationFile(const std::wstring& file, Configuration& configuration)
+	{
+		try
+		{
+			sol::state lua;
+			if (!lua.script_file(util::StringConverter::ws2s(file)).valid())
+				return std::runtime_error("Unable to open lua script file!");
+
+			// graphics
+			configuration.fullscreen = lua["config"]["fullscreen"].get_or(configuration.fullscreen);
+			configuration.width = lua["config"]["resolution"]["width"].get_or(configuration.width);
+			configuration.height = lua["config"]["resolution"]["height"].get_or(configuration.height);
+			configuration.modeIndex = lua["config"]["resolution"]["index"].get_or(configuration.modeIndex);
+
+			// input
+			configuration.enableJoystick = lua["config"]["joystick"].get_or(configuration.enableJoystick);
+			configuration.enableGamepad = lua["config"]["gamepad"].get_or(configuration.enableGamepad);
+
+			// audio
+			configuration.musicVolume = lua["config"]["musicVolume"].get_or(configuration.musicVolume);
+			configuration.soundEffectsVolume = lua["config"]["soundEffectsVolume"].get_or(configuration.soundEffectsVolume);
+		}
+		catch (std::exception& e)
+		{
+			return e;
+		}
+
+		// return success
+		return { };
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// SERVICE /////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	util::Expected<void> ConfigService::load(const std::wstring& file)
+	{
+		this->file = file;
+
+		// parse into a copy, such that a broken file does not leave a partial configuration behind
+		Configuration loadedConfiguration = configuration;
+		util::Expected<void> result = readConfigurationFile(file, loadedConfiguration);
+		if (!result.isValid())
+			return result;
+
+		configuration = loadedConfiguration;
+		version++;
+
+		// return success
+		return { };
+	}
+
+	util::Expected<void> ConfigService::apply(const Configuration& newConfiguration, const bool saveToFile)
+	{
+		// find the parts that changed
+		const bool graphicsChanged = newConfiguration.fullscreen != configuration.fullscreen || newConfiguration.width != configuration.width || newConfiguration.height != configuration.height || newConfiguration.modeIndex != configuration.modeIndex;
+		const bool inputChanged = newConfiguration.enableJoystick != configuration.enableJoystick || newConfiguration.enableGamepad != configuration.enableGamepad;
+		const bool audioChanged = newConfiguration.musicVolume != configuration.musicVolume || newConfiguration.soundEffectsVolume != configuration.soundEffectsVolume;
+		if (!graphicsChanged && !inputChanged && !audioChanged)
+			return { };
+
+		// save the configuration; if the file can not be written, the configuration is left unchanged
+		if (saveToFile && !file.empty())
+		{
+			util::Expected<void> result = writeConfigurationFile(file, newConfiguration);
+			if (!result.isValid())
+				return result;
+		}
+
+		configuration = newConfiguration;
+		version++;
+
+		// notify the observers of the parts that changed
+		const bool changedParts[] = { graphicsChanged, inputChanged, audioChanged };
+		for (int part = ConfigurationParts::GraphicsConfiguration; part <= ConfigurationParts::AudioConfiguration; part++)
+		{
+			if (!changedParts[part])
+				continue;
+
+			util::Expected<void> result = notify(part);
+			if (!result.isValid())
+				return result;
+		}
+
+		// return success
+		return { };
+	}
+}
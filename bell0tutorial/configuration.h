@@ -0,0 +1,80 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		13/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		the user preferences (bell0prefs.lua) as a typed structure
+*			the configuration file is written atomically: the whole file is written to a temporary file with a single write,
+*			flushed to the disk, and then renamed to replace the old file, thus a crash never leaves a partial configuration file behind
+*			the configuration service parses the file once and shares the configuration with all components;
+*			changes are applied to the structure, saved, and sent to the observers of the changed parts, without running Lua again
+*
+* History:	- 15/09/2019: changes that were read from the file are applied without saving them again
+*			- 19/09/2019: the atomic write is shared with the save files (saveFile.h)
+*			- 20/09/2019: a configuration that could not be saved is not applied
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <string>
+#include <cstdint>
+
+// bell0bytes util
+#include "expected.h"
+#include "observer.h"
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace fileSystem
+{
+	struct Configuration
+	{
+		// graphics
+		bool fullscreen = true;
+		unsigned int width = 1920;
+		unsigned int height = 1080;
+		int modeIndex = -1;						// the index of the display mode, -1 if unknown
+
+		// input
+		bool enableJoystick = false;
+		bool enableGamepad = false;
+
+		// audio
+		float musicVolume = 1.0f;
+		float soundEffectsVolume = 1.0f;
+	};
+
+	// the text of the configuration file
+	std::string serializeConfiguration(const Configuration& configuration);
+
+	// writes the configuration to the file atomically
+	util::Expected<void> writeConfigurationFile(const std::wstring& file, const Configuration& configuration);
+
+	// parses the configuration file, missing values keep the values of the given configuration
+	util::Expected<void> readConfigurationFile(const std::wstring& file, Configuration& configuration);
+
+	// the parts of the configuration, the observers of the configuration service are notified of the parts that changed
+	enum ConfigurationParts { GraphicsConfiguration, InputConfiguration, AudioConfiguration };
+
+	class ConfigService : public util::Subject
+	{
+	private:
+		std::wstring file;							// the configuration file
+		Configuration configuration;				// the current configuration
+		uint64_t version;							// incremented with each change of the configuration
+
+	public:
+		ConfigService() : file(), configuration(), version(0) {};
+
+		// reads the configuration file once, the default configuration is kept if the file can not be read
+		util::Expected<void> load(const std::wstring& file);
+
+		// replaces the configuration, saves it and notifies the observers of the parts that changed (main thread only)
+		// changes that were read from the configuration file (hot reload) do not need to be saved; if saving fails, nothing is changed
+		util::Expected<void> apply(const Configuration& newConfiguration, const bool saveToFile = true);
+
+		const Configuration& getConfiguration() const { return configuration; };
+		uint64_t getVersion() const { return version; };
+	};
+}
@@ -7,6 +7,9 @@
 // bell0bytes util
 #include "serviceLocator.h"
 
+// bell0bytes file system
+#include "fileSystemComponent.h"
+
 // bell0bytes graphics
 #include "graphicsComponent.h"
 #include "d3d.h"
@@ -171,6 +174,15 @@ namespace graphics
 		// add brush to the hash table
 		brushes[L"DarkOliveGreen"] = brush;
 
+		// create the sprite batch used to draw batched quads
+		if (FAILED(devCon->CreateSpriteBatch(&spriteBatch)))
+			return std::runtime_error("Critical error: Unable to create the sprite batch!");
+
+		// create a white pixel to be tinted by the sprite colours
+		const UINT32 whitePixel = 0xFFFFFFFF;
+		if (FAILED(devCon->CreateBitmap(D2D1::SizeU(1, 1), &whitePixel, sizeof(UINT32), D2D1::BitmapProperties1(D2D1_BITMAP_OPTIONS_NONE, D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED)), &whiteBitmap)))
+			return std::runtime_error("Critical error: Unable to create the bitmap for the sprite batch!");
+
 		// return success
 		return { };
 	}
@@ -220,10 +232,38 @@ namespace graphics
 	/////////////////////////////////////////////////////////////////////////////////////////
 	util::Expected<void> Direct2D::createBitmapFromWICBitmap(LPCWSTR imageFile, Microsoft::WRL::ComPtr<ID2D1Bitmap1>& bitmap) const
 	{
+		// read the image from the data folder or the pack archive
+		fileSystem::FileData fileData;
+		util::Expected<void> result = dxApp.getFileSystemComponent().readFile(imageFile, fileData);
+		if (!result.isValid())
+			return result;
+
+		return createBitmapFromWICBitmap(fileData, bitmap);
+	}
+	util::Expected<void> Direct2D::createBitmapFromWICBitmap(const fileSystem::AssetId imageAsset, Microsoft::WRL::ComPtr<ID2D1Bitmap1>& bitmap) const
+	{
+		// the asset knows where the image is, thus there is no search
+		fileSystem::FileData fileData;
+		util::Expected<void> result = dxApp.getFileSystemComponent().readFile(imageAsset, fileData);
+		if (!result.isValid())
+			return result;
+
+		return createBitmapFromWICBitmap(fileData, bitmap);
+	}
+	util::Expected<void> Direct2D::createBitmapFromWICBitmap(const fileSystem::FileData& fileData, Microsoft::WRL::ComPtr<ID2D1Bitmap1>& bitmap) const
+	{
+		// the decoder reads the image directly from the file data
+		Microsoft::WRL::ComPtr<IWICStream> stream;
+		if (FAILED(WICFactory->CreateStream(stream.GetAddressOf())))
+			return std::runtime_error("Failed to create the WIC stream!");
+
+		if (FAILED(stream->InitializeFromMemory(const_cast<BYTE*>(fileData.getData()), (DWORD)fileData.getSize())))
+			return std::runtime_error("Failed to initialize the WIC stream!");
+
 		// create decoder
 		Microsoft::WRL::ComPtr<IWICBitmapDecoder> bitmapDecoder;
-		if (FAILED(WICFactory->CreateDecoderFromFilename(imageFile, NULL, GENERIC_READ, WICDecodeMetadataCacheOnLoad, bitmapDecoder.ReleaseAndGetAddressOf())))
-			return std::runtime_error("Failed to create decoder from filename!");
+		if (FAILED(WICFactory->CreateDecoderFromStream(stream.Get(), NULL, WICDecodeMetadataCacheOnLoad, bitmapDecoder.ReleaseAndGetAddressOf())))
+			return std::runtime_error("Failed to create decoder from stream!");
 
 		// get the correct frame
 		Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
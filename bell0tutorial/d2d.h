@@ -14,12 +14,17 @@
 *			- 04/06/2018: various functions to create brushes and strokeStyles have been added
 *			- 04/06/2018: various functions to draw primitives have been added
 *			- 28/06/2018: sliced the DirectWrite method out of the class and into a seperate DirectWrite component
+*			- 24/08/2019: added a sprite batch to draw many quads in a single call
+*			- 16/09/2019: the images are decoded from memory, such that they can be read from the pack archive
+*			- 17/09/2019: images that were read asynchronously can be decoded
+*			- 18/09/2019: images can be loaded from interned assets
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
 
 // C++ includes
 #include <unordered_map>
+#include <vector>
 
 // Windows and COM
 #include <wrl/client.h>
@@ -48,6 +53,12 @@ namespace util
 	class Expected;
 }
 
+namespace fileSystem
+{
+	class FileData;
+	struct AssetId;
+}
+
 namespace graphics
 {
 	// forward declarations
@@ -70,12 +81,19 @@ namespace graphics
 		// brushes
 		std::unordered_map<std::wstring, Microsoft::WRL::ComPtr<ID2D1SolidColorBrush> > brushes;	// hash table of all available brushes
 
+		// batched quads
+		Microsoft::WRL::ComPtr<ID2D1SpriteBatch> spriteBatch;	// sprite batch used to draw many quads with a single call
+		Microsoft::WRL::ComPtr<ID2D1Bitmap1> whiteBitmap;		// a single white pixel, tinted by the colour of each sprite
+		std::vector<D2D1_COLOR_F> spriteColours;				// scratch array for the colours of the sprites
+
 		// create devices and resoures
 		util::Expected<void> createDevice(const Direct3D& d3d);					// creates the device and its context
 		util::Expected<void> createBitmapRenderTarget(const Direct3D& d3d);		// creates the bitmap render target, set to be the same as the backbuffer already in use for Direct3D
 		util::Expected<void> createDeviceIndependentResources();				// creates device independent resources
 		util::Expected<void> createDeviceDependentResources();					// creates device dependent resources
-		util::Expected<void> createBitmapFromWICBitmap(LPCWSTR imageFile, Microsoft::WRL::ComPtr<ID2D1Bitmap1>& bitmap) const;		// loads an image from the harddrive and stores it as a bitmap
+		util::Expected<void> createBitmapFromWICBitmap(LPCWSTR imageFile, Microsoft::WRL::ComPtr<ID2D1Bitmap1>& bitmap) const;		// loads an image from the data folder or the pack archive and stores it as a bitmap
+		util::Expected<void> createBitmapFromWICBitmap(const fileSystem::FileData& fileData, Microsoft::WRL::ComPtr<ID2D1Bitmap1>& bitmap) const;	// decodes an image that was already read, i.e. by the file IO service
+		util::Expected<void> createBitmapFromWICBitmap(const fileSystem::AssetId imageAsset, Microsoft::WRL::ComPtr<ID2D1Bitmap1>& bitmap) const;	// loads an interned image, without resolving its path again
 		
 		// private getters for the DWrite component
 		IDWriteFactory6& getWriteFactory() const;
@@ -1,11 +1,3 @@
-// Lua and Sol
-//#pragma warning( push )
-//#pragma warning( disable : 4127)	// disable constant if expr warning
-//#pragma warning( disable : 4702)	// disable unreachable code warning
-#include <sol.hpp>
-//#pragma warning( pop ) 
-#pragma comment(lib, "liblua53.a")
-
 // the header
 #include "d3d.h"
 
@@ -18,7 +10,7 @@
 
 // bell0bytes util
 #include "serviceLocator.h"
-#include "stringConverter.h"
+#include "logFilter.h"
 
 // bell0bytes graphics
 #include "graphicsComponent.h"
@@ -72,14 +64,19 @@ namespace graphics
 			throw std::runtime_error("Creation of Direct3D resources failed!");
 		}
 
-		// add core DirectXApp as observer
-		addObserver(&dxApp);
+		// add core DirectXApp as observer of resolution changes
+		addObserver(&dxApp, eventBit(input::Events::ChangeResolution));
+
+		// listen to changes of the graphics configuration
+		dxApp.getFileSystemComponent().getConfigService().addObserver(this, eventBit(fileSystem::ConfigurationParts::GraphicsConfiguration));
 
 		//  log success
 		util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("Direct3D was initialized successfully.");
 	}
 	Direct3D::~Direct3D()
 	{
+		dxApp.getFileSystemComponent().getConfigService().removeObserver(this);
+
 		// switch to windowed mode before exiting the application
 		swapChain->SetFullscreenState(false, nullptr);
 
@@ -342,10 +339,8 @@ namespace graphics
 		initPipeline();
 
 		// log and return success
-#ifndef NDEBUG
 		if (dxApp.gameHasStarted())
-			util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("The Direct3D and Direct2D resources were resized successfully.");
-#endif
+			LOG_DEBUG(GraphicsLog, "The Direct3D and Direct2D resources were resized successfully.");
 		return {};
 	}
 
@@ -404,9 +399,7 @@ namespace graphics
 		delete pixelShaderBuffer.get().buffer;
 
 		// log and return return success
-#ifndef NDEBUG
-		util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("The rendering pipeline was successfully initialized.");
-#endif
+		LOG_DEBUG(GraphicsLog, "The rendering pipeline was successfully initialized.");
 		return { };
 	}
 
@@ -518,6 +511,18 @@ namespace graphics
 		// resize everything
 		return notify(input::Events::ChangeResolution);
 	}
+	int Direct3D::findModeIndex(const unsigned int width, const unsigned int height, const int modeIndex) const
+	{
+		if (modeIndex >= 0 && modeIndex < (int)numberOfSupportedModes && supportedModes[modeIndex].Width == width && supportedModes[modeIndex].Height == height)
+			return modeIndex;
+
+		// the modes are sorted by resolution and refresh rate, prefer the highest refresh rate
+		for (int i = (int)numberOfSupportedModes - 1; i >= 0; i--)
+			if (supportedModes[i].Width == width && supportedModes[i].Height == height)
+				return i;
+
+		return -1;
+	}
 	util::Expected<void> Direct3D::toggleFullscreen()
 	{
 		if (!currentlyInFullscreen)
@@ -546,6 +551,40 @@ namespace graphics
 		return(fullscreen != currentlyInFullscreen ? true : false);
 	}
 
+	/////////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// Configuration ////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	util::Expected<void> Direct3D::onNotify(const int event)
+	{
+		if (event != fileSystem::ConfigurationParts::GraphicsConfiguration)
+			return { };
+
+		const fileSystem::Configuration& configuration = dxApp.getFileSystemComponent().getConfigService().getConfiguration();
+		util::Expected<void> result;
+
+		// the resolution: the size decides, the index only chooses between modes of the same size
+		const int modeIndex = findModeIndex(configuration.width, configuration.height, configuration.modeIndex);
+		if (modeIndex == -1)
+			util::ServiceLocator::getFileLogger()->print<util::SeverityType::warning>("The desired screen resolution is not supported! The resolution was not changed.");
+		else if (modeIndex != currentModeIndex)
+		{
+			result = changeResolution((unsigned int)modeIndex);
+			if (!result.isValid())
+				return result;
+		}
+
+		// the fullscreen mode
+		if (configuration.fullscreen != (currentlyInFullscreen != FALSE))
+		{
+			result = toggleFullscreen();
+			if (!result.isValid())
+				return result;
+		}
+
+		// return success
+		return { };
+	}
+
 	/////////////////////////////////////////////////////////////////////////////////////////
 	////////////////////////// Resolution Independence //////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
@@ -593,75 +632,26 @@ namespace graphics
 	/////////////////////////////////////////////////////////////////////////////////////////
 	util::Expected<void> Direct3D::writeCurrentModeDescriptionToConfigurationFile() const
 	{
-		// create the string to print
-		std::string resolution = "\tresolution = { width = " + std::to_string(currentModeDescription.Width) + ", height = " + std::to_string(currentModeDescription.Height) + " },";
-		// append name of the log file to the path
-		std::wstring pathToPrefFile = dxApp.getFileSystemComponent().getPathToConfigurationFiles() + L"\\" + dxApp.getFileSystemComponent().getPrefsFile();
-
-		// read the file
-		std::vector<std::string> data;
-		std::string input;
-
-		std::ifstream prefFileStreamIn(pathToPrefFile.c_str());
-		if (prefFileStreamIn.good())
-		{
-			while (std::getline(prefFileStreamIn, input))
-				data.push_back(input);
-			prefFileStreamIn.close();
-
-			// modify the stream
-			for (auto& line : data)
-			{
-				if (line.find("resolution") != std::string::npos)
-				{
-					line.replace(0, line.size(), resolution);
-					break;
-				}
-			}
-		}
-		else
-			return std::runtime_error("Unable to read the configuration file!");
-
-		// write the modified stream back to the file
-		std::ofstream prefFileStreamOut(pathToPrefFile.c_str());
-		if (prefFileStreamOut.good())
-		{
-			for (auto const& line : data)
-				prefFileStreamOut << line << std::endl;
-		}
-		else
-			return std::runtime_error("Unable to write to the configuration file!");
-
-		return {};
+		// update the resolution, the configuration service saves the file
+		fileSystem::ConfigService& configService = dxApp.getFileSystemComponent().getConfigService();
+		fileSystem::Configuration configuration = configService.getConfiguration();
+		configuration.width = currentModeDescription.Width;
+		configuration.height = currentModeDescription.Height;
+		configuration.modeIndex = currentModeIndex;
+
+		return configService.apply(configuration);
 	}
 	util::Expected<void> Direct3D::readConfigurationFile()
 	{
-		if (dxApp.getFileSystemComponent().hasValidConfigurationFile())
-		{
-			// configuration file exists, try to read from it
-			std::wstring pathToPrefFile = dxApp.getFileSystemComponent().getPathToConfigurationFiles() + L"\\" + dxApp.getFileSystemComponent().getPrefsFile();
-
-			try
-			{
-				sol::state lua;
-				lua.script_file(util::StringConverter::ws2s(pathToPrefFile));
+		// the configuration file was read by the configuration service
+		const fileSystem::Configuration& configuration = dxApp.getFileSystemComponent().getConfigService().getConfiguration();
 
-				// read fullscreen
-				startInFullscreen = lua["config"]["fullscreen"].get_or(false);
+		// read fullscreen
+		startInFullscreen = configuration.fullscreen;
 
-				// read index
-				currentModeIndex = lua["config"]["resolution"]["index"].get_or(-1);
-#ifndef NDEBUG
-				std::stringstream res;
-				res << "The fullscreen mode was read from the LUA configuration file: " << std::boolalpha << startInFullscreen << ".";
-				util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>(res.str());
-#endif
-			}
-			catch (std::exception)
-			{
-				util::ServiceLocator::getFileLogger()->print<util::SeverityType::warning>("Unable to read configuration file. Starting in windowed mode!");
-			}
-		}
+		// read index
+		currentModeIndex = configuration.modeIndex;
+		LOG_DEBUG(GraphicsLog, "The fullscreen mode was read from the configuration: %s.", startInFullscreen ? "true" : "false");
 
 		return { };
 	}
@@ -10,6 +10,7 @@
 *			- 13/03/2018: fullscreen support added
 *			- 03/06/2018: sends notifications to the DirectX class whenever the screen resolution must be changed
 *			- 03/06/2018: the DirectXApp class is no longer a friend
+*			- 20/09/2019: changes of the graphics configuration (resolution and fullscreen mode) are applied at runtime
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
@@ -71,7 +72,8 @@ namespace graphics
 	};
 
 	// the Direct3D class ; sends notification to the DirectXApp if the fullscreen mode or the resolution changes
-	class Direct3D : public util::Subject
+	// observes the graphics configuration of the configuration service
+	class Direct3D : public util::Subject, public util::Observer
 	{
 	private:
 		// members
@@ -120,6 +122,7 @@ namespace graphics
 		
 		// functions to change screen resolutions
 		void changeResolution(bool increase);					// changes the screen resolution, if increase is true, a higher resolution is chosen, else the resolution is lowered
+		int findModeIndex(const unsigned int width, const unsigned int height, const int modeIndex) const;	// the index of the supported mode with the given size, prefers the given index; -1 if there is none
 		
 		// rendering pipeline
 		util::Expected<void> initPipeline();					// initializes the (graphics) rendering pipeline
@@ -138,6 +141,9 @@ namespace graphics
 		util::Expected<void> toggleFullscreen();							// toggle fullscreen mode
 		util::Expected<void> changeResolution(const unsigned int index);	// change screen resolution to the desired index
 
+		// apply changes of the graphics configuration
+		util::Expected<void> onNotify(const int event) override;
+
 		// present the scene
 		void clearBuffers();				// clear the back and depth/stencil buffers (white)
 		void clearBuffers(float[4]);		// clear the back buffer with a given colour
@@ -6,16 +6,86 @@ namespace core
 	/////////////////////////////////////////////////////////////////////////////////////////
 	///////////////////////////// Constructor and Destructor ////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
-	Depesche::Depesche() : sender(nullptr), destination(nullptr), type((DepescheTypes)0), message(nullptr)
+	Depesche::Depesche() : sender(nullptr), destination(nullptr), type((DepescheTypes)0), payloadSize(0), external(nullptr)
 	{
 
 	}
 
-	Depesche::Depesche(DepescheSender& sender, DepescheDestination& destination, const DepescheTypes type, void* const msg) : sender(&sender), destination(&destination), type(type), message(msg)
+	Depesche::Depesche(DepescheSender& sender, DepescheDestination& destination, const DepescheTypes type) : sender(&sender), destination(&destination), type(type), payloadSize(0), external(nullptr)
+	{
+
+	}
+
+	Depesche::Depesche(DepescheSender& sender, const DepescheTypes type) : sender(&sender), destination(nullptr), type(type), payloadSize(0), external(nullptr)
 	{
 
 	}
 
 	Depesche::~Depesche()
 	{ }
-}
\ No newline at end of file
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////////// Arena ///////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	DepescheArena::DepescheArena() : current(0)
+	{
+		for (unsigned int i = 0; i < 2; i++)
+		{
+			buffers[i].reset(new unsigned char[capacity + alignment]);
+			used[i].store(0);
+			pending[i].store(0);
+		}
+	}
+
+	void* DepescheArena::allocate(const size_t size)
+	{
+		// pin the buffer of the current frame; if the main thread switched buffers in the meantime, try again with the new buffer
+		unsigned int buffer;
+		while (true)
+		{
+			buffer = current.load();
+			pending[buffer].fetch_add(1);
+			if (current.load() == buffer)
+				break;
+			pending[buffer].fetch_sub(1);
+		}
+
+		// bump the pointer
+		const size_t alignedSize = (size + alignment - 1) & ~(alignment - 1);
+		const size_t offset = used[buffer].fetch_add(alignedSize, std::memory_order_relaxed);
+		if (offset + alignedSize > capacity)
+		{
+			pending[buffer].fetch_sub(1);
+			return nullptr;
+		}
+
+		// align the start of the buffer
+		unsigned char* const begin = buffers[buffer].get();
+		unsigned char* const aligned = begin + ((alignment - (reinterpret_cast<std::uintptr_t>(begin) & (alignment - 1))) & (alignment - 1));
+		return aligned + offset;
+	}
+
+	void DepescheArena::release(const void* const payload)
+	{
+		// the buffer is found by the address of the payload
+		const unsigned char* const p = static_cast<const unsigned char*>(payload);
+		for (unsigned int i = 0; i < 2; i++)
+			if (p >= buffers[i].get() && p < buffers[i].get() + capacity + alignment)
+			{
+				pending[i].fetch_sub(1);
+				return;
+			}
+	}
+
+	void DepescheArena::nextFrame()
+	{
+		// the other buffer was last used two frames ago; usually, its messages were dispatched during the previous frame,
+		// but a message of another thread might still be queued, then the current buffer is kept for another frame
+		const unsigned int next = 1 - current.load();
+		if (pending[next].load() != 0)
+			return;
+
+		used[next].store(0, std::memory_order_relaxed);
+		current.store(next);
+	}
+}
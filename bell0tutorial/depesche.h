@@ -6,32 +6,178 @@
 *
 * Desc:		structure to define game events on the event queue
 *			"Depesche" is the German word for telegram
-* Hist:
+* Hist:		- 04/09/2019: typed payloads; small payloads are stored inline, larger ones in a per-frame arena
+*			- 05/09/2019: messages without a destination are delivered to all subscribers of their type
+*			- 07/09/2019: messages are time stamped when statistics are gathered
+*			- 09/09/2019: messages know the size of their payload, such that they can be recorded
+*			- 17/09/2019: files that were read asynchronously are announced by a message
+*			- 20/09/2019: a buffer of the arena is only reset once all messages allocated from it were dispatched
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
 
+// c++ includes
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <type_traits>
+
 // bell0bytes util
 #include "expected.h"
 
 // DEFINITIONS //////////////////////////////////////////////////////////////////////////
+
+// statistics of the event queue are gathered in debug builds; define DEPESCHE_STATISTICS as 1 to gather them in release builds as well
+#ifndef DEPESCHE_STATISTICS
+#ifndef NDEBUG
+#define DEPESCHE_STATISTICS 1
+#else
+#define DEPESCHE_STATISTICS 0
+#endif
+#endif
+
 namespace core
 {
-	enum DepescheTypes { ActiveKeyMap, Gamepad, TextInput, TextDelete, Score, PlaySoundEvent, StopSoundEvent, BeginStream, EndStream };
+	enum DepescheTypes { ActiveKeyMap, Gamepad, TextInput, TextDelete, Score, PlaySoundEvent, StopSoundEvent, BeginStream, EndStream, FileLoaded, nDepescheTypes };
+	static_assert(nDepescheTypes <= 32, "The subscriptions of the game states are stored as a 32-bit mask!");
 
 	class DepescheSender;
 	class DepescheDestination;
 
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// PAYLOADS ////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+
+	// each message type has exactly one payload type, the mapping is given by specializing DepeschePayload
+	// payloads must be trivially copyable, as they are copied into the message by value and never destroyed
+	template<DepescheTypes type>
+	struct DepeschePayload;
+
+	struct EmptyPayload { };
+
+	struct ActiveKeyMapPayload
+	{
+		bool wasListening = false;						// true iff the input handler just stopped listening for a new key binding
+	};
+
+	struct GamepadPayload
+	{
+		float vibration = 0.0f;							// the vibration speed of the gamepad motors
+	};
+
+	struct TextInputPayload
+	{
+		static const unsigned int maxLength = 20;
+		unsigned int length = 0;						// the number of characters entered this frame
+		wchar_t text[maxLength + 1] = { };				// the characters, null terminated
+
+		TextInputPayload() {};
+		TextInputPayload(const wchar_t* const str, const size_t n)
+		{
+			length = n < maxLength ? (unsigned int)n : maxLength;
+			std::memcpy(text, str, length * sizeof(wchar_t));
+			text[length] = L'\0';
+		};
+	};
+
+	template<> struct DepeschePayload<DepescheTypes::ActiveKeyMap> { typedef ActiveKeyMapPayload Type; };
+	template<> struct DepeschePayload<DepescheTypes::Gamepad> { typedef GamepadPayload Type; };
+	template<> struct DepeschePayload<DepescheTypes::TextInput> { typedef TextInputPayload Type; };
+	template<> struct DepeschePayload<DepescheTypes::TextDelete> { typedef EmptyPayload Type; };
+	template<> struct DepeschePayload<DepescheTypes::Score> { typedef EmptyPayload Type; };
+	// the audio messages are mapped in audioComponent.h, the file messages in fileIOService.h
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// ARENA ///////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+
+	// memory for payloads that are too large to be stored inline
+	// the arena has two buffers: while the messages of one frame are dispatched, the next frame allocates from the other buffer
+	// each buffer counts the payloads allocated from it that were not dispatched yet; the arena only switches to the other buffer,
+	// and resets it, once all of its payloads were released, thus a message that was allocated by another thread just before the
+	// switch, but added to the queue after the messages were dispatched, keeps its payload until it is dispatched in the next frame
+	class DepescheArena
+	{
+	private:
+		static const size_t capacity = 64 * 1024;		// the size of each buffer in bytes
+		static const size_t alignment = 16;				// the alignment of each allocation
+
+		std::unique_ptr<unsigned char[]> buffers[2];	// the memory
+		std::atomic<size_t> used[2];					// the number of bytes allocated from each buffer
+		std::atomic<size_t> pending[2];					// the number of payloads in each buffer that were not released yet
+		std::atomic<unsigned int> current;				// the buffer of the current frame
+
+	public:
+		DepescheArena();
+
+		void* allocate(const size_t size);				// thread-safe; returns nullptr if the buffer of the current frame is exhausted
+		void release(const void* const payload);		// thread-safe; to be called once the message with the payload was dispatched or dropped
+		void nextFrame();								// switches to the other buffer and resets it, if all its payloads were released (main thread only, before the messages are dispatched)
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// DEPESCHE ////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
 	struct Depesche
 	{
-		DepescheSender* const sender;				// the sender of the message
-		DepescheDestination* const destination;		// the destined receiver of the message
-		const DepescheTypes type;					// the type of the message
-		void* const message;						// the actual message
+		static const size_t inlineSize = 48;			// payloads up to this size are stored inside the message
+
+		DepescheSender* const sender;					// the sender of the message
+		DepescheDestination* const destination;			// the destined receiver of the message; if null, the message is delivered to all subscribers of its type
+		const DepescheTypes type;						// the type of the message
+		uint16_t payloadSize;							// the size of the payload in bytes
+#if DEPESCHE_STATISTICS
+		int64_t timeStamp;								// the time the message was added to the queue, in nanoseconds
+#endif
 
+	private:
+		alignas(8) unsigned char storage[inlineSize];	// the payload, if it is small enough
+		void* external;									// the payload in the arena, if it is too large to be stored inline
+
+	public:
 		Depesche();
-		Depesche(DepescheSender&, DepescheDestination&, const DepescheTypes, void* const);
+		Depesche(DepescheSender&, DepescheDestination&, const DepescheTypes);
+		Depesche(DepescheSender&, const DepescheTypes);		// multicast
 		~Depesche();
+
+		// copies the payload into the message, large payloads are copied into the arena
+		// returns false if the payload did not fit into the arena
+		template<DepescheTypes t>
+		bool setPayload(const typename DepeschePayload<t>::Type& payload, DepescheArena& arena)
+		{
+			typedef typename DepeschePayload<t>::Type Payload;
+			static_assert(std::is_trivially_copyable<Payload>::value, "Depesche payloads must be trivially copyable!");
+			static_assert(sizeof(Payload) <= 0xFFFF, "Depesche payloads must be smaller than 64 KB!");
+			assert(type == t);
+
+			void* target = storage;
+			if (sizeof(Payload) > inlineSize || alignof(Payload) > 8)
+			{
+				target = external = arena.allocate(sizeof(Payload));
+				if (external == nullptr)
+					return false;
+			}
+
+			std::memcpy(target, &payload, sizeof(Payload));
+			payloadSize = (uint16_t)sizeof(Payload);
+			return true;
+		}
+
+		// returns the payload of the message
+		template<DepescheTypes t>
+		const typename DepeschePayload<t>::Type& getPayload() const
+		{
+			assert(type == t);
+			return *reinterpret_cast<const typename DepeschePayload<t>::Type*>(external ? external : storage);
+		}
+
+		// the raw bytes of the payload, i.e. to record the message
+		const void* getPayloadData() const { return external ? external : storage; };
+		size_t getPayloadSize() const { return payloadSize; };
+		bool hasArenaPayload() const { return external != nullptr; };	// true iff the payload must be released to the arena
 	};
 
 	class DepescheSender
@@ -46,4 +192,4 @@ namespace core
 	public:
 		virtual util::Expected<void> onMessage(const Depesche&) = 0;// { return { }; }	// handle events
 	};
-}
\ No newline at end of file
+}
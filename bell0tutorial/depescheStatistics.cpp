@@ -0,0 +1,98 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// the header
+#include "depescheStatistics.h"
+
+#if DEPESCHE_STATISTICS
+
+namespace core
+{
+	namespace
+	{
+		// the names of the message types, as written to the JSON file
+		const char* const depescheTypeNames[] = { "ActiveKeyMap", "Gamepad", "TextInput", "TextDelete", "Score", "PlaySoundEvent", "StopSoundEvent", "BeginStream", "EndStream", "FileLoaded" };
+		static_assert(sizeof(depescheTypeNames) / sizeof(depescheTypeNames[0]) == nDepescheTypes, "Each message type needs a name!");
+
+		void writeHistogram(std::ostream& out, const util::Histogram& histogram)
+		{
+			out << "{ \"count\": " << histogram.getCount()
+				<< ", \"min\": " << histogram.getMinimum()
+				<< ", \"mean\": " << (uint64_t)histogram.getMean()
+				<< ", \"p50\": " << histogram.getValueAtPercentile(50.0)
+				<< ", \"p90\": " << histogram.getValueAtPercentile(90.0)
+				<< ", \"p99\": " << histogram.getValueAtPercentile(99.0)
+				<< ", \"p999\": " << histogram.getValueAtPercentile(99.9)
+				<< ", \"max\": " << histogram.getMaximum() << " }";
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// CONSTRUCTOR /////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	DepescheStatistics::DepescheStatistics() : highWaterMark(0), maxMessagesPerFrame(0), frames(0)
+	{
+		for (unsigned int i = 0; i < nDepescheTypes; i++)
+		{
+			added[i].store(0, std::memory_order_relaxed);
+			dropped[i].store(0, std::memory_order_relaxed);
+			dispatched[i] = 0;
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// RECORDING ///////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void DepescheStatistics::messageAdded(const DepescheTypes type, const size_t queueSize)
+	{
+		added[type].fetch_add(1, std::memory_order_relaxed);
+
+		// raise the high-water mark, unless another thread raised it even higher
+		size_t mark = highWaterMark.load(std::memory_order_relaxed);
+		while (queueSize > mark && !highWaterMark.compare_exchange_weak(mark, queueSize, std::memory_order_relaxed));
+	}
+
+	void DepescheStatistics::messageDispatched(const DepescheTypes type, const int64_t latencyNS, const int64_t handlerNS)
+	{
+		dispatched[type]++;
+		latency[type].record(latencyNS > 0 ? (uint64_t)latencyNS : 0);
+		handlerTime[type].record(handlerNS > 0 ? (uint64_t)handlerNS : 0);
+	}
+
+	void DepescheStatistics::frameDispatched(const size_t nMessages)
+	{
+		frames++;
+		if (nMessages > maxMessagesPerFrame)
+			maxMessagesPerFrame = nMessages;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// OUTPUT //////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void DepescheStatistics::writeJSON(std::ostream& out) const
+	{
+		out << "{\n";
+		out << "\t\"frames\": " << frames << ",\n";
+		out << "\t\"queueHighWaterMark\": " << highWaterMark.load(std::memory_order_relaxed) << ",\n";
+		out << "\t\"maxMessagesPerFrame\": " << maxMessagesPerFrame << ",\n";
+		out << "\t\"unit\": \"ns\",\n";
+		out << "\t\"types\": {\n";
+
+		for (unsigned int i = 0; i < nDepescheTypes; i++)
+		{
+			out << "\t\t\"" << depescheTypeNames[i] << "\": {\n";
+			out << "\t\t\t\"added\": " << added[i].load(std::memory_order_relaxed) << ",\n";
+			out << "\t\t\t\"dropped\": " << dropped[i].load(std::memory_order_relaxed) << ",\n";
+			out << "\t\t\t\"dispatched\": " << dispatched[i] << ",\n";
+			out << "\t\t\t\"latency\": ";
+			writeHistogram(out, latency[i]);
+			out << ",\n\t\t\t\"handlerTime\": ";
+			writeHistogram(out, handlerTime[i]);
+			out << "\n\t\t}" << (i + 1 < nDepescheTypes ? "," : "") << "\n";
+		}
+
+		out << "\t}\n";
+		out << "}\n";
+	}
+}
+
+#endif
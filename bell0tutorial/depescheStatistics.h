@@ -0,0 +1,69 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		07/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		statistics of the event queue, per message type:
+*				- the number of messages added, dropped and dispatched
+*				- the time each message waited in the queue, from addMessage to dispatch
+*				- the time spent in the onMessage handlers
+*			and for the queue itself the high-water mark and the largest number of messages dispatched in one frame
+*			the statistics are only gathered if DEPESCHE_STATISTICS is set (see depesche.h), otherwise this class is not compiled at all
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <atomic>
+#include <chrono>
+#include <ostream>
+
+// bell0bytes util
+#include "histogram.h"
+
+// bell0bytes core
+#include "depesche.h"
+
+#if DEPESCHE_STATISTICS
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace core
+{
+	class DepescheStatistics
+	{
+	private:
+		// counters, updated by any thread
+		std::atomic<uint64_t> added[nDepescheTypes];		// the number of messages added to the queue
+		std::atomic<uint64_t> dropped[nDepescheTypes];		// the number of messages that did not fit into the queue or the arena
+		std::atomic<size_t> highWaterMark;					// the largest number of messages in the queue
+
+		// dispatch statistics, main thread only
+		uint64_t dispatched[nDepescheTypes];				// the number of messages handed to their receivers
+		util::Histogram latency[nDepescheTypes];			// the time between addMessage and dispatch, in nanoseconds
+		util::Histogram handlerTime[nDepescheTypes];		// the time spent in the onMessage handlers, in nanoseconds
+		size_t maxMessagesPerFrame;							// the largest number of messages dispatched in one frame
+		uint64_t frames;									// the number of dispatched frames
+
+	public:
+		DepescheStatistics();
+
+		// the current time in nanoseconds, used to time stamp the messages
+		static int64_t now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); };
+
+		// thread-safe
+		void messageAdded(const DepescheTypes type, const size_t queueSize);
+		void messageDropped(const DepescheTypes type) { dropped[type].fetch_add(1, std::memory_order_relaxed); };
+
+		// main thread only
+		void messageDispatched(const DepescheTypes type, const int64_t latencyNS, const int64_t handlerNS);
+		void frameDispatched(const size_t nMessages);
+
+		// writes the statistics as a JSON object
+		void writeJSON(std::ostream& out) const;
+	};
+}
+
+#endif
@@ -0,0 +1,234 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// the header
+#include "eventRecorder.h"
+
+// c++ includes
+#include <fstream>
+#include <cstring>
+#include <cassert>
+
+// bell0bytes mathematics
+#include "numberTheory.h"
+
+namespace core
+{
+	namespace
+	{
+		// the file starts with a magic number, the version of the format and the seed of the random number generators
+		const char recordingMagic[4] = { 'b', '0', 'r', 'c' };
+		const uint32_t recordingVersion = 2;
+		const size_t fileHeaderSize = sizeof(recordingMagic) + sizeof(recordingVersion) + sizeof(uint64_t);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	///////////////////////////// Constructor and Destructor ////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	EventRecorder::EventRecorder() : mode(Idle), frame(0), replayPosition(0), divergences(0)
+	{ }
+
+	EventRecorder::~EventRecorder()
+	{
+		stop();
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	///////////////////////////// Start and Stop ////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	util::Expected<void> EventRecorder::startRecording(const std::wstring& file)
+	{
+		stop();
+
+		std::ofstream out(file.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!out.good())
+			return std::runtime_error("Unable to create the file to record the events to!");
+
+		out.write(recordingMagic, sizeof(recordingMagic));
+		out.write(reinterpret_cast<const char*>(&recordingVersion), sizeof(recordingVersion));
+
+		// the random number generators are reset, such that the replay starts with the same random numbers as the recording
+		mathematics::numberTheory::NumberTheory& numberTheory = mathematics::numberTheory::NumberTheory::getInstance();
+		const uint64_t seed = numberTheory.getSeed();
+		numberTheory.setSeed(seed);
+		out.write(reinterpret_cast<const char*>(&seed), sizeof(seed));
+
+		// the worker thread sleeps until a buffer is full
+		fullBuffers.reset(new util::ThreadSafeQueue<std::vector<char> >());
+		util::ThreadSafeQueue<std::vector<char> >* const queue = fullBuffers.get();
+		writer = std::thread([queue](std::ofstream out)
+		{
+			std::vector<char> data;
+			while (queue->waitDequeue(data))
+				out.write(data.data(), data.size());
+		}, std::move(out));
+
+		buffer.clear();
+		buffer.reserve(bufferSize + 1024);
+		frame = 0;
+		mode = Recording;
+
+		return { };
+	}
+
+	util::Expected<void> EventRecorder::startReplay(const std::wstring& file)
+	{
+		stop();
+
+		std::ifstream in(file.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+		if (!in.good())
+			return std::runtime_error("Unable to open the recorded events!");
+
+		// read the entire recording at once
+		const std::streamoff size = in.tellg();
+		in.seekg(0, std::ios::beg);
+		replayData.resize((size_t)size);
+		if (size > 0 && !in.read(replayData.data(), size))
+			return std::runtime_error("Unable to read the recorded events!");
+
+		// check the magic number and the version
+		uint32_t version = 0;
+		if (replayData.size() >= fileHeaderSize)
+			std::memcpy(&version, replayData.data() + sizeof(recordingMagic), sizeof(version));
+		if (replayData.size() < fileHeaderSize || std::memcmp(replayData.data(), recordingMagic, sizeof(recordingMagic)) != 0 || version != recordingVersion)
+		{
+			replayData.clear();
+			return std::runtime_error("The file does not contain recorded events of this version!");
+		}
+
+		// use the random numbers of the recording
+		uint64_t seed = 0;
+		std::memcpy(&seed, replayData.data() + sizeof(recordingMagic) + sizeof(recordingVersion), sizeof(seed));
+		mathematics::numberTheory::NumberTheory::getInstance().setSeed(seed);
+
+		replayPosition = fileHeaderSize;
+		frame = 0;
+		divergences = 0;
+		mode = Replaying;
+
+		return { };
+	}
+
+	void EventRecorder::stop()
+	{
+		if (mode == Recording)
+		{
+			// write the remaining records and wait for the worker thread
+			if (!buffer.empty())
+				fullBuffers->enqueue(std::move(buffer));
+			buffer.clear();
+			fullBuffers->close();
+			writer.join();
+			fullBuffers.reset();
+		}
+		else if (mode == Replaying)
+		{
+			replayData.clear();
+			replayData.shrink_to_fit();
+			replayPosition = 0;
+		}
+
+		mode = Idle;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	///////////////////////////// Records ///////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void EventRecorder::nextFrame(double& frameTime)
+	{
+		frame++;
+
+		if (mode == Recording)
+		{
+			append(RecordKinds::Frame, 0, &frameTime, sizeof(frameTime));
+			return;
+		}
+
+		skipPastRecords();
+
+		RecordHeader header;
+		if (peek(header) && header.kind == RecordKinds::Frame && header.frame == frame && header.size == sizeof(frameTime))
+		{
+			std::memcpy(&frameTime, replayData.data() + replayPosition + sizeof(RecordHeader), sizeof(frameTime));
+			replayPosition += sizeof(RecordHeader) + header.size;
+		}
+	}
+
+	void EventRecorder::recordInput(const void* const snapshot, const size_t size)
+	{
+		if (mode == Recording)
+			append(RecordKinds::Input, 0, snapshot, size);
+	}
+
+	bool EventRecorder::replayInput(void* const snapshot, const size_t size)
+	{
+		RecordHeader header;
+		if (mode != Replaying || !peek(header) || header.kind != RecordKinds::Input || header.frame != frame || header.size != size)
+			return false;
+
+		std::memcpy(snapshot, replayData.data() + replayPosition + sizeof(RecordHeader), size);
+		replayPosition += sizeof(RecordHeader) + header.size;
+		return true;
+	}
+
+	void EventRecorder::nextMessage(const Depesche& depesche)
+	{
+		if (mode == Recording)
+		{
+			append(RecordKinds::Message, (uint8_t)depesche.type, depesche.getPayloadData(), depesche.getPayloadSize());
+			return;
+		}
+
+		// the dispatched message must match the next recorded message of this frame
+		// payloads are not compared, as they might contain addresses, i.e. the sound events
+		RecordHeader header;
+		if (peek(header) && header.kind == RecordKinds::Message && header.frame == frame && header.type == (uint8_t)depesche.type && header.size == depesche.getPayloadSize())
+			replayPosition += sizeof(RecordHeader) + header.size;
+		else
+			divergences++;
+	}
+
+	void EventRecorder::append(const uint8_t kind, const uint8_t type, const void* const data, const size_t size)
+	{
+		assert(size <= 0xFFFF);
+		const RecordHeader header = { kind, type, (uint16_t)size, frame };
+
+		const size_t offset = buffer.size();
+		buffer.resize(offset + sizeof(RecordHeader) + size);
+		std::memcpy(buffer.data() + offset, &header, sizeof(RecordHeader));
+		if (size > 0)
+			std::memcpy(buffer.data() + offset + sizeof(RecordHeader), data, size);
+
+		// hand full buffers to the worker thread
+		if (buffer.size() >= bufferSize)
+		{
+			fullBuffers->enqueue(std::move(buffer));
+			buffer.clear();
+			buffer.reserve(bufferSize + 1024);
+		}
+	}
+
+	bool EventRecorder::peek(RecordHeader& header) const
+	{
+		if (replayPosition + sizeof(RecordHeader) > replayData.size())
+			return false;
+
+		std::memcpy(&header, replayData.data() + replayPosition, sizeof(RecordHeader));
+		return replayPosition + sizeof(RecordHeader) + header.size <= replayData.size();
+	}
+
+	void EventRecorder::skipPastRecords()
+	{
+		// recorded messages that were not dispatched during the replay are divergences
+		RecordHeader header;
+		while (peek(header) && header.frame < frame)
+		{
+			if (header.kind == RecordKinds::Message)
+				divergences++;
+			replayPosition += sizeof(RecordHeader) + header.size;
+		}
+
+		// a truncated record ends the replay
+		if (!peek(header))
+			replayPosition = replayData.size();
+	}
+}
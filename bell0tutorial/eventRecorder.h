@@ -0,0 +1,99 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		09/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		records the frame times, the input snapshots and the dispatched messages of each frame to a compact binary file,
+*			and replays them, such that performance problems that depend on a specific input sequence can be reproduced
+*			each record is a small header (kind, message type, size, frame number) followed by the raw data;
+*			while recording, the records are appended to a buffer in memory, full buffers are written to the file by a worker thread
+*			while replaying, the frame times and input snapshots are fed back into the game, the recorded messages are compared
+*			to the dispatched messages to detect when the replay diverges from the recording
+*			when neither recording nor replaying, each call costs a single branch
+*			the file header stores the seed of the random number generators, which is restored when the replay starts
+*
+* History:	- 20/09/2019: the seed of the random number generators is recorded
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <string>
+#include <vector>
+#include <thread>
+#include <memory>
+#include <cstdint>
+
+// bell0bytes util
+#include "expected.h"
+#include "safeQueue.h"
+
+// bell0bytes core
+#include "depesche.h"
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace core
+{
+	class EventRecorder
+	{
+	private:
+		enum RecordKinds : uint8_t { Frame = 1, Input = 2, Message = 3 };
+
+		// the header of each record, the data follows directly
+		struct RecordHeader
+		{
+			uint8_t kind;								// see above
+			uint8_t type;								// the type of the message, if the record is a message
+			uint16_t size;								// the size of the data in bytes
+			uint32_t frame;								// the frame number
+		};
+
+		static const size_t bufferSize = 64 * 1024;		// full buffers are handed to the worker thread
+
+		enum Modes { Idle, Recording, Replaying } mode;
+		uint32_t frame;									// the current frame number
+
+		// recording
+		std::vector<char> buffer;						// the records of the current buffer
+		std::unique_ptr<util::ThreadSafeQueue<std::vector<char> > > fullBuffers;	// the buffers to be written to the file
+		std::thread writer;								// writes the full buffers to the file
+
+		// replaying
+		std::vector<char> replayData;					// the entire recording
+		size_t replayPosition;							// the position of the next record
+		unsigned int divergences;						// the number of messages that did not match the recording
+
+		void nextFrame(double& frameTime);
+		void nextMessage(const Depesche& depesche);
+
+		void append(const uint8_t kind, const uint8_t type, const void* const data, const size_t size);
+		bool peek(RecordHeader& header) const;			// reads the header of the next record, returns false at the end of the recording
+		void skipPastRecords();							// skips the records of past frames, i.e. messages that were not dispatched during the replay
+
+	public:
+		EventRecorder();
+		~EventRecorder();
+
+		// start and stop recording or replaying
+		util::Expected<void> startRecording(const std::wstring& file);
+		util::Expected<void> startReplay(const std::wstring& file);
+		void stop();
+
+		bool isRecording() const { return mode == Recording; };
+		bool isReplaying() const { return mode == Replaying; };
+		bool replayHasEnded() const { return mode == Replaying && replayPosition >= replayData.size(); };
+		unsigned int getNumberOfDivergences() const { return divergences; };
+
+		// begins a new frame: while recording, the frame time is recorded, while replaying, it is replaced by the recorded frame time
+		void beginFrame(double& frameTime) { if (mode != Idle) nextFrame(frameTime); };
+
+		// input snapshots: while recording, the snapshot is recorded, while replaying, it is overwritten by the recorded snapshot
+		// returns false if there was no snapshot recorded for the current frame
+		void recordInput(const void* const snapshot, const size_t size);
+		bool replayInput(void* const snapshot, const size_t size);
+
+		// messages: while recording, the message is recorded, while replaying, it is compared to the recorded message
+		void recordMessage(const Depesche& depesche) { if (mode != Idle) nextMessage(depesche); };
+	};
+}
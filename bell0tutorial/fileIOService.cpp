@@ -0,0 +1,212 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// the header
+#include "fileIOService.h"
+
+// bell0bytes core
+#include "app.h"
+
+// bell0bytes file system
+#include "fileSystemComponent.h"
+
+// bell0bytes util
+#include "serviceLocator.h"
+
+namespace fileSystem
+{
+	namespace
+	{
+		// reads one byte of each page, such that the data of a mapped file is in memory before the main thread reads it
+		void touchPages(const FileData& fileData)
+		{
+			const size_t pageSize = 4096;
+			volatile uint8_t sum = 0;
+			for (size_t offset = 0; offset < fileData.getSize(); offset += pageSize)
+				sum += fileData.getData()[offset];
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	///////////////////////////// Constructor and Destructor ////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	FileIOService::FileIOService(core::DirectXApp& dxApp, const FileSystemComponent& fileSystemComponent, unsigned int nWorkers) : dxApp(dxApp), fileSystemComponent(fileSystemComponent), nextRequest(1), stopping(false), frame(0)
+	{
+		// the disk does not get faster with more threads, the workers mostly wait
+		if (nWorkers == 0)
+		{
+			nWorkers = std::thread::hardware_concurrency() / 2;
+			if (nWorkers < 1)
+				nWorkers = 1;
+			if (nWorkers > 4)
+				nWorkers = 4;
+		}
+
+		for (unsigned int i = 0; i < nWorkers; i++)
+			workers.push_back(std::thread(&FileIOService::work, this));
+	}
+
+	FileIOService::~FileIOService()
+	{
+		{
+			std::lock_guard<std::mutex> lock(requestMutex);
+			stopping = true;
+		}
+		requestCondition.notify_all();
+
+		for (auto& worker : workers)
+			worker.join();
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	///////////////////////////// Requests //////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	uint64_t FileIOService::readFile(const std::wstring& file, const IOPriorities priority, core::DepescheDestination* destination)
+	{
+		uint64_t id;
+		{
+			std::lock_guard<std::mutex> lock(requestMutex);
+			id = nextRequest++;
+			requests[priority].push_back({ id, file, AssetId(), destination });
+		}
+		requestCondition.notify_one();
+
+		return id;
+	}
+	uint64_t FileIOService::readFile(const AssetId asset, const IOPriorities priority, core::DepescheDestination* destination)
+	{
+		uint64_t id;
+		{
+			std::lock_guard<std::mutex> lock(requestMutex);
+			id = nextRequest++;
+			requests[priority].push_back({ id, std::wstring(), asset, destination });
+		}
+		requestCondition.notify_one();
+
+		return id;
+	}
+
+	bool FileIOService::cancel(const uint64_t request)
+	{
+		std::lock_guard<std::mutex> lock(requestMutex);
+		for (auto& queue : requests)
+			for (auto it = queue.begin(); it != queue.end(); it++)
+				if (it->id == request)
+				{
+					queue.erase(it);
+					return true;
+				}
+
+		return false;
+	}
+
+	size_t FileIOService::getNumberOfQueuedRequests() const
+	{
+		std::lock_guard<std::mutex> lock(requestMutex);
+		size_t nRequests = 0;
+		for (const auto& queue : requests)
+			nRequests += queue.size();
+		return nRequests;
+	}
+
+	bool FileIOService::popRequest(Request& request)
+	{
+		for (auto& queue : requests)
+			if (!queue.empty())
+			{
+				request = std::move(queue.front());
+				queue.pop_front();
+				return true;
+			}
+
+		return false;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	///////////////////////////// Results ///////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	util::Expected<void> FileIOService::takeResult(const uint64_t request, FileData& fileData)
+	{
+		Result result;
+		{
+			std::lock_guard<std::mutex> lock(resultMutex);
+			auto it = results.find(request);
+			if (it == results.end())
+				return std::runtime_error("The request was not completed or its result was already taken!");
+
+			result = std::move(it->second);
+			results.erase(it);
+		}
+
+		if (!result.error.empty())
+			return std::runtime_error(result.error);
+
+		fileData = std::move(result.fileData);
+
+		// return success
+		return { };
+	}
+
+	void FileIOService::nextFrame()
+	{
+		const uint64_t currentFrame = ++frame;
+
+		// the messages of the completed requests were dispatched in the frame after their completion
+		std::lock_guard<std::mutex> lock(resultMutex);
+		for (auto it = results.begin(); it != results.end();)
+		{
+			if (currentFrame - it->second.frame > 2)
+				it = results.erase(it);
+			else
+				it++;
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	///////////////////////////// Workers ///////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void FileIOService::work()
+	{
+		util::ServiceLocator::getFileLogger()->setThreadName("fileIOThread");
+
+		while (true)
+		{
+			Request request;
+			{
+				std::unique_lock<std::mutex> lock(requestMutex);
+				requestCondition.wait(lock, [this, &request] { return stopping || popRequest(request); });
+				if (stopping)
+					return;
+			}
+
+			// read the file, the pages of the data are loaded into memory by the worker
+			Result result;
+			util::Expected<void> readResult = request.asset.isValid() ? fileSystemComponent.readFile(request.asset, result.fileData) : fileSystemComponent.readFile(request.file, result.fileData);
+			try
+			{
+				readResult.get();
+				touchPages(result.fileData);
+			}
+			catch (std::exception& e)
+			{
+				result.error = e.what();
+				if (result.error.empty())
+					result.error = "Unable to read the file!";
+			}
+
+			FileLoadedPayload payload;
+			payload.request = request.id;
+			payload.succeeded = result.error.empty();
+			{
+				std::lock_guard<std::mutex> lock(resultMutex);
+				result.frame = frame;
+				results[request.id] = std::move(result);
+			}
+
+			// the main thread is notified with the next messages it dispatches
+			if (request.destination != nullptr)
+				dxApp.addMessage<core::DepescheTypes::FileLoaded>(*this, *request.destination, payload);
+			else
+				dxApp.publishMessage<core::DepescheTypes::FileLoaded>(*this, payload);
+		}
+	}
+}
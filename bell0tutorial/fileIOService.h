@@ -0,0 +1,128 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		17/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		reads data files asynchronously, such that loading overlaps with the game
+*			the requests are queued by priority and handled by a small pool of worker threads; the workers read the files through
+*			the file system component (loose files or the pack archive), decompress them, and touch each page of the data, such that
+*			the main thread never waits for the disk
+*			once a file was read, a FileLoaded message is sent to the destination of the request (or to all its subscribers),
+*			the message is dispatched by the main thread with the other messages; the receiver takes the file data with takeResult
+*			results that were not taken are discarded two frames after the request was completed
+*
+* History:	- 18/09/2019: interned assets can be read, without resolving their paths again
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
+#include <condition_variable>
+
+// bell0bytes util
+#include "expected.h"
+
+// bell0bytes core
+#include "depesche.h"
+
+// bell0bytes file system
+#include "packArchive.h"
+#include "assets.h"
+
+// DEFINITIONS //////////////////////////////////////////////////////////////////////////
+namespace core
+{
+	class DirectXApp;
+}
+
+namespace fileSystem
+{
+	class FileSystemComponent;
+
+	// the requests with the highest priority are handled first
+	enum IOPriorities { CriticalIO, NormalIO, BackgroundIO, nIOPriorities };
+
+	// the payload of the FileLoaded message
+	struct FileLoadedPayload
+	{
+		uint64_t request = 0;							// the request, as returned by readFile
+		bool succeeded = false;							// false if the file could not be read; takeResult returns the error
+	};
+}
+
+namespace core
+{
+	template<> struct DepeschePayload<DepescheTypes::FileLoaded> { typedef fileSystem::FileLoadedPayload Type; };
+}
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace fileSystem
+{
+	class FileIOService : public core::DepescheSender
+	{
+	private:
+		struct Request
+		{
+			uint64_t id;
+			std::wstring file;
+			AssetId asset;								// read instead of the file, if it is valid
+			core::DepescheDestination* destination;		// null to publish the message to all subscribers
+		};
+
+		struct Result
+		{
+			FileData fileData;
+			std::string error;							// empty iff the file was read
+			uint64_t frame;								// the frame in which the request was completed
+		};
+
+		core::DirectXApp& dxApp;						// sends the messages
+		const FileSystemComponent& fileSystemComponent;	// reads the files
+
+		// the queued requests
+		mutable std::mutex requestMutex;
+		std::condition_variable requestCondition;		// wakes up the workers
+		std::deque<Request> requests[nIOPriorities];
+		uint64_t nextRequest;							// the id of the next request, starting at 1
+		bool stopping;									// true iff the workers must stop
+
+		// the completed requests
+		std::mutex resultMutex;
+		std::unordered_map<uint64_t, Result> results;
+		std::atomic<uint64_t> frame;					// the current frame
+
+		// the worker threads
+		std::vector<std::thread> workers;
+		void work();
+		bool popRequest(Request& request);				// takes the oldest request with the highest priority; requestMutex must be locked
+
+	public:
+		// the number of workers defaults to half the number of cores, at least one and at most four
+		FileIOService(core::DirectXApp& dxApp, const FileSystemComponent& fileSystemComponent, unsigned int nWorkers = 0);
+		~FileIOService();
+
+		// queues a request to read a file (thread-safe); returns the id of the request, which is sent with the FileLoaded message
+		uint64_t readFile(const std::wstring& file, const IOPriorities priority = NormalIO, core::DepescheDestination* destination = nullptr);
+		uint64_t readFile(const AssetId asset, const IOPriorities priority = NormalIO, core::DepescheDestination* destination = nullptr);
+
+		// removes a request that was not started yet, returns false if it was already started (thread-safe)
+		bool cancel(const uint64_t request);
+
+		// takes the file data of a completed request; to be called when the FileLoaded message is received
+		util::Expected<void> takeResult(const uint64_t request, FileData& fileData);
+
+		// discards the results that were not taken; to be called once per frame by the main thread
+		void nextFrame();
+
+		size_t getNumberOfQueuedRequests() const;
+	};
+}
@@ -7,6 +7,7 @@
 // bell0bytes utilities
 #include "expected.h"			// error handling
 #include "serviceLocator.h"		// the service locator pattern
+#include "logFilter.h"			// log macros
 
 namespace fileSystem
 {
@@ -40,9 +41,23 @@ namespace fileSystem
 			throw e;
 		}
 
+		// mount the packed data folder; without an archive, all files are read from the data folder
+		if (dataArchive.mount(pathToDataFolder + L".pak").isValid())
+			LOG_INFO(FileSystemLog, "The pack archive was mounted: %u files.", dataArchive.getNumberOfFiles());
+		else
+			LOG_DEBUG(FileSystemLog, "There is no valid pack archive, the data files are read from the data folder.");
+
 		// check for valid configuration file
 		if (!checkConfigurationFile())
 			util::ServiceLocator::getFileLogger()->print<util::SeverityType::warning>("Non-existent or invalid configuration file. Starting with default settings.");
+		else
+		{
+			// read the configuration file, once, for all components
+			if (configService.load(pathToUserConfigurationFiles + L"\\" + userPrefFile).isValid())
+				LOG_DEBUG(FileSystemLog, "The configuration file was read.");
+			else
+				util::ServiceLocator::getFileLogger()->print<util::SeverityType::warning>("Unable to read the configuration file. Starting with default settings.");
+		}
 	}
 	FileSystemComponent::~FileSystemComponent()
 	{ }
@@ -50,7 +65,7 @@ namespace fileSystem
 	/////////////////////////////////////////////////////////////////////////////////////////
 	///////////////////////////// Configuration Files ///////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
-	util::Expected<void> FileSystemComponent::saveConfiguration(const unsigned int width, const unsigned int height, const unsigned int index, const bool fullscreen, const bool enableJoystick, const bool enableGamepad, const float musicVolume, const float soundEffectsVolume) const
+	util::Expected<void> FileSystemComponent::saveConfiguration(const Configuration& configuration) const
 	{
 		// create directory (if it does not exist already)
 		HRESULT hr;
@@ -59,44 +74,11 @@ namespace fileSystem
 		if (FAILED(hr))
 			return std::runtime_error("Critical error: unable to get path to 'My Documents' folder!");
 #endif
-		// append name of the log file to the path
+		// append name of the configuration file to the path
 		std::wstring pathToPrefFile = pathToUserConfigurationFiles + L"\\" + userPrefFile; // L"\\bell0prefs.lua";
 
-		// the directory exists, check if the log file is accessible
-		std::ifstream prefStream(pathToPrefFile.c_str());
-		if (prefStream.good())
-		{
-			// the file exists and can be read
-			try
-			{
-				util::Logger<util::FileLogPolicy> prefFileCreator(pathToPrefFile.c_str());
-				std::stringstream printPref;
-				printPref << "config =\r\n{ \r\n\tfullscreen = " << std::boolalpha << fullscreen << ",\r\n\tresolution = { width = " << width << ", height = " << height << ", index = " << index << " },\r\n\tjoystick = " << enableJoystick << ",\r\n\tgamepad = " << enableGamepad << ",\r\n" << "\tmusicVolume = " << musicVolume << ",\r\n " << "\tsoundEffectsVolume = " << soundEffectsVolume << "\r\n}";
-				prefFileCreator.print<util::config>(printPref.str());
-			}
-			catch (std::exception& e)
-			{
-				return e;
-			}
-		}
-		else
-		{
-			// the file does not exist --> create it
-			try
-			{
-				util::Logger<util::FileLogPolicy> prefFileCreator(pathToPrefFile.c_str());
-				std::stringstream printPref;
-				printPref << "config =\r\n{ \r\n\tfullscreen = " << std::boolalpha << fullscreen << ",\r\n\tresolution = { width = " << width << ", height = " << height << ", index = " << index << " },\r\n\tjoystick = " << enableJoystick << ",\r\n\tgamepad = " << enableGamepad << ",\r\n" << "\tmusicVolume = " << musicVolume << ",\r\n " << "\tsoundEffectsVolume = " << soundEffectsVolume << "\r\n}";
-				prefFileCreator.print<util::config>(printPref.str());
-			}
-			catch (std::exception& e)
-			{
-				return e;
-			}
-		}
-
-		// return success
-		return {};
+		// replace the file
+		return writeConfigurationFile(pathToPrefFile, configuration);
 	}
 	const bool FileSystemComponent::checkConfigurationFile()
 	{
@@ -110,43 +92,18 @@ namespace fileSystem
 		// append name of the configuration file to the path
 		std::wstring pathToPrefFile = pathToUserConfigurationFiles + L"\\" + userPrefFile; // L"\\bell0prefs.lua";
 
-		  // the directory exists, check if the log file is accessible
-		std::ifstream prefStream(pathToPrefFile.c_str());
-		if (prefStream.good())
-		{
-			// the file exists and can be read
-			if (prefStream.peek() == std::ifstream::traits_type::eof())
-			{
-				// the file is empty, create it
-				try
-				{
-					util::Logger<util::FileLogPolicy> prefFileCreator(pathToPrefFile.c_str());
-					std::stringstream printPref;
-					printPref << "config =\r\n{ \r\n\tfullscreen = true,\r\n\tresolution = { width = 1920, height = 1080 },\r\n\tjoystick = false,\r\n\tgamepad = false,\r\n\tmusicVolume = 1,\r\n\tsoundEffectsVolume = 1\r\n}";
-					prefFileCreator.print<util::config>(printPref.str());
-				}
-				catch (std::runtime_error)
-				{
-					return false;
-				}
-			}
-		}
-		else
+		// the directory exists, check if the configuration file is accessible and not empty
+		bool createFile = true;
 		{
-			// the file does not exist --> create it
-			try
-			{
-				util::Logger<util::FileLogPolicy> prefFileCreator(pathToPrefFile.c_str());
-				std::stringstream printPref;
-				printPref << "config =\r\n{ \r\n\tfullscreen = true,\r\n\tresolution = { width = 1920, height = 1080 },\r\n\tjoystick = false,\r\n\tgamepad = false,\r\n\tmusicVolume = 1,\r\n\tsoundEffectsVolume = 1\r\n}";
-				prefFileCreator.print<util::config>(printPref.str());
-			}
-			catch (std::runtime_error)
-			{
-				return false;
-			}
+			std::ifstream prefStream(pathToPrefFile.c_str());
+			if (prefStream.good())
+				createFile = prefStream.peek() == std::ifstream::traits_type::eof();
 		}
 
+		// the file does not exist or is empty --> create it with the default settings
+		if (createFile && !writeConfigurationFile(pathToPrefFile, Configuration()).isValid())
+			return false;
+
 		validUserConfigurationFile = true;
 		return true;
 	}
@@ -285,6 +242,7 @@ namespace fileSystem
 		keyBindingsFileJoystick = pathToLocalAppData + L"keyBindingsJoystick.dat";
 		keyBindingsFileGamepad = pathToLocalAppData + L"keyBindingsGamepad.dat";
 		highscoreFile = pathToRoamingAppData + L"highscoreFile.dat";
+		saveGameFile = pathToRoamingAppData + L"saveGame.dat";
 
 		// return success
 		return true;
@@ -328,6 +286,122 @@ namespace fileSystem
 		return L"Unable to locate file!";
 	}
 
+	util::Expected<void> FileSystemComponent::readFile(const std::wstring& file, FileData& fileData) const
+	{
+		// loose files override the packed files
+		if (GetFileAttributesW(file.c_str()) != INVALID_FILE_ATTRIBUTES)
+		{
+			std::shared_ptr<MappedFile> mappedFile = std::make_shared<MappedFile>();
+			util::Expected<void> result = mappedFile->open(file);
+			if (!result.isValid())
+				return result;
+
+			fileData = FileData(mappedFile->getData(), mappedFile->getSize(), mappedFile);
+			return { };
+		}
+
+		// the files in the archive are named relative to the data folder
+		const std::wstring pathInArchive = getPathInArchive(file);
+		if (dataArchive.isMounted() && !pathInArchive.empty())
+			return dataArchive.readFile(pathInArchive, fileData);
+
+		return std::runtime_error("Unable to locate file!");
+	}
+
+	const std::wstring FileSystemComponent::getPathInArchive(const std::wstring& file) const
+	{
+		if (file.size() > pathToDataFolder.size() + 1 && file.compare(0, pathToDataFolder.size(), pathToDataFolder) == 0)
+			return file.substr(pathToDataFolder.size() + 1);
+
+		return std::wstring();
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	///////////////////////////// Assets ////////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	AssetId FileSystemComponent::getAssetId(const DataFolders& dataFolder, const std::wstring& filename) const
+	{
+		AssetId id;
+		if (dataFolder >= DataFolders::End)
+			return id;
+
+		// the asset was already resolved
+		{
+			std::shared_lock<std::shared_mutex> lock(assetMutex);
+			auto it = assetIds[dataFolder].find(filename);
+			if (it != assetIds[dataFolder].end())
+			{
+				id.value = it->second;
+				return id;
+			}
+		}
+
+		// resolve the asset: loose files override the pack archive
+		Asset asset;
+		asset.folder = dataFolder;
+		asset.name = filename;
+		asset.path = openFile(dataFolder, filename);
+
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (GetFileAttributesExW(asset.path.c_str(), GetFileExInfoStandard, &attributes) && !(attributes.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+		{
+			asset.loose = true;
+			asset.size = ((uint64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+		}
+		else if (dataArchive.isMounted())
+		{
+			asset.packedEntry = dataArchive.findEntry(getPathInArchive(asset.path));
+			if (asset.packedEntry != nullptr)
+				asset.size = asset.packedEntry->size;
+		}
+
+		// another thread might have resolved the same asset in the meantime
+		std::unique_lock<std::shared_mutex> lock(assetMutex);
+		auto it = assetIds[dataFolder].find(filename);
+		if (it != assetIds[dataFolder].end())
+		{
+			id.value = it->second;
+			return id;
+		}
+
+		assets.push_back(std::move(asset));
+		id.value = (uint32_t)assets.size();
+		assetIds[dataFolder].emplace(filename, id.value);
+		return id;
+	}
+
+	const Asset* FileSystemComponent::getAsset(const AssetId id) const
+	{
+		std::shared_lock<std::shared_mutex> lock(assetMutex);
+		if (!id.isValid() || id.value > assets.size())
+			return nullptr;
+
+		return &assets[id.value - 1];
+	}
+
+	util::Expected<void> FileSystemComponent::readFile(const AssetId id, FileData& fileData) const
+	{
+		const Asset* asset = getAsset(id);
+		if (asset == nullptr)
+			return std::runtime_error("Unknown asset!");
+
+		if (asset->loose)
+		{
+			std::shared_ptr<MappedFile> mappedFile = std::make_shared<MappedFile>();
+			util::Expected<void> result = mappedFile->open(asset->path);
+			if (!result.isValid())
+				return result;
+
+			fileData = FileData(mappedFile->getData(), mappedFile->getSize(), mappedFile);
+			return { };
+		}
+
+		if (asset->packedEntry != nullptr)
+			return dataArchive.readEntry(*asset->packedEntry, fileData);
+
+		return std::runtime_error("Unable to locate file!");
+	}
+
 	/////////////////////////////////////////////////////////////////////////////////////////
 	///////////////////////////// Logger ////////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
@@ -346,8 +420,11 @@ namespace fileSystem
 		// append name of the log file to the path
 		std::wstring logFile = pathToLogFiles + L"\\bell0engine.log";
 
-		// create file logger
-		std::shared_ptr<util::Logger<util::FileLogPolicy> > engineLogger(new util::Logger<util::FileLogPolicy>(logFile));
+		// create file logger, keeping the two previous files once the log file grows too large
+		util::LogRotation rotation;
+		rotation.maxFileSize = 16 * 1024 * 1024;
+		rotation.maxFiles = 2;
+		std::shared_ptr<util::Logger<util::FileLogPolicy> > engineLogger(new util::Logger<util::FileLogPolicy>(logFile, util::LogFileFormat::textFile, rotation));
 
 		// set logger to active
 		activeFileLogger = true;
@@ -358,10 +435,8 @@ namespace fileSystem
 		// register the logging service
 		util::ServiceLocator::provideFileLoggingService(engineLogger);
 
-#ifndef NDEBUG
 		// print starting message
-		util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("The file logger was created successfully.");
-#endif
+		LOG_DEBUG(FileSystemLog, "The file logger was created successfully.");
 	}
 
 	/////////////////////////////////////////////////////////////////////////////////////////
@@ -399,4 +474,8 @@ namespace fileSystem
 	{
 		return highscoreFile;
 	}
+	const std::wstring& FileSystemComponent::getSaveGameFile() const
+	{
+		return saveGameFile;
+	}
 }
@@ -5,17 +5,33 @@
 * Date:		26/06/2018 - Lenningen - Luxembourg
 *
 * Desc:		file system components of the DirectXApp class:
-* Hist:
+* Hist:		- 13/09/2019: the configuration file is parsed once, the components read the configuration from the configuration service
+*			- 16/09/2019: the data files are read from a memory-mapped pack archive, loose files override the packed files
+*			- 18/09/2019: the data files can be interned as assets, which are resolved once
+*			- 19/09/2019: the highscores and the progress of the game are stored in binary save files
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
 
 // c++ includes
 #include <string>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
 
 // folder data
 #include "folders.h"
 
+// the user preferences
+#include "configuration.h"
+
+// pack archives
+#include "packArchive.h"
+
+// interned assets
+#include "assets.h"
+
 // DEFINITIONS //////////////////////////////////////////////////////////////////////////
 namespace core
 {
@@ -41,6 +57,15 @@ namespace fileSystem
 		std::wstring pathToArtworkFolder;			// path to the main artwork folder
 		std::wstring pathToAudioFolder;				// path to the main music folder
 
+		// the data files
+		PackArchive dataArchive;					// the packed data folder (Data.pak), if it exists
+		const std::wstring getPathInArchive(const std::wstring& file) const;	// the path relative to the data folder, empty if the file is not in the data folder
+
+		// the interned assets; they are resolved when they are first requested, thus the cache is mutable
+		mutable std::shared_mutex assetMutex;
+		mutable std::deque<Asset> assets;			// the asset with the id i is assets[i - 1]; a deque never moves its elements
+		mutable std::unordered_map<std::wstring, uint32_t> assetIds[DataFolders::End];	// the ids of the assets in each data folder
+
 		// folder paths (application)
 		std::wstring pathToLocalAppData;			// data bound to the user, the machine and the application (FOLDERID_LocalAppData)
 		std::wstring pathToRoamingAppData;			// data bound to the user and the application (FOLDERID_RoamingAppData)
@@ -53,14 +78,18 @@ namespace fileSystem
 
 		// configuration file names
 		const std::wstring userPrefFile;			// configuration file editable by the user
+
+		// the user preferences
+		ConfigService configService;				// the parsed configuration file, shared by all components
 		
 		// key binding file names
 		std::wstring keyBindingsFileKeyboard;		// game input configuration file for keyboard input
 		std::wstring keyBindingsFileJoystick;		// game input configuration file for joystick input
 		std::wstring keyBindingsFileGamepad;		// game input configuration file for gamepad input
 
-		// highscore file name
+		// highscore and save game file names
 		std::wstring highscoreFile;					// file containing high score data
+		std::wstring saveGameFile;					// file containing the progress of the game
 
 		// booleans to keep track whether important files exist or not
 		bool validUserConfigurationFile;			// true iff there was a valid user configuration file at startup
@@ -81,9 +110,22 @@ namespace fileSystem
 
 		// get file name depending on data folder
 		const std::wstring openFile(const DataFolders&, const std::wstring&) const;	// gets the correct path to a given filename in a specified data folder
+
+		// reads a data file, given its path (see openFile): a loose file overrides the file in the pack archive
+		// uncompressed files are returned without a copy
+		util::Expected<void> readFile(const std::wstring& file, FileData& fileData) const;
+
+		// interned assets (thread-safe): the file is resolved once, later requests only use the id
+		AssetId getAssetId(const DataFolders& dataFolder, const std::wstring& filename) const;
+		const Asset* getAsset(const AssetId id) const;			// null if the id is not valid
+		util::Expected<void> readFile(const AssetId id, FileData& fileData) const;
 		
-		// write resolution and fullscreen state to lua file
-		util::Expected<void> saveConfiguration(const unsigned int width, const unsigned int height, const unsigned int index, const bool fullscreen, const bool enableJoystick, const bool enableGamepad, const float musicVolume, const float soundEffectsVolume) const;
+		// write the user preferences to the lua file (atomically)
+		util::Expected<void> saveConfiguration(const Configuration& configuration) const;
+
+		// the user preferences, read once at startup
+		ConfigService& getConfigService() { return configService; };
+		const ConfigService& getConfigService() const { return configService; };
 
 		// get paths
 		const std::wstring& getPathToConfigurationFiles() const;
@@ -96,8 +138,9 @@ namespace fileSystem
 		const std::wstring& getJoystickFile() const;
 		const std::wstring& getGamepadFile() const;
 
-		// get highscore file
+		// get highscore and save game files
 		const std::wstring& getHighscoreFile() const;
+		const std::wstring& getSaveGameFile() const;
 
 		friend class core::DirectXApp;
 	};
@@ -0,0 +1,362 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// the header
+#include "fileWatcher.h"
+
+// c++ includes
+#include <algorithm>
+
+#ifdef _WIN32
+// windows includes
+#include <Windows.h>
+#elif defined(__linux__)
+// linux includes
+#include <sys/inotify.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace util
+{
+	/////////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// Constructor and Destructor ///////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	FileWatcher::FileWatcher(const std::chrono::milliseconds debounceTime, const std::chrono::milliseconds pollInterval) : debounceTime(debounceTime), pollInterval(pollInterval), running(false), nativeNotifications(false)
+	{
+#ifdef _WIN32
+		stopEvent = NULL;
+#elif defined(__linux__)
+		inotifyHandle = -1;
+		stopPipe[0] = stopPipe[1] = -1;
+#endif
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		stop();
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// Watch Files //////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void FileWatcher::watchFile(const std::wstring& file, ParseFunction parse)
+	{
+		if (running)
+			return;
+
+		WatchedFile watchedFile;
+		watchedFile.file = file;
+		watchedFile.parse = std::move(parse);
+		watchedFile.changed = false;
+		watchedFiles.push_back(std::move(watchedFile));
+
+		// watch the folder of the file
+		std::filesystem::path folder = std::filesystem::path(file).parent_path();
+		if (folder.empty())
+			folder = L".";
+		if (std::find(watchedFolders.begin(), watchedFolders.end(), folder) == watchedFolders.end())
+			watchedFolders.push_back(folder);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// Start and Stop ///////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	Expected<void> FileWatcher::start()
+	{
+		if (running)
+			return { };
+
+		// the current state of the files; only later changes are parsed
+		for (auto& watchedFile : watchedFiles)
+			watchedFile.stamp = getFileStamp(watchedFile.file);
+
+		// poll the files if the operating system does not send notifications
+		nativeNotifications = openNotifications();
+
+		// start the worker thread
+		running = true;
+		try { watcherThread = std::thread(&FileWatcher::watch, this); }
+		catch (std::system_error& e)
+		{
+			running = false;
+			closeNotifications();
+			return e;
+		}
+
+		// return success
+		return { };
+	}
+
+	void FileWatcher::stop()
+	{
+		if (!running)
+			return;
+
+		running = false;
+		wakeUp();
+		if (watcherThread.joinable())
+			watcherThread.join();
+
+		closeNotifications();
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// Apply Changes ////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	Expected<void> FileWatcher::applyChanges()
+	{
+		Expected<void> result;
+
+		ApplyFunction apply;
+		while (changes.tryDequeue(apply))
+			result = apply();
+
+		return result;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// Worker Thread ////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void FileWatcher::watch()
+	{
+		while (running)
+		{
+			// sleep until a folder changed; while a file waits for the debounce time, wake up when it is due
+			std::chrono::milliseconds timeout = pollInterval;
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			for (const auto& watchedFile : watchedFiles)
+			{
+				if (!watchedFile.changed)
+					continue;
+
+				std::chrono::milliseconds remaining = std::chrono::duration_cast<std::chrono::milliseconds>(watchedFile.changeTime + debounceTime - now) + std::chrono::milliseconds(1);
+				if (remaining < std::chrono::milliseconds(0))
+					remaining = std::chrono::milliseconds(0);
+				if (remaining < timeout)
+					timeout = remaining;
+			}
+			waitForChanges(timeout);
+
+			if (!running)
+				break;
+
+			checkFiles();
+			parseFiles();
+		}
+	}
+
+	void FileWatcher::checkFiles()
+	{
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		for (auto& watchedFile : watchedFiles)
+		{
+			const FileStamp stamp = getFileStamp(watchedFile.file);
+			if (stamp == watchedFile.stamp)
+				continue;
+
+			// each change restarts the debounce time
+			watchedFile.stamp = stamp;
+			watchedFile.changed = true;
+			watchedFile.changeTime = now;
+		}
+	}
+
+	void FileWatcher::parseFiles()
+	{
+		const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		for (auto& watchedFile : watchedFiles)
+		{
+			if (!watchedFile.changed || now - watchedFile.changeTime < debounceTime)
+				continue;
+			watchedFile.changed = false;
+
+			// the file was deleted; it is parsed again once it is recreated
+			if (!watchedFile.stamp.exists)
+				continue;
+
+			// errors are reported to the main thread
+			ApplyFunction apply;
+			std::string error;
+			try
+			{
+				Expected<void> result = watchedFile.parse(watchedFile.file.wstring(), apply);
+				result.get();
+			}
+			catch (std::exception& e)
+			{
+				error = e.what();
+			}
+
+			if (!error.empty())
+				apply = [error]() -> Expected<void> { return std::runtime_error(error); };
+
+			if (apply)
+				changes.enqueue(std::move(apply));
+		}
+	}
+
+	FileWatcher::FileStamp FileWatcher::getFileStamp(const std::filesystem::path& file)
+	{
+		FileStamp stamp;
+		std::error_code error;
+
+		stamp.exists = std::filesystem::is_regular_file(file, error);
+		if (!stamp.exists)
+			return stamp;
+
+		stamp.lastWriteTime = std::filesystem::last_write_time(file, error);
+		stamp.size = std::filesystem::file_size(file, error);
+		return stamp;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// Notifications ////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+#ifdef _WIN32
+	bool FileWatcher::openNotifications()
+	{
+		// the stop event and one handle per folder must fit into a single wait
+		if (watchedFolders.empty() || watchedFolders.size() + 1 > MAXIMUM_WAIT_OBJECTS)
+			return false;
+
+		stopEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
+		if (stopEvent == NULL)
+			return false;
+
+		for (const auto& folder : watchedFolders)
+		{
+			HANDLE notification = FindFirstChangeNotificationW(folder.c_str(), FALSE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+			if (notification == INVALID_HANDLE_VALUE)
+			{
+				closeNotifications();
+				return false;
+			}
+			changeNotifications.push_back(notification);
+		}
+
+		return true;
+	}
+
+	void FileWatcher::closeNotifications()
+	{
+		for (auto notification : changeNotifications)
+			FindCloseChangeNotification(notification);
+		changeNotifications.clear();
+
+		if (stopEvent != NULL)
+			CloseHandle(stopEvent);
+		stopEvent = NULL;
+	}
+
+	void FileWatcher::waitForChanges(const std::chrono::milliseconds timeout)
+	{
+		if (!nativeNotifications)
+		{
+			std::unique_lock<std::mutex> lock(pollMutex);
+			pollCondition.wait_for(lock, timeout, [this] { return !running; });
+			return;
+		}
+
+		std::vector<HANDLE> handles(changeNotifications.begin(), changeNotifications.end());
+		handles.push_back(stopEvent);
+
+		const DWORD result = WaitForMultipleObjects((DWORD)handles.size(), handles.data(), FALSE, (DWORD)timeout.count());
+		if (result >= WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + changeNotifications.size())
+			FindNextChangeNotification(changeNotifications[result - WAIT_OBJECT_0]);
+	}
+
+	void FileWatcher::wakeUp()
+	{
+		if (stopEvent != NULL)
+			SetEvent(stopEvent);
+
+		{ std::lock_guard<std::mutex> lock(pollMutex); }
+		pollCondition.notify_all();
+	}
+#elif defined(__linux__)
+	bool FileWatcher::openNotifications()
+	{
+		inotifyHandle = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (inotifyHandle < 0)
+			return false;
+
+		if (pipe2(stopPipe, O_NONBLOCK | O_CLOEXEC) != 0)
+		{
+			closeNotifications();
+			return false;
+		}
+
+		for (const auto& folder : watchedFolders)
+			if (inotify_add_watch(inotifyHandle, folder.c_str(), IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO) < 0)
+			{
+				closeNotifications();
+				return false;
+			}
+
+		return true;
+	}
+
+	void FileWatcher::closeNotifications()
+	{
+		if (inotifyHandle >= 0)
+			close(inotifyHandle);
+		inotifyHandle = -1;
+
+		for (int& handle : stopPipe)
+		{
+			if (handle >= 0)
+				close(handle);
+			handle = -1;
+		}
+	}
+
+	void FileWatcher::waitForChanges(const std::chrono::milliseconds timeout)
+	{
+		if (!nativeNotifications)
+		{
+			std::unique_lock<std::mutex> lock(pollMutex);
+			pollCondition.wait_for(lock, timeout, [this] { return !running; });
+			return;
+		}
+
+		pollfd handles[2] = { { inotifyHandle, POLLIN, 0 }, { stopPipe[0], POLLIN, 0 } };
+		if (poll(handles, 2, (int)timeout.count()) <= 0)
+			return;
+
+		// the events only wake up the thread, the files are checked anyway
+		char events[4096];
+		while (read(inotifyHandle, events, sizeof(events)) > 0);
+	}
+
+	void FileWatcher::wakeUp()
+	{
+		if (stopPipe[1] >= 0)
+			(void)!write(stopPipe[1], "", 1);
+
+		{ std::lock_guard<std::mutex> lock(pollMutex); }
+		pollCondition.notify_all();
+	}
+#else
+	bool FileWatcher::openNotifications()
+	{
+		return false;
+	}
+
+	void FileWatcher::closeNotifications()
+	{
+	}
+
+	void FileWatcher::waitForChanges(const std::chrono::milliseconds timeout)
+	{
+		std::unique_lock<std::mutex> lock(pollMutex);
+		pollCondition.wait_for(lock, timeout, [this] { return !running; });
+	}
+
+	void FileWatcher::wakeUp()
+	{
+		{ std::lock_guard<std::mutex> lock(pollMutex); }
+		pollCondition.notify_all();
+	}
+#endif
+}
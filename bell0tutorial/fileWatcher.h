@@ -0,0 +1,126 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		15/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		watches files for changes, such that configuration files can be reloaded while the game is running
+*			a worker thread waits for changes in the folders of the watched files (change notifications on Windows, inotify on Linux,
+*			polling the time stamps and sizes of the files as fallback)
+*			editors often write a file several times in a row (temporary file, rename, ...), thus a file is only parsed once it
+*			did not change for the debounce time; only the files that changed are parsed, on the worker thread
+*			the parse functions return the function that applies the parsed data, those functions are run by the main thread
+*			between two frames (applyChanges), such that the game never sees a half-applied change
+*			files must be registered before the watcher is started
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <filesystem>
+#include <condition_variable>
+
+// bell0bytes util
+#include "expected.h"
+#include "safeQueue.h"
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace util
+{
+	class FileWatcher
+	{
+	public:
+		// applies the parsed data of a file (main thread)
+		typedef std::function<Expected<void>()> ApplyFunction;
+
+		// parses a file that changed and sets the function that applies the parsed data (worker thread)
+		typedef std::function<Expected<void>(const std::wstring& file, ApplyFunction& apply)> ParseFunction;
+
+	private:
+		// the state of a file, a file changed if its state changed
+		struct FileStamp
+		{
+			bool exists = false;
+			std::filesystem::file_time_type lastWriteTime;
+			uintmax_t size = 0;
+
+			bool operator==(const FileStamp& stamp) const { return exists == stamp.exists && lastWriteTime == stamp.lastWriteTime && size == stamp.size; };
+			bool operator!=(const FileStamp& stamp) const { return !(*this == stamp); };
+		};
+
+		struct WatchedFile
+		{
+			std::filesystem::path file;
+			ParseFunction parse;
+			FileStamp stamp;							// the state of the file when it was last checked
+			bool changed;								// true iff the file changed and was not parsed yet
+			std::chrono::steady_clock::time_point changeTime;	// the time of the last change
+		};
+
+		std::vector<WatchedFile> watchedFiles;			// only accessed by the worker thread once the watcher was started
+		std::vector<std::filesystem::path> watchedFolders;	// the folders of the watched files
+		const std::chrono::milliseconds debounceTime;	// a changed file is parsed once it did not change for this long
+		const std::chrono::milliseconds pollInterval;	// the files are checked at least this often
+
+		// the changes waiting to be applied by the main thread
+		ThreadSafeQueue<ApplyFunction> changes;
+
+		// the worker thread
+		std::thread watcherThread;
+		std::atomic<bool> running;
+
+		// the notifications of the operating system; if they are not available, the files are polled
+#ifdef _WIN32
+		std::vector<void*> changeNotifications;			// one change notification handle per folder
+		void* stopEvent;								// wakes up the worker thread when the watcher is stopped
+#elif defined(__linux__)
+		int inotifyHandle;
+		int stopPipe[2];								// wakes up the worker thread when the watcher is stopped
+#endif
+		bool nativeNotifications;						// true iff the operating system notifies the watcher of changes
+		std::mutex pollMutex;
+		std::condition_variable pollCondition;			// wakes up the worker thread when the watcher is stopped (polling only)
+
+		bool openNotifications();						// asks the operating system for notifications about the watched folders
+		void closeNotifications();
+		void waitForChanges(const std::chrono::milliseconds timeout);	// sleeps until a watched folder changed, the timeout elapsed or the watcher was stopped
+		void wakeUp();									// wakes up the worker thread
+
+		void watch();									// the worker thread
+		void checkFiles();								// marks the files whose state changed
+		void parseFiles();								// parses the files that did not change for the debounce time
+		static FileStamp getFileStamp(const std::filesystem::path& file);
+
+	public:
+		// constructor and destructor
+		FileWatcher(const std::chrono::milliseconds debounceTime = std::chrono::milliseconds(200), const std::chrono::milliseconds pollInterval = std::chrono::milliseconds(1000));
+		~FileWatcher();
+
+		FileWatcher(const FileWatcher&) = delete;
+		FileWatcher& operator=(const FileWatcher&) = delete;
+
+		// registers a file, the parse function is called on the worker thread each time the file changed
+		void watchFile(const std::wstring& file, ParseFunction parse);
+
+		// starts and stops the worker thread
+		Expected<void> start();
+		void stop();
+
+		// applies the parsed changes; to be called by the main thread at a frame boundary
+		// all changes are applied, the last error is returned
+		Expected<void> applyChanges();
+
+		const bool isRunning() const { return running; };
+		const bool usesNativeNotifications() const { return nativeNotifications; };
+	};
+}
@@ -15,8 +15,12 @@
 // bell0bytes write
 #include "graphicsComponentWrite.h"
 
+// bell0bytes file system
+#include "assets.h"
+
 // bell0bytes util
 #include "serviceLocator.h"
+#include "logFilter.h"
 
 namespace graphics
 {
@@ -146,9 +150,7 @@ namespace graphics
 	/////////////////////////////////////////////////////////////////////////////////////////
 	util::Expected<void> GraphicsComponent::onResize(core::DirectXApp& dxApp)
 	{
-#ifndef NDEBUG
-		util::ServiceLocator::getFileLogger()->print<util::SeverityType::warning>("The window was resized. The game graphics must be updated!");
-#endif
+		LOG_DEBUG(GraphicsLog, "The window was resized. The game graphics must be updated!");
 		// handle errors
 		util::Expected<void> result;
 		
@@ -247,6 +249,21 @@ namespace graphics
 
 		return { };
 	}
+	util::Expected<void> GraphicsComponent::createNewAnimationData(const std::vector<AnimationCycleData>& animationCycleData, const fileSystem::AssetId spriteSheetAsset, AnimationData** animationData) const
+	{
+		try { *animationData = new AnimationData(*this->graphics2D->d2d, spriteSheetAsset, animationCycleData); }
+		catch (std::exception& e) { return e; }
+
+		return { };
+	}
+
+	util::Expected<void> GraphicsComponent::createNewAnimationData(const std::vector<AnimationCycleData>& animationCycleData, const fileSystem::FileData& spriteSheetData, AnimationData** animationData) const
+	{
+		try { *animationData = new AnimationData(*this->graphics2D->d2d, spriteSheetData, animationCycleData); }
+		catch (std::exception& e) { return e; }
+
+		return { };
+	}
 
 	AnimatedSprite* GraphicsComponent::createNewAnimatedSprite(AnimationData* const animData, const unsigned int activeAnimation, const float animationFPS, const float x, const float y, const Layers layer, const unsigned int drawOrder) const
 	{
@@ -11,7 +11,8 @@
 *				- 2D component - currently powered by Direct2D and DirectWrite
 *				- 3D component - currently powered by Direct3D
 *				- Sprites
-* Hist:
+* Hist:	- 18/09/2019: animations can be created from interned assets
+*			- 20/09/2019: animations can be created from images that were read by the file IO service
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
@@ -107,6 +108,8 @@ namespace graphics
 
 		// sprites and animations
 		util::Expected<void> createNewAnimationData(const std::vector<AnimationCycleData>&, const std::wstring&, AnimationData**) const;		// given the data of the animation cycle and a string to the image to load, this function creates the animation data for an animated sprite
+		util::Expected<void> createNewAnimationData(const std::vector<AnimationCycleData>&, const fileSystem::AssetId, AnimationData**) const;	// as above, with an interned image
+		util::Expected<void> createNewAnimationData(const std::vector<AnimationCycleData>&, const fileSystem::FileData&, AnimationData**) const;	// as above, with an image that was already read
 		AnimatedSprite* createNewAnimatedSprite(AnimationData* const animData, const unsigned int activeAnimation = 0, const float animationFPS = 24, const float x = 0.0f, const float y = 0.0f, const Layers layer = Layers::Characters, const unsigned int drawOrder = 0) const;
 		
 		// friends
@@ -122,6 +122,35 @@ namespace graphics
 			d2d->devCon->DrawRectangle(&rect, d2d->blackBrush.Get(), width, strokeStyle);
 	}
 
+	// fill a batch of rectangles
+	void GraphicsComponent2D::submit(const BrushHandle brush, const Quad* const quads, const unsigned int nQuads) const
+	{
+		if (nQuads == 0)
+			return;
+
+		// the colour of the brush, the opacity of each quad is baked into the alpha channel of its sprite
+		D2D1_COLOR_F colour = getBrush(BrushHandles::getInstance().getName(brush)).GetColor();
+		d2d->spriteColours.resize(nQuads);
+		for (unsigned int i = 0; i < nQuads; i++)
+		{
+			d2d->spriteColours[i] = colour;
+			d2d->spriteColours[i].a = colour.a * quads[i].opacity;
+		}
+
+		// add all quads to the sprite batch; the quads start with a D2D1_RECT_F, thus they can be passed with a stride
+		if (FAILED(d2d->spriteBatch->AddSprites(nQuads, (const D2D1_RECT_F*)quads, NULL, d2d->spriteColours.data(), NULL, sizeof(Quad), 0, sizeof(D2D1_COLOR_F), 0)))
+			return;
+
+		// sprite batches can only be drawn with aliased antialiasing
+		D2D1_ANTIALIAS_MODE antialiasMode = d2d->devCon->GetAntialiasMode();
+		d2d->devCon->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+		d2d->devCon->DrawSpriteBatch(d2d->spriteBatch.Get(), 0, nQuads, d2d->whiteBitmap.Get(), D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR, D2D1_SPRITE_OPTIONS_NONE);
+		d2d->devCon->SetAntialiasMode(antialiasMode);
+
+		// empty the batch for the next group
+		d2d->spriteBatch->Clear();
+	}
+
 	// fill and draw rounded rectangles
 	void GraphicsComponent2D::fillRoundedRectangle(const float ulX, const float ulY, const float lrX, const float lrY, const float radiusX, const float radiusY, const float opacity, ID2D1Brush* const brush) const
 	{
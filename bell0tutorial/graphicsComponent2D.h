@@ -8,6 +8,7 @@
 *
 * Hist:		- 28/06/2018: the "compute point on ellipse" method is now in a maths class
 *			- 05/04/2019: added function to draw lines
+*			- 24/08/2019: the component is now a backend for batched quads
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
@@ -18,6 +19,9 @@
 // Windows includes
 #include <wrl.h>
 
+// bell0bytes graphics
+#include "quadBatch.h"
+
 // DEFINITIONS //////////////////////////////////////////////////////////////////////////
 
 namespace util
@@ -36,7 +40,7 @@ namespace graphics
 	class Direct2D;
 	class Direct3D;
 
-	class GraphicsComponent2D
+	class GraphicsComponent2D : public QuadBatchBackend
 	{
 	private:
 		Direct2D* d2d;
@@ -67,6 +71,9 @@ namespace graphics
 		void drawRectangle(const float ulX, const float ulY, const float lrX, const float lrY, ID2D1Brush* const brush = NULL, const float width = 1.0f, ID2D1StrokeStyle1* const strokeStyle = NULL) const;
 		void drawRectangle(const D2D1_POINT_2F& upperLeft, const D2D1_POINT_2F& lowerRight, ID2D1Brush* const brush = NULL, const float width = 1.0f, ID2D1StrokeStyle1* const strokeStyle = NULL) const;
 
+		// fill a batch of rectangles with a single draw call
+		void submit(const BrushHandle brush, const Quad* const quads, const unsigned int nQuads) const override;
+
 		// draw and fill rounded rectangles
 		void fillRoundedRectangle(const float ulX, const float ulY, const float lrX, const float lrY, const float radiusX, const float radiusY, const float opacity = 1.0f, ID2D1Brush* const brush = NULL) const;
 		void fillRoundedRectangle(const D2D1_POINT_2F& upperLeft, const D2D1_POINT_2F& lowerRight, const float radiusX, const float radiusY, const float opacity = 1.0f, ID2D1Brush* const brush = NULL) const;
@@ -0,0 +1,92 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// the header
+#include "highscores.h"
+
+// c++ includes
+#include <algorithm>
+
+// bell0bytes file system
+#include "saveFile.h"
+
+namespace game
+{
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// HIGHSCORES //////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	HighscoreTable::HighscoreTable(const unsigned int maxScores) : maxScores(maxScores)
+	{
+		scores.reserve(maxScores + 1);
+	}
+
+	int HighscoreTable::insert(const Score& score)
+	{
+		if (!isHighscore(score.points))
+			return -1;
+
+		// the new score is ranked below the older scores with the same points
+		auto position = std::upper_bound(scores.begin(), scores.end(), score.points, [](const uint32_t points, const Score& s) { return points > s.points; });
+		position = scores.insert(position, score);
+		position->name[sizeof(position->name) - 1] = '\0';
+		const int rank = (int)(position - scores.begin());
+
+		if (scores.size() > maxScores)
+			scores.pop_back();
+
+		return rank;
+	}
+
+	bool HighscoreTable::isHighscore(const uint32_t points) const
+	{
+		if (maxScores == 0)
+			return false;
+
+		return scores.size() < maxScores || points > scores.back().points;
+	}
+
+	util::Expected<void> HighscoreTable::load(const std::wstring& file)
+	{
+		scores.clear();
+
+		std::vector<Score> savedScores;
+		util::Expected<void> result = fileSystem::readSaveFile(file, highscoreMagic, highscoreVersion, savedScores);
+		if (!result.isValid())
+			return result;
+
+		// the scores are inserted one by one, thus the table is sorted even if the file was not
+		for (const Score& score : savedScores)
+			insert(score);
+
+		// return success
+		return { };
+	}
+
+	util::Expected<void> HighscoreTable::save(const std::wstring& file) const
+	{
+		return fileSystem::writeSaveFile(file, highscoreMagic, highscoreVersion, scores);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// PROGRESS ////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	util::Expected<void> saveProgress(const std::wstring& file, const Progress& progress)
+	{
+		return fileSystem::writeSaveFile(file, progressMagic, progressVersion, std::vector<Progress>(1, progress));
+	}
+
+	util::Expected<void> loadProgress(const std::wstring& file, Progress& progress)
+	{
+		std::vector<Progress> savedProgress;
+		util::Expected<void> result = fileSystem::readSaveFile(file, progressMagic, progressVersion, savedProgress);
+		if (!result.isValid())
+			return result;
+
+		if (savedProgress.size() != 1)
+			return std::runtime_error("The save file is corrupt!");
+
+		progress = savedProgress.front();
+
+		// return success
+		return { };
+	}
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		19/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		highscores and the progress of a game, stored in binary save files (see saveFile.h)
+*			the highscore table keeps the best scores sorted, a new score is inserted at its rank and the worst score is dropped
+*			the saved progress is the state at the beginning of a level, the board is rebuilt from the level file
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// bell0bytes util
+#include "expected.h"
+
+// DEFINITIONS //////////////////////////////////////////////////////////////////////////
+namespace game
+{
+	const char highscoreMagic[4] = { 'b', '0', 'h', 's' };
+	const uint16_t highscoreVersion = 1;
+
+	const char progressMagic[4] = { 'b', '0', 's', 'g' };
+	const uint16_t progressVersion = 1;
+
+	#pragma pack(push, 1)
+	struct Score
+	{
+		char name[16] = { };			// the name of the player, UTF-8, zero-terminated
+		uint32_t points = 0;			// the points scored
+		uint32_t rows = 0;				// the number of rows cleared
+		uint32_t level = 0;				// the level reached
+		uint32_t reserved = 0;
+		int64_t date = 0;				// the time the game ended, in seconds since 1970
+	};
+
+	struct Progress
+	{
+		uint32_t level = 0;				// the level to continue with
+		uint32_t points = 0;
+		uint32_t rows = 0;
+		uint32_t reserved = 0;
+		int64_t date = 0;				// the time the game was saved, in seconds since 1970
+	};
+	#pragma pack(pop)
+
+	static_assert(sizeof(Score) == 40 && sizeof(Progress) == 24, "The layout of the save files must not change!");
+
+	// CLASSES //////////////////////////////////////////////////////////////////////////////
+	class HighscoreTable
+	{
+	private:
+		std::vector<Score> scores;		// sorted by points, best first; equal scores keep the order in which they were achieved
+		const unsigned int maxScores;	// the number of scores to keep
+
+	public:
+		HighscoreTable(const unsigned int maxScores = 10);
+
+		// inserts the score at its rank; returns the rank, starting at 0, or -1 if the score is not good enough for the table
+		int insert(const Score& score);
+		bool isHighscore(const uint32_t points) const;	// true iff a score with the given points would enter the table
+		void clear() { scores.clear(); };
+
+		// a missing or corrupt file leaves the table empty
+		util::Expected<void> load(const std::wstring& file);
+		util::Expected<void> save(const std::wstring& file) const;
+
+		const std::vector<Score>& getScores() const { return scores; };
+		const Score* getHighscore() const { return scores.empty() ? nullptr : &scores.front(); };
+	};
+
+	// FUNCTIONS ////////////////////////////////////////////////////////////////////////////
+
+	// the progress of the current game
+	util::Expected<void> saveProgress(const std::wstring& file, const Progress& progress);
+	util::Expected<void> loadProgress(const std::wstring& file, Progress& progress);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		07/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		a log-linear histogram of non-negative integer values, i.e. latencies in nanoseconds (HDR-style)
+*			each power of two is split into 16 linear sub-buckets, thus each recorded value is known up to a relative error of about 6%,
+*			independently of its magnitude; recording a value takes constant time and never allocates
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <cstdint>
+#include <cstring>
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace util
+{
+	class Histogram
+	{
+	private:
+		static const unsigned int subBucketBits = 5;					// values below 2^subBucketBits are counted exactly
+		static const uint64_t subBucketCount = (uint64_t)1 << subBucketBits;
+		static const uint64_t subBucketHalf = subBucketCount >> 1;
+		static const unsigned int maxBits = 42;							// larger values are clamped, i.e. about 73 minutes in nanoseconds
+		static const uint64_t maxValue = ((uint64_t)1 << maxBits) - 1;
+		static const unsigned int nBuckets = (unsigned int)((maxBits - subBucketBits + 1) * subBucketHalf + subBucketHalf);
+
+		uint64_t counts[nBuckets];			// the number of values in each bucket
+		uint64_t totalCount;				// the number of recorded values
+		uint64_t minimum, maximum;			// the exact extreme values
+		double sum;							// the sum of all values, to compute the mean
+
+		static unsigned int highestBit(uint64_t value)
+		{
+			unsigned int bit = 0;
+			while (value >>= 1)
+				bit++;
+			return bit;
+		}
+
+		// the bucket of a value: the first buckets hold the small values, then each power of two has subBucketHalf buckets
+		static unsigned int bucketIndex(const uint64_t value)
+		{
+			if (value < subBucketCount)
+				return (unsigned int)value;
+
+			const unsigned int magnitude = highestBit(value) - subBucketBits + 1;
+			return (unsigned int)(magnitude * subBucketHalf + (value >> magnitude));
+		}
+
+		// the smallest value stored in a bucket
+		static uint64_t bucketValue(const unsigned int index)
+		{
+			if (index < subBucketCount)
+				return index;
+
+			const unsigned int magnitude = (unsigned int)(index / subBucketHalf - 1);
+			return (index % subBucketHalf + subBucketHalf) << magnitude;
+		}
+
+	public:
+		Histogram() { reset(); };
+
+		void reset()
+		{
+			std::memset(counts, 0, sizeof(counts));
+			totalCount = 0;
+			minimum = maximum = 0;
+			sum = 0.0;
+		}
+
+		void record(uint64_t value)
+		{
+			if (value > maxValue)
+				value = maxValue;
+
+			counts[bucketIndex(value)]++;
+			if (totalCount == 0 || value < minimum)
+				minimum = value;
+			if (value > maximum)
+				maximum = value;
+			sum += (double)value;
+			totalCount++;
+		}
+
+		// the smallest value such that the given percentage of all values are less than or equal to it, up to the precision of the buckets
+		uint64_t getValueAtPercentile(const double percentile) const
+		{
+			if (totalCount == 0)
+				return 0;
+
+			const double fraction = percentile < 0.0 ? 0.0 : percentile > 100.0 ? 1.0 : percentile / 100.0;
+			uint64_t rank = (uint64_t)(fraction * (double)totalCount + 0.5);
+			if (rank == 0)
+				rank = 1;
+
+			uint64_t seen = 0;
+			for (unsigned int i = 0; i < nBuckets; i++)
+			{
+				seen += counts[i];
+				if (seen >= rank)
+				{
+					// the highest value of the bucket, but never more than the actual maximum
+					const uint64_t upper = i + 1 < nBuckets ? bucketValue(i + 1) - 1 : maxValue;
+					return upper < maximum ? upper : maximum;
+				}
+			}
+			return maximum;
+		}
+
+		// getters
+		uint64_t getCount() const { return totalCount; };
+		uint64_t getMinimum() const { return minimum; };
+		uint64_t getMaximum() const { return maximum; };
+		double getMean() const { return totalCount ? sum / (double)totalCount : 0.0; };
+	};
+}
@@ -7,16 +7,12 @@
 #include <wbemidl.h>
 #include <oleauto.h>
 
-// Lua and Sol
-#include <sol.hpp>
-#pragma comment(lib, "liblua53.a")
-
 // include class header
 #include "inputHandler.h"
 
 // bell0bytes util
 #include "serviceLocator.h"
-#include "stringConverter.h"
+#include "logFilter.h"
 
 // bell0bytes core
 #include "app.h"
@@ -127,7 +123,7 @@ namespace input
 	}
 
 	// Input Handler
-	InputHandler::InputHandler(core::DirectXApp& dxApp, const HINSTANCE& hInstance, const HWND& appWindow, const std::wstring& keyBindingsFileKeyboard, const std::wstring& keyBindingsFileJoystick, const std::wstring& keyBindingsFileGamepad) : keyBindingsFileKeyboard(keyBindingsFileKeyboard), keyBindingsFileJoystick(keyBindingsFileJoystick), keyBindingsFileGamepad(keyBindingsFileGamepad), dxApp(dxApp), listen(false), nGamepads(0), nPlayers(1)
+	InputHandler::InputHandler(core::DirectXApp& dxApp, const HINSTANCE& hInstance, const HWND& appWindow, const std::wstring& keyBindingsFileKeyboard, const std::wstring& keyBindingsFileJoystick, const std::wstring& keyBindingsFileGamepad) : keyBindingsFileKeyboard(keyBindingsFileKeyboard), keyBindingsFileJoystick(keyBindingsFileJoystick), keyBindingsFileGamepad(keyBindingsFileGamepad), dxApp(dxApp), listen(false), hInstance(hInstance), appWindow(appWindow), dev(nullptr), joystick(nullptr), gamepad(nullptr), nGamepads(0), nPlayers(1)
 	{
 		// read configuration file
 		if (!readConfigFile().wasSuccessful())
@@ -158,10 +154,15 @@ namespace input
 				throw result;
 		}
 
+		// listen to changes of the input configuration
+		dxApp.getFileSystemComponent().getConfigService().addObserver(this, util::Subject::eventBit(fileSystem::ConfigurationParts::InputConfiguration));
+
 		util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("The input handler was successfully initialized.");
 	};
 	InputHandler::~InputHandler()
 	{
+		dxApp.getFileSystemComponent().getConfigService().removeObserver(this);
+
 		// clear active key map
 		activeKeyMap.clear();
 
@@ -232,6 +233,13 @@ namespace input
 	{
 		util::Expected<void> result;
 
+		// while replaying, the recorded input is used instead of the input devices
+		if (dxApp.getEventRecorder().isReplaying())
+		{
+			replayInput();
+			return update();
+		}
+
 		if(activeKeyboard || activeMouse)
 			// get keyboard and mouse state
 			getKeyboardAndMouseState();
@@ -255,10 +263,67 @@ namespace input
 				return std::runtime_error("Critical error: Unable to poll the joystick device!");
 		}
 
+		if (dxApp.getEventRecorder().isRecording())
+			recordInput();
+
 		// update the key maps
 		return update();
 	}
 
+	/////////////////////////////////////////////////////////////////////////////////////////
+	///////////////////////////////// Record and Replay /////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void InputHandler::takeSnapshot(InputSnapshot& snapshot) const
+	{
+		ZeroMemory(&snapshot, sizeof(InputSnapshot));
+
+		for (unsigned int i = 0; i < 256; i++)
+			if (kbm->currentState[i])
+				snapshot.keys[i >> 3] |= (uint8_t)(1 << (i & 7));
+		snapshot.mouseX = kbm->mouseX;
+		snapshot.mouseY = kbm->mouseY;
+
+		if (activeGamepad)
+			snapshot.gamepad = gamepad->currentState;
+		if (activeJoystick)
+			snapshot.joystick = joystick->currentState;
+	}
+
+	void InputHandler::recordInput() const
+	{
+		InputSnapshot snapshot;
+		takeSnapshot(snapshot);
+		dxApp.getEventRecorder().recordInput(&snapshot, sizeof(InputSnapshot));
+	}
+
+	void InputHandler::replayInput()
+	{
+		InputSnapshot snapshot;
+		if (!dxApp.getEventRecorder().replayInput(&snapshot, sizeof(InputSnapshot)))
+			// there is no input for this frame: the devices keep the state of the previous frame
+			takeSnapshot(snapshot);
+
+		// keyboard and mouse
+		kbm->previousState = kbm->currentState;
+		for (unsigned int i = 0; i < 256; i++)
+			kbm->currentState[i] = (snapshot.keys[i >> 3] >> (i & 7)) & 1;
+
+		kbm->mouseX = snapshot.mouseX;
+		kbm->mouseY = snapshot.mouseY;
+		if (activeMouse && kbm->mouseCursor != nullptr)
+			kbm->mouseCursor->setPosition((float)kbm->mouseX, (float)kbm->mouseY);
+
+		// game controllers
+		if (activeGamepad)
+			gamepad->setState(snapshot.gamepad);
+
+		if (activeJoystick)
+		{
+			CopyMemory(&joystick->previousState, &joystick->currentState, sizeof(DIJOYSTATE));
+			CopyMemory(&joystick->currentState, &snapshot.joystick, sizeof(DIJOYSTATE));
+		}
+	}
+
 	/////////////////////////////////////////////////////////////////////////////////////////
 	///////////////////////////////// Update ////////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
@@ -269,18 +334,8 @@ namespace input
 		{
 			if (gamepad->previousState.dwPacketNumber != gamepad->currentState.dwPacketNumber)
 			{
-				// put a message on the event queue for each state on the state queue
-				std::deque<core::GameState*> states;
-				dxApp.getActiveStates(states);
-				for (std::deque<core::GameState*>::reverse_iterator it = states.rbegin(); it != states.rend(); it++)
-				{
-					if (!(*it)->isPaused)
-					{
-						core::DepescheDestination* destination = *it;
-						core::Depesche depesche(*this, *destination, core::DepescheTypes::Gamepad, false);
-						dxApp.addMessage(depesche);
-					}
-				}
+				// publish a message to all subscribers, i.e. the active states
+				dxApp.publishMessage<core::DepescheTypes::Gamepad>(*this);
 			}
 		}
 
@@ -377,18 +432,8 @@ namespace input
 		// if there is an active key map
 		if (!activeKeyMap.empty())
 		{
-			// put a message on the event queue for each state on the state queue
-			std::deque<core::GameState*> states;
-			dxApp.getActiveStates(states);
-			for (std::deque<core::GameState*>::reverse_iterator it = states.rbegin(); it != states.rend(); it++)
-			{
-				if (!(*it)->isPaused)
-				{
-					core::DepescheDestination* destination = *it;
-					core::Depesche depesche(*this, *destination, core::DepescheTypes::ActiveKeyMap, false);
-					dxApp.addMessage(depesche);
-				}
-			}
+			// publish a message to all subscribers, i.e. the active states
+			dxApp.publishMessage<core::DepescheTypes::ActiveKeyMap>(*this);
 		}
 		else
 		{
@@ -411,19 +456,8 @@ namespace input
 				{
 					listen = false;			// stop listening ; produce normal input again
 					
-					// put a message on the event queue for each state on the state queue
-					std::deque<core::GameState*> states;
-					dxApp.getActiveStates(states);
-					for (std::deque<core::GameState*>::reverse_iterator it = states.rbegin(); it != states.rend(); it++)
-					{
-						if (!(*it)->isPaused)
-						{
-							core::DepescheDestination* destination = (*it);
-							bool doListen = true;
-							core::Depesche depesche(*this, *destination, core::DepescheTypes::ActiveKeyMap, &doListen);
-							dxApp.addMessage(depesche);
-						}
-					}
+					// publish a message to all subscribers, i.e. the active states
+					dxApp.publishMessage<core::DepescheTypes::ActiveKeyMap>(*this, core::ActiveKeyMapPayload{ true });
 					return {};				// all done
 				}
 
@@ -621,19 +655,8 @@ namespace input
 									x.keyState = KeyState::JustPressed;
 							}
 
-							// put a message on the event queue for each state on the state queue
-							std::deque<core::GameState*> states;
-							dxApp.getActiveStates(states);
-							for (std::deque<core::GameState*>::reverse_iterator it = states.rbegin(); it != states.rend(); it++)
-							{
-								if (!(*it)->isPaused)
-								{
-									core::DepescheDestination* destination = (*it);
-									bool doListen = true;
-									core::Depesche depesche(*this, *destination, core::DepescheTypes::ActiveKeyMap, &doListen);
-									dxApp.addMessage(depesche);
-								}
-							}
+							// publish a message to all subscribers, i.e. the active states
+							dxApp.publishMessage<core::DepescheTypes::ActiveKeyMap>(*this, core::ActiveKeyMapPayload{ true });
 						}
 					}
 				}
@@ -654,17 +677,7 @@ namespace input
 		if (getKeyState(VK_BACK) == KeyState::JustPressed)
 		{
 			// send a depesche that the user desires to delete a letter or number
-			std::deque<core::GameState*> states;
-			dxApp.getActiveStates(states);
-			for (std::deque<core::GameState*>::reverse_iterator it = states.rbegin(); it != states.rend(); it++)
-			{
-				if (!(*it)->isPaused)
-				{
-					core::DepescheDestination* destination = (*it);
-					core::Depesche depesche(*this, *destination, core::DepescheTypes::TextDelete, nullptr);
-					dxApp.addMessage(depesche);
-				}
-			}
+			dxApp.publishMessage<core::DepescheTypes::TextDelete>(*this);
 		}
 
 		if (getKeyState(VK_RETURN) != KeyState::JustPressed)
@@ -713,17 +726,8 @@ namespace input
 			if (kbm->textInput.str().size() != 0)
 			{
 				// send a depesche that a letter or number was pressed
-				std::deque<core::GameState*> states;
-				dxApp.getActiveStates(states);
-				for (std::deque<core::GameState*>::reverse_iterator it = states.rbegin(); it != states.rend(); it++)
-				{
-					if (!(*it)->isPaused)
-					{
-						core::DepescheDestination* destination = (*it);
-						core::Depesche depesche(*this, *destination, core::DepescheTypes::TextInput, &kbm->textInput);
-						dxApp.addMessage(depesche);
-					}
-				}
+				const std::wstring text = kbm->textInput.str();
+				dxApp.publishMessage<core::DepescheTypes::TextInput>(*this, core::TextInputPayload(text.c_str(), text.size()));
 			}
 			return true;
 		}
@@ -1410,6 +1414,21 @@ namespace input
 			// there was no change
 			return { };
 
+		computeThumbSticks();
+
+		// return success
+		return { };
+	}
+	void Gamepad::setState(const XINPUT_STATE& state)
+	{
+		CopyMemory(&previousState, &currentState, sizeof(XINPUT_STATE));
+		CopyMemory(&currentState, &state, sizeof(XINPUT_STATE));
+
+		if (previousState.dwPacketNumber != currentState.dwPacketNumber)
+			computeThumbSticks();
+	}
+	void Gamepad::computeThumbSticks()
+	{
 		// get axes
 		thumbStickLeft->x = (float)currentState.Gamepad.sThumbLX;
 		thumbStickLeft->y = (float)currentState.Gamepad.sThumbLY;
@@ -1467,9 +1486,6 @@ namespace input
 			if (thumbStickRight->y < -1.0f)
 				thumbStickRight->y = -1.0f;
 		}
-
-		// return success
-		return { };
 	}
 	bool Gamepad::checkConnection()
 	{
@@ -1722,33 +1738,59 @@ namespace input
 	/////////////////////////////////////////////////////////////////////////////////////////
 	util::Expected<void> InputHandler::readConfigFile()
 	{
-		if (dxApp.getFileSystemComponent().hasValidConfigurationFile())
+		// the configuration file was read by the configuration service
+		const fileSystem::Configuration& configuration = dxApp.getFileSystemComponent().getConfigService().getConfiguration();
+		activeJoystick = configuration.enableJoystick;
+		activeGamepad = configuration.enableGamepad;
+		LOG_DEBUG(InputLog, "The game controller states were read from the configuration: joystick: %s --- gamepad: %s.", activeJoystick ? "true" : "false", activeGamepad ? "true" : "false");
+
+		return { };
+	}
+
+	util::Expected<void> InputHandler::onNotify(const int event)
+	{
+		if (event != fileSystem::ConfigurationParts::InputConfiguration)
+			return { };
+
+		const fileSystem::Configuration& configuration = dxApp.getFileSystemComponent().getConfigService().getConfiguration();
+		if (configuration.enableJoystick == activeJoystick && configuration.enableGamepad == activeGamepad)
+			return { };
+
+		// the game controllers are initialized the first time they are enabled
+		activeGamepad = configuration.enableGamepad;
+		if (activeGamepad && gamepad == nullptr && !initializeXInputGamepads())
 		{
-			// configuration file exists, try to read from it
-			std::wstring pathToPrefFile = dxApp.getFileSystemComponent().getPathToConfigurationFiles() + L"\\" + dxApp.getFileSystemComponent().getPrefsFile();
+			LOG_WARNING(InputLog, "The gamepad was enabled, but no gamepad was found.");
+			activeGamepad = false;
+		}
+
+		activeJoystick = configuration.enableJoystick;
+		if (activeJoystick && joystick == nullptr)
+		{
+			if (dev == nullptr && FAILED(DirectInput8Create(hInstance, DIRECTINPUT_VERSION, IID_IDirectInput8, (void **)&dev, NULL)))
+				return std::runtime_error("Critical error: Unable to create the main DirectInput 8 COM object!");
+
+			if (gameControllersDI.empty() && FAILED(dev->EnumDevices(DI8DEVCLASS_GAMECTRL, &staticEnumerateGameControllers, this, DIEDFL_ATTACHEDONLY)))
+				return std::runtime_error("Critical error: Unable to enumerate input devices!");
 
-			try
+			if (!gameControllersDI.empty())
 			{
-				sol::state lua;
-				if (!lua.script_file(util::StringConverter::ws2s(pathToPrefFile)).valid())
-					return std::runtime_error("Unable to open lua file!");
-
-				// read from the configuration file, default to false
-				activeJoystick = lua["config"]["joystick"].get_or(false);
-				activeGamepad = lua["config"]["gamepad"].get_or(false);
-#ifndef NDEBUG
-				std::stringstream res;
-				res << "The game controller states were read from the Lua configuration file: joystick: " << std::boolalpha << activeJoystick << " --- gamepad: " << std::boolalpha << activeGamepad << ".";
-				util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>(res.str());
-#endif
+				currentlyActiveGameController = 0;
+				util::Expected<void> result = initializeGameController(appWindow);
+				if (!result.isValid())
+					return result;
 			}
-			catch (std::exception)
+			else
 			{
-				util::ServiceLocator::getFileLogger()->print<util::SeverityType::warning>("Unable to read configuration file. Joystick and gamepad support disabled!");
+				LOG_WARNING(InputLog, "The joystick was enabled, but no joystick was found.");
+				activeJoystick = false;
 			}
 		}
+		LOG_INFO(InputLog, "The game controller states were changed: joystick: %s --- gamepad: %s.", activeJoystick ? "true" : "false", activeGamepad ? "true" : "false");
 
-		return { };
+		// load the key bindings of the active device, the active key map is rebuilt with the next update
+		resetKeyStates();
+		return loadGameCommands();
 	}
 
 	/////////////////////////////////////////////////////////////////////////////////////////
@@ -1758,7 +1800,7 @@ namespace input
 	{
 		if (depesche.type == core::DepescheTypes::Gamepad)
 		{
-			float vibrationSpeed = *(float *)depesche.message;
+			float vibrationSpeed = depesche.getPayload<core::DepescheTypes::Gamepad>().vibration;
 			gamepad->vibrate(vibrationSpeed, vibrationSpeed);
 		}
 
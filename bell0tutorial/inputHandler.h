@@ -12,6 +12,9 @@
 *			- 13/06/2018: the input handler now sends notifications to the game states
 *			- 23/06/2018: added DirectInput support
 *			- 24/06/2018: added XInput support
+*			- 09/09/2019: the input can be recorded and replayed
+*			- 20/09/2019: frames without recorded input keep the input of the previous frame
+*			- 20/09/2019: changes of the input configuration (joystick and gamepad) are applied at runtime
 *
 * ToDo:		- memory leak in load function (possible bug in boost serialization? singleton never gets deleted?)
 *			- exception when joystick is set to true but no joystick was found
@@ -220,6 +223,8 @@ namespace input
 
 		// acquire the state of the gamepad
 		util::Expected<void> poll();				// get gamepad state
+		void setState(const XINPUT_STATE& state);	// sets the state of the gamepad, i.e. when replaying recorded input
+		void computeThumbSticks();					// computes the thumb stick vectors from the current state
 		bool checkConnection();						// check whether the gamepad for the specified player is still connected
 	
 		// vibrate the gamepad
@@ -247,7 +252,8 @@ namespace input
 
 	// the main input handler class
 	// sends notifications to the various game states on user input
-	class InputHandler : public core::DepescheSender, public core::DepescheDestination
+	// observes the input configuration of the configuration service
+	class InputHandler : public core::DepescheSender, public core::DepescheDestination, public util::Observer
 	{
 	private:
 		/////////////////////////////////////////////////////////////////////////////////////////
@@ -269,6 +275,18 @@ namespace input
 		// on message
 		util::Expected<void> onMessage(const core::Depesche&) override;
 
+		// recording and replaying the input
+		struct InputSnapshot
+		{
+			uint8_t keys[32];										// the keyboard keys and mouse buttons, one bit each
+			LONG mouseX, mouseY;									// the position of the mouse cursor
+			XINPUT_STATE gamepad;									// the state of the active gamepad
+			DIJOYSTATE joystick;									// the state of the active joystick
+		};
+		void takeSnapshot(InputSnapshot& snapshot) const;			// copies the current state of the input devices
+		void recordInput() const;									// records the state of the input devices
+		void replayInput();											// replaces the state of the input devices by the recorded state
+
 		/////////////////////////////////////////////////////////////////////////////////////////
 		////////////////////////////////// CUSTOM KEYCODES //////////////////////////////////////
 		////////////////////////////////////////////////////////////////////////////////////////
@@ -280,6 +298,8 @@ namespace input
 		/////////////////////////////////////////////////////////////////////////////////////////
 		////////////////////////////////// DIRECT INPUT /////////////////////////////////////////
 		/////////////////////////////////////////////////////////////////////////////////////////
+		const HINSTANCE hInstance;							// used to initialize DirectInput once a joystick is enabled
+		const HWND appWindow;
 		IDirectInput8* dev;									// the main DirectInput device
 		std::vector<LPDIRECTINPUTDEVICE8> gameControllersDI;// a vector of all available DirectInput game controllers
 		unsigned int currentlyActiveGameController;			// the index of the currently active joystick
@@ -335,6 +355,9 @@ namespace input
 		// read whether joystick or gamepad input is desired from Lua file
 		util::Expected<void> readConfigFile();
 
+		// enables or disables the joystick and the gamepad when the input configuration changes
+		util::Expected<void> onNotify(const int event) override;
+
 	public:
 		// input devices
 		bool activeMouse;						// true iff mouse input is active
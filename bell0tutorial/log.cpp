@@ -1,19 +1,8 @@
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
 
-// windows
-//#include <Windows.h>
-//#include <KnownFolders.h>
-#include <Shlobj.h>
-#include <Shlwapi.h>
-#include <Pathcch.h>
-
 // bell0bytes
 #include "log.h"
 
-// DLLs /////////////////////////////////////////////////////////////////////////////////
-#pragma comment(lib, "Shlwapi.lib")
-#pragma comment(lib, "Pathcch.lib")
-
 namespace util
 {
 	// FUNCTIONS ////////////////////////////////////////////////////////////////////////
@@ -21,34 +10,108 @@ namespace util
 	/////////////////////////////////////////////////////////////////////////////////////////
 	/////////////////////////////////// File Logger /////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
-	// the openOutputStream function opens a file on the hard drive and sets the output precision
+	// the openOutputStream function opens a file on the hard drive
 	bool FileLogPolicy::openOutputStream(const std::wstring& filename)
 	{
-		// try to open the file
-		outputStream.open(filename.c_str(), std::ios_base::binary | std::ios_base::out);
+		this->filename = filename;
 
-		// debug mode only: make sure the file is opened
+		// try to open the file
+		if (!openFile())
+		{
+			// debug mode only: make sure the file is opened
 #ifndef NDEBUG
-		if (!outputStream.is_open())
 			return false;
 #endif
-		// set output precision
-		outputStream.precision(20);
+		}
 
 		// return success
 		return true;
 	}
 
+	bool FileLogPolicy::openFile()
+	{
+		// the batches are written at once, the stream does not need a buffer of its own
+		outputStream.rdbuf()->pubsetbuf(nullptr, 0);
+		outputStream.open(filename, std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
+
+		fileSize = 0;
+		fileCreationTime = std::chrono::steady_clock::now();
+		return outputStream.is_open();
+	}
+
 	// the closeOutputStream function closes the file on the hard drive
 	void FileLogPolicy::closeOutputStream()
 	{
+		flush();
 		outputStream.close();
 	}
 
-	// the write functions writes a message :)
+	// the write functions add a message to the current batch :)
 	void FileLogPolicy::write(const std::string& msg)
 	{
-		// add the message to the stream
-		outputStream << msg << std::endl;
+		write(msg.data(), msg.size());
+	}
+
+	void FileLogPolicy::write(const char* msg, const size_t length)
+	{
+		// start a new file if the message would not fit into the current one
+		const uint64_t size = fileSize + pendingMessages.size();
+		if (rotation.maxFileSize > 0 && size > 0 && size + length + 2 > rotation.maxFileSize)
+		{
+			writePendingMessages();
+			rotate();
+		}
+
+		pendingMessages.append(msg, length);
+		pendingMessages.append("\r\n", 2);
+	}
+
+	// the records of binary log files are written as they are
+	void FileLogPolicy::writeRaw(const char* data, const size_t length)
+	{
+		pendingMessages.append(data, length);
+	}
+
+	// the messages are written in batches, each batch with a single write, unless the batch has to be split over two files
+	void FileLogPolicy::flush()
+	{
+		if (pendingMessages.empty())
+			return;
+
+		// start a new file if the current one is too old, the size is checked before each message
+		if (fileSize > 0 && rotation.maxFileAge.count() > 0 && std::chrono::steady_clock::now() - fileCreationTime >= rotation.maxFileAge)
+			rotate();
+
+		writePendingMessages();
+		outputStream.flush();
+	}
+
+	void FileLogPolicy::writePendingMessages()
+	{
+		if (pendingMessages.empty())
+			return;
+
+		outputStream.write(pendingMessages.data(), pendingMessages.size());
+		fileSize += pendingMessages.size();
+		pendingMessages.clear();
+	}
+
+	// the current file becomes name.1, name.1 becomes name.2, ..., the oldest file is overwritten
+	void FileLogPolicy::rotate()
+	{
+		outputStream.close();
+
+		std::error_code error;
+		for (unsigned int i = rotation.maxFiles; i > 0; i--)
+		{
+			std::filesystem::path from = filename;
+			if (i > 1)
+				from += L"." + std::to_wstring(i - 1);
+			std::filesystem::path to = filename;
+			to += L"." + std::to_wstring(i);
+			std::filesystem::rename(from, to, error);
+		}
+
+		openFile();
 	}
-}
\ No newline at end of file
+}
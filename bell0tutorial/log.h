@@ -8,24 +8,38 @@
 *
 * History:	- 01/07/2017: fixed a memory leak
 *			- 02/07/2017: added overloaded print function to take a string
+*			- 10/09/2019: each thread writes to its own lock-free buffer, the daemon collects the messages of all threads;
+*						  thread names are thread local and the daemon wakes up early when a buffer fills up
+*			- 11/09/2019: deferred formatting: printFormatted only writes the id of the format string and the raw arguments,
+*						  the daemon formats the message, or writes it to a binary log file to be decoded offline
+*			- 12/09/2019: portable file policy: each batch is written at once, text files can be rotated by size or age;
+*						  the timestamps are cached once per second
+*			- 20/09/2019: the line numbers are the sequence numbers of the messages, the headers are formatted by the daemon;
+*						  each message ends with a line break; the size of the log file is checked before each message
 *
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
 
-// windows includes
-#include <Windows.h>						// standard Windows stuff
-
 // c++ includes
-#include <atomic>							// atomic objects (no data races) 
+#include <atomic>							// atomic objects (no data races)
 #include <thread>							// individual threats
 #include <mutex>							// lockable objects
+#include <condition_variable>				// wake up the daemon
+#include <chrono>							// flush intervals
+#include <algorithm>						// sort the messages of all threads
 #include <iostream>							// input and output streams
 #include <sstream>							// string streams
 #include <fstream>							// file streams
+#include <filesystem>						// rotate the log files
 #include <vector>							// vector containers
-#include <map>								// map containers
-#include <xatomic.h>
+#include <memory>							// unique pointers to the thread buffers
+#include <cstdio>							// format the message headers
+#include <cstring>							// copy the messages
+
+// bell0bytes util
+#include "spscRingBuffer.h"					// lock-free buffer of each thread
+#include "logFormat.h"						// deferred formatting and binary log files
 
 
 namespace util
@@ -36,6 +50,15 @@ namespace util
 	////////////////////////////// LOG POLICIES /////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////
 
+	// the rotation of log files: once the current file would grow larger than the maximal size, or is older than the maximal age,
+	// it is renamed to name.1 (name.1 to name.2, ...) and a new file is started; a value of zero disables the limit
+	struct LogRotation
+	{
+		uint64_t maxFileSize = 0;						// in bytes
+		std::chrono::seconds maxFileAge{ 0 };
+		unsigned int maxFiles = 1;						// the number of old files to keep
+	};
+
 	// virtual abstract class - interface to open and close streams (and to write to them)
 	class LogPolicyInterface
 	{
@@ -44,35 +67,51 @@ namespace util
 
 		virtual bool openOutputStream(const std::wstring& name) = 0;
 		virtual void closeOutputStream() = 0;
+		virtual void setRotation(const LogRotation& rotation) = 0;			// called before the stream is opened
 		virtual void write(const std::string& msg) = 0;
+		virtual void write(const char* msg, const size_t length) = 0;
+		virtual void writeRaw(const char* data, const size_t length) = 0;	// writes the data as is, i.e. to binary log files
+		virtual void flush() = 0;					// called after each batch of messages
 	};
 
 	// implementation of a policy to write to a file on the hard drive
+	// the messages of a batch are collected in memory and written to the file at once, when the batch is flushed
 	class FileLogPolicy : public LogPolicyInterface
 	{
 	private:
 		std::ofstream outputStream;
+		std::filesystem::path filename;				// the name of the current file
+		std::string pendingMessages;				// the messages of the current batch
+		LogRotation rotation;						// when to start a new file
+		uint64_t fileSize;							// the number of bytes written to the current file
+		std::chrono::steady_clock::time_point fileCreationTime;
+
+		bool openFile();
+		void rotate();
+		void writePendingMessages();				// writes the messages of the current batch to the current file
 
 	public:
-		FileLogPolicy() : outputStream() {};
+		FileLogPolicy() : outputStream(), filename(), pendingMessages(), rotation(), fileSize(0), fileCreationTime() {};
 		~FileLogPolicy() { };
 
 		bool openOutputStream(const std::wstring& filename) override;
 		void closeOutputStream() override;
+		void setRotation(const LogRotation& rotation) override { this->rotation = rotation; };
 		void write(const std::string& msg) override;
+		void write(const char* msg, const size_t length) override;
+		void writeRaw(const char* data, const size_t length) override;
+		void flush() override;
 	};
 
 	/////////////////////////////////////////////////////////////////////////////////////
-	////////////////////////////// MESSAGE TYPES ////////////////////////////////////////
+	////////////////////////////// FILE FORMATS /////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////
 
-	enum SeverityType
+	// text files are human-readable, binary files store the raw arguments of the formatted messages and must be decoded (see logFormat.h)
+	enum LogFileFormat
 	{
-		info = 0,
-		debug,
-		warning,
-		error,
-		config
+		textFile = 0,
+		binaryFile
 	};
 
 	/////////////////////////////////////////////////////////////////////////////////////
@@ -83,25 +122,40 @@ namespace util
 	template<typename LogPolicy>
 	class Logger;
 
+	// each logger has a unique id, such that the threads can cache their buffer of the logger they used last
+	inline uint64_t createLoggerID()
+	{
+		static std::atomic<uint64_t> nextLoggerID(1);
+		return nextLoggerID.fetch_add(1, std::memory_order_relaxed);
+	}
+
 	// create the actual logging daemon
 	template<typename LogPolicy>
 	void loggingDaemon(Logger<LogPolicy>* logger)
 	{
-		// dump log data if present
-		std::unique_lock<std::timed_mutex> lock(logger->writeMutex, std::defer_lock);
-		do
+		// the daemon sleeps for the flush interval, or until a buffer reaches its high-water mark;
+		// the interval shrinks while there is a lot to write and grows back while the threads are quiet
+		std::chrono::milliseconds interval = Logger<LogPolicy>::maxFlushInterval;
+		bool running = true;
+		while (running)
 		{
-			std::this_thread::sleep_for(std::chrono::milliseconds{ 50 });
-			if (logger->logBuffer.size())
 			{
-				if (!lock.try_lock_for(std::chrono::milliseconds{ 50 }))
-					continue;
-				for (auto& x : logger->logBuffer)
-					logger->policy.write(x);
-				logger->logBuffer.clear();
-				lock.unlock();
+				std::unique_lock<std::mutex> lock(logger->daemonMutex);
+				logger->daemonWakeUp.wait_for(lock, interval, [logger] { return logger->flushRequested.load(std::memory_order_relaxed) || !logger->isStillRunning.load(std::memory_order_relaxed); });
 			}
-		} while (logger->isStillRunning.test_and_set() || logger->logBuffer.size());
+			logger->flushRequested.store(false, std::memory_order_relaxed);
+
+			// once the logger is shut down, the buffers are flushed a last time
+			running = logger->isStillRunning.load(std::memory_order_acquire);
+			const size_t nMessages = logger->flush(!running);
+
+			if (nMessages >= Logger<LogPolicy>::busyFlushSize)
+				interval = Logger<LogPolicy>::minFlushInterval;
+			else if (interval * 2 < Logger<LogPolicy>::maxFlushInterval)
+				interval *= 2;
+			else
+				interval = Logger<LogPolicy>::maxFlushInterval;
+		}
 	}
 
 	// the actual logger class to be instantiated with a specific log policy
@@ -109,17 +163,75 @@ namespace util
 	class Logger
 	{
 	private:
-		unsigned int logLineNumber;								// used to save the current line number
-		std::map<std::thread::id, std::string> threadName;		// defines a human-readable name for each thread
+		// each thread writes its messages to its own buffer, only the daemon reads them
+		// each record is stored as its sequence number, to restore the order of the messages of all threads, followed by its kind and its data;
+		// the sequence number of a message is also its line number, records without a line number share the number of the next message
+		struct ThreadBuffer
+		{
+			const std::thread::id id;							// the thread
+			SPSCRingBuffer<64 * 1024> messages;					// the messages of the thread
+
+			ThreadBuffer(const std::thread::id id) : id(id) {};
+		};
+
+		// the kinds of records in the buffers of the threads
+		//		- Text:			the severity, the time and the message
+		//		- Formatted:	the id of the format string, the severity, the time and the encoded arguments
+		//		- ThreadName:	the new name of the thread
+		enum RecordKinds : uint8_t { Text = 1, Formatted, ThreadName };
+		static const size_t recordHeaderSize = sizeof(uint64_t) + sizeof(uint8_t);
+		static const size_t textHeaderSize = sizeof(uint8_t) + sizeof(int64_t);
+		static const size_t formattedHeaderSize = sizeof(uint32_t) + sizeof(uint8_t) + sizeof(int64_t);
+
+		// a message collected by the daemon
+		struct CollectedMessage
+		{
+			uint64_t sequence;									// the order of the message
+			size_t offset, length;								// the text of the message in the batch
+			bool numbered;										// false iff the message shares its number with the next message
+			bool operator < (const CollectedMessage& other) const { return sequence < other.sequence; };
+		};
+
+		static constexpr std::chrono::milliseconds minFlushInterval{ 5 };	// the flush interval of the daemon while the threads log a lot
+		static constexpr std::chrono::milliseconds maxFlushInterval{ 50 };	// the flush interval of the daemon while the threads are quiet
+		static const size_t busyFlushSize = 64;					// the daemon flushes more often if a flush wrote at least this many messages
+		static const size_t highWaterMark = 16 * 1024;			// the daemon is woken up once a buffer holds this many bytes
+
+		const uint64_t loggerID;								// the unique id of the logger
+		const LogFileFormat fileFormat;							// text or binary
+		std::atomic<uint64_t> sequence;							// the order, and the line numbers, of the messages of all threads
 		LogPolicy policy;										// the log policy (i.e. write to file, ...)
-		std::timed_mutex writeMutex;							// mutual exclusive writer
-		std::vector<std::string> logBuffer;						// the content to log
+
+		std::mutex registryMutex;								// protects the list of buffers, only locked when a thread logs for the first time and by the daemon
+		std::vector<std::unique_ptr<ThreadBuffer> > threadBuffers;	// the buffers of all threads that used this logger
+
+		// the daemon
 		std::thread daemon;										// the actual logging daemon
-		std::atomic_flag isStillRunning = ATOMIC_FLAG_INIT;		// lock-free boolean to check whether our daemon is still running or not
+		std::mutex daemonMutex;									// used to let the daemon sleep
+		std::condition_variable daemonWakeUp;					// wakes the daemon up before its flush interval elapsed
+		std::atomic<bool> flushRequested;						// true iff a buffer reached its high-water mark
+		std::atomic<bool> isStillRunning;						// false once the logger is shut down
+		std::string batch;										// the text, or the binary records, of the collected messages (daemon only)
+		std::vector<CollectedMessage> collectedMessages;		// the collected messages (daemon only)
+		std::vector<std::string> threadNames;					// the names of the threads, by the index of their buffer (daemon only)
+		std::string scratch;									// used to build binary records (daemon only)
+		uint32_t formatsWritten;								// the number of format strings written to the binary log file (daemon only)
+		uint64_t nextLineNumber;								// the number of the next message to be written (daemon only)
+		std::string heldBackBatch;								// the messages that were collected before a message with a lower number was published (daemon only)
+		std::vector<CollectedMessage> heldBackMessages;
+
+		ThreadBuffer& getThreadBuffer();						// the buffer of the calling thread, created on first use
+		void requestFlush();									// wakes up the daemon
+		char* reserve(ThreadBuffer& buffer, const RecordKinds kind, const size_t size, const bool numbered);	// reserves a record, waits for the daemon if the buffer is full, returns the position of the data
+		void publish(ThreadBuffer& buffer);						// publishes the reserved record
+		void write(const SeverityType severity, const char* const message, const size_t length);	// writes the message to the buffer of the thread
+		void collect(const size_t thread, const char* const record, const size_t size);	// adds a record to the batch (daemon only)
+		size_t flush(const bool all);							// writes the messages of all threads to the policy (daemon only), returns the number of messages
 
 	public:
 		// constructor and destructor
-		Logger(const std::wstring& name);
+		// binary log files are not rotated, as each file must start with the format strings it uses
+		Logger(const std::wstring& name, const LogFileFormat fileFormat = LogFileFormat::textFile, const LogRotation& rotation = LogRotation());
 		~Logger();
 
 		void setThreadName(const std::string& name);			// sets human-readable name for current thread
@@ -129,16 +241,36 @@ namespace util
 		template<SeverityType severity>
 		void print(std::string msg);
 
+		// prints a message with deferred formatting: the calling thread only stores the id of the format string and the arguments
+		// usage: printFormatted<SeverityType::info>(LOG_FORMAT("Loaded %s in %.2f ms."), name, time);
+		template<SeverityType severity, class... Arguments>
+		void printFormatted(const LogFormat& format, const Arguments&... arguments);
+
 		template<typename Policy>
 		friend void loggingDaemon(Logger<Policy>* logger);		// the actual logger daemon
 	};
 
 	template<typename LogPolicy>
-	Logger<LogPolicy>::Logger(const std::wstring& name) : logLineNumber(0), threadName(), policy(), writeMutex(), logBuffer()
+	constexpr std::chrono::milliseconds Logger<LogPolicy>::minFlushInterval;
+	template<typename LogPolicy>
+	constexpr std::chrono::milliseconds Logger<LogPolicy>::maxFlushInterval;
+
+	template<typename LogPolicy>
+	Logger<LogPolicy>::Logger(const std::wstring& name, const LogFileFormat fileFormat, const LogRotation& rotation) : loggerID(createLoggerID()), fileFormat(fileFormat), sequence(0), policy(), flushRequested(false), isStillRunning(false), formatsWritten(0), nextLineNumber(0)
 	{
+		if (fileFormat == LogFileFormat::textFile)
+			policy.setRotation(rotation);
+
 		if (policy.openOutputStream(name))
 		{
-			isStillRunning.test_and_set();						// mark the logging daemon as running
+			// binary log files start with a magic number and their version
+			if (fileFormat == LogFileFormat::binaryFile)
+			{
+				policy.writeRaw(binaryLog::magic, sizeof(binaryLog::magic));
+				policy.writeRaw(reinterpret_cast<const char*>(&binaryLog::version), sizeof(uint32_t));
+			}
+
+			isStillRunning.store(true);							// mark the logging daemon as running
 			daemon = std::move(std::thread{ loggingDaemon<LogPolicy>, this });
 		}
 		else
@@ -153,80 +285,315 @@ namespace util
 		util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("The file logger was destroyed.");
 #endif
 		// terminate the daemon by clearing the still running flag and letting it join to the main thread
-		isStillRunning.clear();
+		isStillRunning.store(false, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> lock(daemonMutex);
+		}
+		daemonWakeUp.notify_one();
 		daemon.join();
 
-		// clear the thread name map
-		threadName.clear();
-		std::map<std::thread::id, std::string>().swap(threadName);
-
-		// clear the log vector
-		logBuffer.clear();
-		logBuffer.shrink_to_fit();
+		// free the thread buffers
+		threadBuffers.clear();
 
 		// close the output stream
 		policy.closeOutputStream();
 	}
 
+	/////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// THREADS //////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////
+	template<typename LogPolicy>
+	typename Logger<LogPolicy>::ThreadBuffer& Logger<LogPolicy>::getThreadBuffer()
+	{
+		// each thread remembers its buffer of the logger it used last, thus there is no lookup for the common case
+		thread_local uint64_t cachedLoggerID = 0;
+		thread_local ThreadBuffer* cachedBuffer = nullptr;
+		if (cachedLoggerID == loggerID)
+			return *cachedBuffer;
+
+		const std::thread::id id = std::this_thread::get_id();
+		std::lock_guard<std::mutex> lock(registryMutex);
+
+		ThreadBuffer* buffer = nullptr;
+		for (const std::unique_ptr<ThreadBuffer>& threadBuffer : threadBuffers)
+			if (threadBuffer->id == id)
+				buffer = threadBuffer.get();
+
+		if (buffer == nullptr)
+		{
+			threadBuffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer(id)));
+			buffer = threadBuffers.back().get();
+		}
+
+		cachedLoggerID = loggerID;
+		cachedBuffer = buffer;
+		return *buffer;
+	}
+
 	template<typename LogPolicy>
 	void Logger<LogPolicy>::setThreadName(const std::string& name)
 	{
-		threadName[std::this_thread::get_id()] = name;
+		ThreadBuffer& buffer = getThreadBuffer();
+
+		// the daemon learns the name from the buffer of the thread
+		const size_t maxLength = buffer.messages.getMaxRecordSize() - recordHeaderSize;
+		const size_t length = name.size() > maxLength ? maxLength : name.size();
+		char* const data = reserve(buffer, RecordKinds::ThreadName, length, false);
+		std::memcpy(data, name.c_str(), length);
+		publish(buffer);
+	}
+
+	template<typename LogPolicy>
+	void Logger<LogPolicy>::requestFlush()
+	{
+		// only the first thread to request a flush has to wake up the daemon
+		if (!flushRequested.exchange(true, std::memory_order_relaxed))
+			daemonWakeUp.notify_one();
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// PRINT ////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////
+	template<typename LogPolicy>
+	char* Logger<LogPolicy>::reserve(ThreadBuffer& buffer, const RecordKinds kind, const size_t size, const bool numbered)
+	{
+		// reserve space in the buffer of the thread, if the buffer is full, wait for the daemon
+		char* record;
+		while ((record = buffer.messages.reserve(recordHeaderSize + size)) == nullptr)
+		{
+			requestFlush();
+			std::this_thread::yield();
+		}
+
+		const uint64_t number = numbered ? sequence.fetch_add(1, std::memory_order_relaxed) : sequence.load(std::memory_order_relaxed);
+		std::memcpy(record, &number, sizeof(uint64_t));
+		record[sizeof(uint64_t)] = (char)kind;
+		return record + recordHeaderSize;
+	}
+
+	template<typename LogPolicy>
+	void Logger<LogPolicy>::publish(ThreadBuffer& buffer)
+	{
+		buffer.messages.commit();
+
+		if (buffer.messages.size() >= highWaterMark)
+			requestFlush();
+	}
+
+	template<typename LogPolicy>
+	void Logger<LogPolicy>::write(const SeverityType severity, const char* const message, size_t length)
+	{
+		ThreadBuffer& buffer = getThreadBuffer();
+		const uint8_t severity8 = (uint8_t)severity;
+		const int64_t time = getLogTime();
+
+		// messages that do not fit into the buffer are truncated
+		const size_t maxLength = buffer.messages.getMaxRecordSize() - recordHeaderSize - textHeaderSize;
+		if (length > maxLength)
+			length = maxLength;
+
+		// write and publish the message, the daemon writes the header: all severity types but the config type have a line number
+		char* const data = reserve(buffer, RecordKinds::Text, textHeaderSize + length, severity != SeverityType::config);
+		std::memcpy(data, &severity8, sizeof(uint8_t));
+		std::memcpy(data + 1, &time, sizeof(int64_t));
+		std::memcpy(data + textHeaderSize, message, length);
+		publish(buffer);
 	}
 
 	template<typename LogPolicy>
 	template<SeverityType severity>
 	void Logger<LogPolicy>::print(std::stringstream stream)
 	{
-		std::stringstream logStream;
-#pragma warning (push)
-#pragma warning (disable: 4127)		// disable constant if expr warning
-		// all severity types but the config type allow custom formatting
-		if(!(severity == SeverityType::config))		// todo: eliminate this warning with if constexpr once version 15.3 of Visual Studio with C++-17 support is available
-#pragma warning (pop)
+		const std::string message = stream.str();
+		write(severity, message.c_str(), message.size());
+	}
+
+	template<typename LogPolicy>
+	template<SeverityType severity>
+	void Logger<LogPolicy>::print(std::string msg)
+	{
+		write(severity, msg.c_str(), msg.size());
+	}
+
+	template<typename LogPolicy>
+	template<SeverityType severity, class... Arguments>
+	void Logger<LogPolicy>::printFormatted(const LogFormat& format, const Arguments&... arguments)
+	{
+		const size_t argumentsSize = logArguments::totalSize(arguments...);
+
+		// messages that do not fit into the buffer are formatted by the calling thread
+		if (recordHeaderSize + formattedHeaderSize + argumentsSize > SPSCRingBuffer<64 * 1024>::getMaxRecordSize())
 		{
-			// get time
-			SYSTEMTIME localTime;
-			GetLocalTime(&localTime);
+			std::string encodedArguments(argumentsSize, '\0');
+			logArguments::writeAll(&encodedArguments[0], arguments...);
+			std::string message;
+			formatLogArguments(message, format.getFormat(), encodedArguments.data(), encodedArguments.size());
+			write(severity, message.c_str(), message.size());
+			return;
+		}
+
+		ThreadBuffer& buffer = getThreadBuffer();
+		const uint32_t formatID = format.getID();
+		const uint8_t severity8 = (uint8_t)severity;
+		const int64_t time = getLogTime();
+
+		// write and publish the raw message
+		char* const data = reserve(buffer, RecordKinds::Formatted, formattedHeaderSize + argumentsSize, severity != SeverityType::config);
+		std::memcpy(data, &formatID, sizeof(uint32_t));
+		std::memcpy(data + 4, &severity8, sizeof(uint8_t));
+		std::memcpy(data + 5, &time, sizeof(int64_t));
+		logArguments::writeAll(data + formattedHeaderSize, arguments...);
+		publish(buffer);
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// FLUSH ////////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////
+	template<typename LogPolicy>
+	void Logger<LogPolicy>::collect(const size_t thread, const char* const record, const size_t size)
+	{
+		CollectedMessage message;
+		std::memcpy(&message.sequence, record, sizeof(uint64_t));
+		message.offset = batch.size();
 
-			// header: line number and date (x: xx/xx/xxxx xx:xx:xx)
-			if (logLineNumber != 0)
-				logStream << "\r\n";
-			logStream << logLineNumber++ << ": " << localTime.wDay << "/" << localTime.wMonth << "/" << localTime.wYear << " " << localTime.wHour << ":" << localTime.wMinute << ":" << localTime.wSecond << "\t";
+		const RecordKinds kind = (RecordKinds)record[sizeof(uint64_t)];
+		const char* const data = record + recordHeaderSize;
+		const size_t length = size - recordHeaderSize;
+		const bool binary = fileFormat == LogFileFormat::binaryFile;
 
-			// write down warning level
-			switch (severity)
+		switch (kind)
+		{
+		case RecordKinds::Text:
+		{
+			uint8_t severity;
+			int64_t time;
+			std::memcpy(&severity, data, sizeof(uint8_t));
+			std::memcpy(&time, data + 1, sizeof(int64_t));
+
+			// header: line number and date (x: xx/xx/xxxx xx:xx:xx), warning level and thread name
+			std::string& text = binary ? scratch : batch;
+			if (binary)
+				scratch.clear();
+			formatLogHeader(text, message.sequence, time, (SeverityType)severity, threadNames[thread]);
+			message.numbered = (SeverityType)severity != SeverityType::config;
+			text.append(data + textHeaderSize, length - textHeaderSize);
+			if (binary)
+				binaryLog::appendRecord(batch, binaryLog::RecordKinds::Text, scratch.data(), scratch.size());
+			break;
+		}
+
+		case RecordKinds::ThreadName:
+		{
+			threadNames[thread].assign(data, length);
+			if (!binary)
+				return;
+			message.numbered = false;
+
+			const uint32_t thread32 = (uint32_t)thread;
+			scratch.assign(reinterpret_cast<const char*>(&thread32), sizeof(uint32_t));
+			scratch.append(data, length);
+			binaryLog::appendRecord(batch, binaryLog::RecordKinds::ThreadName, scratch.data(), scratch.size());
+			break;
+		}
+
+		case RecordKinds::Formatted:
+		{
+			binaryLog::MessageHeader header;
+			header.thread = (uint32_t)thread;
+			header.lineNumber = message.sequence;
+			std::memcpy(&header.format, data, sizeof(uint32_t));
+			std::memcpy(&header.severity, data + 4, sizeof(uint8_t));
+			std::memcpy(&header.time, data + 5, sizeof(int64_t));
+			message.numbered = (SeverityType)header.severity != SeverityType::config;
+			const char* const arguments = data + formattedHeaderSize;
+			const size_t argumentsLength = length - formattedHeaderSize;
+
+			if (binary)
+			{
+				// the decoder formats the message
+				scratch.clear();
+				binaryLog::appendMessageHeader(scratch, header);
+				scratch.append(arguments, argumentsLength);
+				binaryLog::appendRecord(batch, binaryLog::RecordKinds::Message, scratch.data(), scratch.size());
+			}
+			else
 			{
-			case SeverityType::info:
-				logStream << "INFO:    ";
-				break;
-			case SeverityType::debug:
-				logStream << "DEBUG:   ";
-				break;
-			case SeverityType::warning:
-				logStream << "WARNING: ";
-				break;
-			case SeverityType::error:
-				logStream << "ERROR:   ";
-				break;
-			};
-
-			// write thread name
-			logStream << threadName[std::this_thread::get_id()] << ":\t";
+				formatLogHeader(batch, header.lineNumber, header.time, (SeverityType)header.severity, threadNames[thread]);
+				formatLogArguments(batch, getLogFormat(header.format), arguments, argumentsLength);
+			}
+			break;
+		}
+
+		default:
+			return;
 		}
-		
-		// write the actual message
-		logStream << stream.str();
-		std::lock_guard<std::timed_mutex> lock(writeMutex);
-		logBuffer.push_back(logStream.str());
+
+		message.length = batch.size() - message.offset;
+		collectedMessages.push_back(message);
 	}
 
 	template<typename LogPolicy>
-	template<SeverityType severity>
-	void Logger<LogPolicy>::print(std::string msg)
+	size_t Logger<LogPolicy>::flush(const bool all)
 	{
-		std::stringstream stream;
-		stream << msg.c_str();
-		this->print<severity>(std::stringstream(stream.str()));
+		// the messages that were held back by the last flush come first
+		batch.swap(heldBackBatch);
+		collectedMessages.swap(heldBackMessages);
+		heldBackBatch.clear();
+		heldBackMessages.clear();
+
+		// collect the messages of all threads
+		{
+			std::lock_guard<std::mutex> lock(registryMutex);
+			if (threadNames.size() < threadBuffers.size())
+				threadNames.resize(threadBuffers.size());
+			for (size_t i = 0; i < threadBuffers.size(); i++)
+				threadBuffers[i]->messages.consume([this, i](const char* record, const size_t size) { collect(i, record, size); });
+		}
+
+		if (collectedMessages.empty())
+			return 0;
+
+		// restore the order of the messages, the records of a thread that share a number keep their order
+		std::stable_sort(collectedMessages.begin(), collectedMessages.end());
+
+		// a thread might not have published its message yet, while other threads already published messages with higher numbers:
+		// the messages after the missing number are held back until the next flush, thus the line numbers in the file never decrease
+		size_t nMessages = all ? collectedMessages.size() : 0;
+		for (; nMessages < collectedMessages.size() && collectedMessages[nMessages].sequence <= nextLineNumber; nMessages++)
+			if (collectedMessages[nMessages].numbered)
+				nextLineNumber = collectedMessages[nMessages].sequence + 1;
+
+		for (size_t i = nMessages; i < collectedMessages.size(); i++)
+		{
+			CollectedMessage message = collectedMessages[i];
+			heldBackBatch.append(batch.data() + message.offset, message.length);
+			message.offset = heldBackBatch.size() - message.length;
+			heldBackMessages.push_back(message);
+		}
+
+		if (fileFormat == LogFileFormat::binaryFile)
+		{
+			// the format strings are written before the first message that uses them
+			const uint32_t nFormats = getNumberOfLogFormats();
+			scratch.clear();
+			for (; formatsWritten < nFormats; formatsWritten++)
+			{
+				const char* const format = getLogFormat(formatsWritten);
+				std::string record(reinterpret_cast<const char*>(&formatsWritten), sizeof(uint32_t));
+				record.append(format);
+				binaryLog::appendRecord(scratch, binaryLog::RecordKinds::Format, record.data(), record.size());
+			}
+			if (!scratch.empty())
+				policy.writeRaw(scratch.data(), scratch.size());
+
+			for (size_t i = 0; i < nMessages; i++)
+				policy.writeRaw(batch.data() + collectedMessages[i].offset, collectedMessages[i].length);
+		}
+		else
+			for (size_t i = 0; i < nMessages; i++)
+				policy.write(batch.data() + collectedMessages[i].offset, collectedMessages[i].length);
+		policy.flush();
+
+		return nMessages;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		12/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		filters log messages by their severity and their category (the module that logs them)
+*				- at compile time: messages below LOG_MIN_SEVERITY, or of a category that is not in LOG_CATEGORIES, are compiled away,
+*				  including the evaluation of their arguments
+*				- at run time: each category has a minimum severity, which can only filter the messages that were compiled in
+*			by default, debug messages are only compiled into debug builds
+*			usage: LOG_DEBUG(GraphicsLog, "The window was resized to %d x %d.", width, height);
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <atomic>
+
+// bell0bytes util
+#include "serviceLocator.h"
+
+// DEFINITIONS //////////////////////////////////////////////////////////////////////////
+
+// the minimum severity compiled in: debug, info, warning or error; config messages are always compiled in
+#ifndef LOG_MIN_SEVERITY
+#ifndef NDEBUG
+#define LOG_MIN_SEVERITY debug
+#else
+#define LOG_MIN_SEVERITY info
+#endif
+#endif
+
+// the categories compiled in, one bit per category
+#ifndef LOG_CATEGORIES
+#define LOG_CATEGORIES 0xFFFFFFFF
+#endif
+
+// log a message with deferred formatting (see logFormat.h), if the severity and the category are enabled
+#define LOG_MESSAGE(severity, category, format, ...) \
+	do \
+	{ \
+		if constexpr (util::isLogCompiledIn(util::SeverityType::severity, util::LogCategories::category)) \
+			if (util::isLogEnabled(util::SeverityType::severity, util::LogCategories::category)) \
+				util::ServiceLocator::getFileLogger()->printFormatted<util::SeverityType::severity>(LOG_FORMAT(format), ##__VA_ARGS__); \
+	} while (0)
+
+#define LOG_DEBUG(category, format, ...) LOG_MESSAGE(debug, category, format, ##__VA_ARGS__)
+#define LOG_INFO(category, format, ...) LOG_MESSAGE(info, category, format, ##__VA_ARGS__)
+#define LOG_WARNING(category, format, ...) LOG_MESSAGE(warning, category, format, ##__VA_ARGS__)
+#define LOG_ERROR(category, format, ...) LOG_MESSAGE(error, category, format, ##__VA_ARGS__)
+
+namespace util
+{
+	/////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// CATEGORIES ///////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////
+
+	enum LogCategories { GeneralLog, CoreLog, GraphicsLog, AudioLog, InputLog, FileSystemLog, PhysicsLog, nLogCategories };
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// FILTERS //////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////
+
+	// the severities ordered by importance: debug messages are less important than info messages
+	constexpr int getSeverityRank(const SeverityType severity)
+	{
+		return severity == SeverityType::debug ? 0 : severity == SeverityType::info ? 1 : (int)severity;
+	}
+
+	// compile time
+	constexpr bool isLogCompiledIn(const SeverityType severity, const LogCategories category)
+	{
+		return severity == SeverityType::config || (getSeverityRank(severity) >= getSeverityRank(SeverityType::LOG_MIN_SEVERITY) && ((LOG_CATEGORIES >> category) & 1) != 0);
+	}
+
+	// run time: the minimum rank of each category; zero, the default, lets all messages that were compiled in pass
+	inline std::atomic<int>* getLogLevels()
+	{
+		static std::atomic<int> logLevels[nLogCategories];
+		return logLevels;
+	}
+
+	inline bool isLogEnabled(const SeverityType severity, const LogCategories category)
+	{
+		return getSeverityRank(severity) >= getLogLevels()[category].load(std::memory_order_relaxed);
+	}
+
+	// sets the minimum severity of a category, or of all categories (thread-safe)
+	inline void setLogLevel(const LogCategories category, const SeverityType minimumSeverity)
+	{
+		getLogLevels()[category].store(getSeverityRank(minimumSeverity), std::memory_order_relaxed);
+	}
+
+	inline void setLogLevel(const SeverityType minimumSeverity)
+	{
+		for (int category = 0; category < nLogCategories; category++)
+			setLogLevel((LogCategories)category, minimumSeverity);
+	}
+}
@@ -0,0 +1,444 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// the header
+#include "logFormat.h"
+
+// c++ includes
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <cstdarg>
+#include <iterator>
+
+namespace util
+{
+	namespace
+	{
+		// the registered format strings; they are never destroyed, as loggers may still be flushing during the destruction of static objects
+		std::mutex& getRegistryMutex()
+		{
+			static std::mutex* const registryMutex = new std::mutex();
+			return *registryMutex;
+		}
+
+		std::vector<const char*>& getRegistry()
+		{
+			static std::vector<const char*>* const registry = new std::vector<const char*>();
+			return *registry;
+		}
+
+		// appends a printf formatted string
+		void appendFormatted(std::string& out, const char* const format, ...)
+		{
+			char buffer[128];
+			va_list arguments;
+			va_start(arguments, format);
+			const int length = vsnprintf(buffer, sizeof(buffer), format, arguments);
+			va_end(arguments);
+
+			if (length < 0)
+				return;
+			if (length < (int)sizeof(buffer))
+			{
+				out.append(buffer, length);
+				return;
+			}
+
+			// the buffer was too small
+			const size_t offset = out.size();
+			out.resize(offset + length + 1);
+			va_start(arguments, format);
+			vsnprintf(&out[offset], length + 1, format, arguments);
+			va_end(arguments);
+			out.resize(offset + length);
+		}
+
+		// an encoded argument
+		struct Argument
+		{
+			logArguments::Tags tag;
+			int64_t signedValue;
+			uint64_t unsignedValue;
+			double floatingValue;
+			std::string string;
+		};
+
+		// reads the next argument, returns false if there are no more arguments
+		bool readArgument(const char*& position, const char* const end, Argument& argument)
+		{
+			if (position + 1 > end)
+				return false;
+
+			argument.tag = (logArguments::Tags)*position++;
+			if (argument.tag == logArguments::Tags::String)
+			{
+				uint32_t length;
+				if (position + sizeof(uint32_t) > end)
+					return false;
+				std::memcpy(&length, position, sizeof(uint32_t));
+				position += sizeof(uint32_t);
+				if (position + length > end)
+					return false;
+				argument.string.assign(position, length);
+				position += length;
+				return true;
+			}
+
+			if (position + sizeof(uint64_t) > end)
+				return false;
+
+			switch (argument.tag)
+			{
+			case logArguments::Tags::Signed:
+				std::memcpy(&argument.signedValue, position, sizeof(int64_t));
+				argument.unsignedValue = (uint64_t)argument.signedValue;
+				argument.floatingValue = (double)argument.signedValue;
+				break;
+			case logArguments::Tags::Unsigned:
+			case logArguments::Tags::Pointer:
+				std::memcpy(&argument.unsignedValue, position, sizeof(uint64_t));
+				argument.signedValue = (int64_t)argument.unsignedValue;
+				argument.floatingValue = (double)argument.unsignedValue;
+				break;
+			case logArguments::Tags::Floating:
+				std::memcpy(&argument.floatingValue, position, sizeof(double));
+				argument.signedValue = (int64_t)argument.floatingValue;
+				argument.unsignedValue = (uint64_t)argument.signedValue;
+				break;
+			default:
+				return false;
+			}
+			position += sizeof(uint64_t);
+			return true;
+		}
+
+		// appends a single argument, formatted by a conversion specification without length modifiers
+		void appendArgument(std::string& out, std::string specification, const char conversion, const Argument& argument)
+		{
+			switch (conversion)
+			{
+			case 'd':
+			case 'i':
+				specification += "lld";
+				appendFormatted(out, specification.c_str(), (long long)argument.signedValue);
+				break;
+
+			case 'u':
+			case 'x':
+			case 'X':
+			case 'o':
+				specification += "ll";
+				specification += conversion;
+				appendFormatted(out, specification.c_str(), (unsigned long long)argument.unsignedValue);
+				break;
+
+			case 'c':
+				specification += 'c';
+				appendFormatted(out, specification.c_str(), (int)argument.signedValue);
+				break;
+
+			case 'f':
+			case 'F':
+			case 'e':
+			case 'E':
+			case 'g':
+			case 'G':
+			case 'a':
+			case 'A':
+				specification += conversion;
+				appendFormatted(out, specification.c_str(), argument.floatingValue);
+				break;
+
+			case 'p':
+				appendFormatted(out, "0x%llx", (unsigned long long)argument.unsignedValue);
+				break;
+
+			case 's':
+				// arguments that are not strings are printed in their natural format
+				if (argument.tag == logArguments::Tags::String)
+				{
+					specification += 's';
+					appendFormatted(out, specification.c_str(), argument.string.c_str());
+				}
+				else if (argument.tag == logArguments::Tags::Floating)
+					appendFormatted(out, "%g", argument.floatingValue);
+				else if (argument.tag == logArguments::Tags::Signed)
+					appendFormatted(out, "%lld", (long long)argument.signedValue);
+				else
+					appendFormatted(out, "%llu", (unsigned long long)argument.unsignedValue);
+				break;
+			}
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// FORMAT STRINGS //////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	LogFormat::LogFormat(const char* const format) : format(format), id([format]()
+	{
+		std::lock_guard<std::mutex> lock(getRegistryMutex());
+		getRegistry().push_back(format);
+		return (uint32_t)(getRegistry().size() - 1);
+	}())
+	{ }
+
+	uint32_t getNumberOfLogFormats()
+	{
+		std::lock_guard<std::mutex> lock(getRegistryMutex());
+		return (uint32_t)getRegistry().size();
+	}
+
+	const char* getLogFormat(const uint32_t id)
+	{
+		std::lock_guard<std::mutex> lock(getRegistryMutex());
+		return id < getRegistry().size() ? getRegistry()[id] : nullptr;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// FORMATTING //////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	int64_t getLogTime()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	}
+
+	void formatLogHeader(std::string& out, const uint64_t lineNumber, const int64_t time, const SeverityType severity, const std::string& threadName)
+	{
+		if (severity == SeverityType::config)
+			return;
+
+		// the date and time only change once per second: each thread caches them (xx/xx/xxxx xx:xx:xx)
+		thread_local int64_t cachedSecond = -1;
+		thread_local char timeStamp[32];
+		thread_local int timeStampLength = 0;
+		const int64_t second = time >= 0 ? time / 1000000000 : (time + 1) / 1000000000 - 1;
+		if (second != cachedSecond)
+		{
+			const std::time_t seconds = (std::time_t)second;
+			std::tm localTime = { };
+#ifdef _WIN32
+			localtime_s(&localTime, &seconds);
+#else
+			localtime_r(&seconds, &localTime);
+#endif
+			timeStampLength = snprintf(timeStamp, sizeof(timeStamp), "%d/%d/%d %d:%d:%d", localTime.tm_mday, localTime.tm_mon + 1, localTime.tm_year + 1900, localTime.tm_hour, localTime.tm_min, localTime.tm_sec);
+			if (timeStampLength < 0 || timeStampLength >= (int)sizeof(timeStamp))
+				timeStampLength = 0;
+			cachedSecond = second;
+		}
+
+		// write down warning level
+		const char* severityName = "";
+		switch (severity)
+		{
+		case SeverityType::info:
+			severityName = "INFO:    ";
+			break;
+		case SeverityType::debug:
+			severityName = "DEBUG:   ";
+			break;
+		case SeverityType::warning:
+			severityName = "WARNING: ";
+			break;
+		case SeverityType::error:
+			severityName = "ERROR:   ";
+			break;
+		default:
+			break;
+		};
+
+		// header: line number and date (x: xx/xx/xxxx xx:xx:xx), warning level and thread name
+		char number[24];
+		const int numberLength = snprintf(number, sizeof(number), "%llu", (unsigned long long)lineNumber);
+		out.append(number, numberLength > 0 ? numberLength : 0);
+		out.append(": ", 2);
+		out.append(timeStamp, timeStampLength);
+		out += '\t';
+		out.append(severityName);
+		out.append(threadName);
+		out.append(":\t", 2);
+	}
+
+	void formatLogArguments(std::string& out, const char* format, const char* arguments, const size_t length)
+	{
+		const char* const end = arguments + length;
+		Argument argument;
+
+		while (*format)
+		{
+			// copy the text up to the next conversion
+			const char* next = std::strchr(format, '%');
+			if (next == nullptr)
+			{
+				out.append(format);
+				break;
+			}
+			out.append(format, next - format);
+			format = next;
+
+			if (format[1] == '%')
+			{
+				out += '%';
+				format += 2;
+				continue;
+			}
+
+			// parse the conversion specification: flags, width and precision, then the length modifiers, which are not needed
+			const char* const specificationBegin = format++;
+			while (*format && std::strchr("-+ #0", *format))
+				format++;
+			while (*format >= '0' && *format <= '9')
+				format++;
+			if (*format == '.')
+			{
+				format++;
+				while (*format >= '0' && *format <= '9')
+					format++;
+			}
+			const std::string specification(specificationBegin, format);
+			while (*format && std::strchr("hlLqjzt", *format))
+				format++;
+
+			const char conversion = *format;
+			if (conversion == '\0')
+			{
+				out.append(specificationBegin);
+				break;
+			}
+			format++;
+
+			if (!std::strchr("diuxXocfFeEgGaAps", conversion))
+			{
+				// unknown conversions are copied
+				out.append(specificationBegin, format);
+				continue;
+			}
+
+			if (!readArgument(arguments, end, argument))
+			{
+				out += "<missing>";
+				continue;
+			}
+
+			appendArgument(out, specification, conversion, argument);
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// BINARY LOG FILES ////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	namespace binaryLog
+	{
+		void appendRecord(std::string& out, const RecordKinds kind, const char* const data, const size_t length)
+		{
+			const uint32_t length32 = (uint32_t)length;
+			out += (char)kind;
+			out.append(reinterpret_cast<const char*>(&length32), sizeof(uint32_t));
+			out.append(data, length);
+		}
+
+		void appendMessageHeader(std::string& out, const MessageHeader& header)
+		{
+			out.append(reinterpret_cast<const char*>(&header.thread), sizeof(uint32_t));
+			out.append(reinterpret_cast<const char*>(&header.format), sizeof(uint32_t));
+			out.append(reinterpret_cast<const char*>(&header.lineNumber), sizeof(uint64_t));
+			out.append(reinterpret_cast<const char*>(&header.time), sizeof(int64_t));
+			out += (char)header.severity;
+		}
+
+		bool readMessageHeader(const char* const data, const size_t length, MessageHeader& header)
+		{
+			if (length < messageHeaderSize)
+				return false;
+
+			std::memcpy(&header.thread, data, sizeof(uint32_t));
+			std::memcpy(&header.format, data + 4, sizeof(uint32_t));
+			std::memcpy(&header.lineNumber, data + 8, sizeof(uint64_t));
+			std::memcpy(&header.time, data + 16, sizeof(int64_t));
+			header.severity = (uint8_t)data[24];
+			return true;
+		}
+	}
+
+	Expected<void> decodeBinaryLog(std::istream& in, std::ostream& out)
+	{
+		std::string data;
+		try { data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()); }
+		catch (std::exception& e) { return e; }
+
+		// check the magic number and the version
+		uint32_t version = 0;
+		if (data.size() >= sizeof(binaryLog::magic) + sizeof(uint32_t))
+			std::memcpy(&version, data.data() + sizeof(binaryLog::magic), sizeof(uint32_t));
+		if (data.size() < sizeof(binaryLog::magic) + sizeof(uint32_t) || std::memcmp(data.data(), binaryLog::magic, sizeof(binaryLog::magic)) != 0 || version != binaryLog::version)
+			return std::runtime_error("The file is not a binary log file of this version!");
+
+		std::vector<std::string> formats;
+		std::vector<std::string> threadNames;
+		std::string line;
+
+		size_t position = sizeof(binaryLog::magic) + sizeof(uint32_t);
+		while (position + binaryLog::recordHeaderSize <= data.size())
+		{
+			const binaryLog::RecordKinds kind = (binaryLog::RecordKinds)data[position];
+			uint32_t length;
+			std::memcpy(&length, data.data() + position + 1, sizeof(uint32_t));
+			const char* const record = data.data() + position + binaryLog::recordHeaderSize;
+			position += binaryLog::recordHeaderSize + length;
+			if (position > data.size())
+				return std::runtime_error("The binary log file is truncated!");
+
+			uint32_t index;
+			binaryLog::MessageHeader header;
+			switch (kind)
+			{
+			case binaryLog::RecordKinds::Format:
+			case binaryLog::RecordKinds::ThreadName:
+			{
+				if (length < sizeof(uint32_t))
+					return std::runtime_error("The binary log file is corrupt!");
+				std::memcpy(&index, record, sizeof(uint32_t));
+				std::vector<std::string>& table = kind == binaryLog::RecordKinds::Format ? formats : threadNames;
+
+				// the format strings are written in the order of their ids, the threads are numbered in the order in which they first logged
+				const bool validIndex = kind == binaryLog::RecordKinds::Format ? index <= formats.size() : index < binaryLog::maxThreads;
+				if (!validIndex)
+					return std::runtime_error("The binary log file is corrupt!");
+				if (table.size() <= index)
+					table.resize(index + 1);
+				table[index].assign(record + sizeof(uint32_t), length - sizeof(uint32_t));
+				break;
+			}
+
+			case binaryLog::RecordKinds::Text:
+				out.write(record, length);
+				out.write("\r\n", 2);
+				break;
+
+			case binaryLog::RecordKinds::Message:
+				if (!binaryLog::readMessageHeader(record, length, header))
+					return std::runtime_error("The binary log file is corrupt!");
+
+				line.clear();
+				formatLogHeader(line, header.lineNumber, header.time, (SeverityType)header.severity, header.thread < threadNames.size() ? threadNames[header.thread] : std::string());
+				if (header.format < formats.size())
+					formatLogArguments(line, formats[header.format].c_str(), record + binaryLog::messageHeaderSize, length - binaryLog::messageHeaderSize);
+				else
+					line += "<unknown format>";
+				out << line << "\r\n";
+				break;
+
+			default:
+				// unknown records are skipped
+				break;
+			}
+		}
+
+		if (!out.good())
+			return std::runtime_error("Unable to write the decoded log!");
+
+		return { };
+	}
+}
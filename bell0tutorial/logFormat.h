@@ -0,0 +1,173 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		11/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		deferred formatting of log messages
+*			instead of formatting a message, the calling thread only writes the id of the format string and the raw arguments,
+*			the logging daemon, or the offline decoder of binary log files, formats the message later on
+*				- format strings are registered once per call site (see LOG_FORMAT), the id is an index into the registry
+*				- the arguments are stored as a type tag followed by their value: integers and floating point numbers as eight bytes,
+*				  strings as their length followed by their characters
+*				- the format strings use the printf syntax, each conversion is applied to the next argument
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <string>
+#include <istream>
+#include <ostream>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// bell0bytes util
+#include "expected.h"
+
+// DEFINITIONS //////////////////////////////////////////////////////////////////////////
+
+// a reference to the registered format string of this call site
+#define LOG_FORMAT(format) ([]() -> const util::LogFormat& { static const util::LogFormat logFormat(format); return logFormat; }())
+
+namespace util
+{
+	/////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// MESSAGE TYPES ////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////
+
+	enum SeverityType
+	{
+		info = 0,
+		debug,
+		warning,
+		error,
+		config
+	};
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// FORMAT STRINGS ///////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////
+
+	// a registered format string; the string must outlive the program, i.e. a string literal
+	class LogFormat
+	{
+	private:
+		const char* const format;				// the format string
+		const uint32_t id;						// the index of the format string in the registry
+
+	public:
+		LogFormat(const char* const format);	// registers the format string (thread-safe)
+
+		const char* getFormat() const { return format; };
+		uint32_t getID() const { return id; };
+	};
+
+	// the registry
+	uint32_t getNumberOfLogFormats();					// thread-safe
+	const char* getLogFormat(const uint32_t id);		// thread-safe, returns null for unknown ids
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// ARGUMENTS ////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////
+	namespace logArguments
+	{
+		enum Tags : uint8_t { Signed = 1, Unsigned, Floating, String, Pointer };
+
+		// the size of each argument in the record
+		template<class T>
+		typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value, size_t>::type size(const T&) { return 1 + sizeof(uint64_t); }
+		inline size_t size(const char* const string) { return 1 + sizeof(uint32_t) + (string ? std::strlen(string) : 0); }
+		inline size_t size(const std::string& string) { return 1 + sizeof(uint32_t) + string.size(); }
+		inline size_t size(const void* const) { return 1 + sizeof(uint64_t); }
+
+		inline size_t totalSize() { return 0; }
+		template<class T, class... Arguments>
+		size_t totalSize(const T& argument, const Arguments&... arguments) { return size(argument) + totalSize(arguments...); }
+
+		// write the arguments, returns the position after the argument
+		inline char* writeValue(char* position, const Tags tag, const void* const value)
+		{
+			*position = (char)tag;
+			std::memcpy(position + 1, value, sizeof(uint64_t));
+			return position + 1 + sizeof(uint64_t);
+		}
+		inline char* writeString(char* position, const char* const string, const size_t length)
+		{
+			const uint32_t length32 = (uint32_t)length;
+			*position = (char)Tags::String;
+			std::memcpy(position + 1, &length32, sizeof(uint32_t));
+			if (length > 0)
+				std::memcpy(position + 1 + sizeof(uint32_t), string, length);
+			return position + 1 + sizeof(uint32_t) + length;
+		}
+
+		template<class T>
+		typename std::enable_if<std::is_floating_point<T>::value, char*>::type write(char* position, const T& argument) { const double value = (double)argument; return writeValue(position, Tags::Floating, &value); }
+		template<class T>
+		typename std::enable_if<(std::is_integral<T>::value && std::is_signed<T>::value) || std::is_enum<T>::value, char*>::type write(char* position, const T& argument) { const int64_t value = (int64_t)argument; return writeValue(position, Tags::Signed, &value); }
+		template<class T>
+		typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value, char*>::type write(char* position, const T& argument) { const uint64_t value = (uint64_t)argument; return writeValue(position, Tags::Unsigned, &value); }
+		inline char* write(char* position, const char* const string) { return writeString(position, string, string ? std::strlen(string) : 0); }
+		inline char* write(char* position, const std::string& string) { return writeString(position, string.c_str(), string.size()); }
+		inline char* write(char* position, const void* const pointer) { const uint64_t value = (uint64_t)(uintptr_t)pointer; return writeValue(position, Tags::Pointer, &value); }
+
+		inline char* writeAll(char* position) { return position; }
+		template<class T, class... Arguments>
+		char* writeAll(char* position, const T& argument, const Arguments&... arguments) { return writeAll(write(position, argument), arguments...); }
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// FORMATTING ///////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////
+
+	// appends the header of a message: line number, date and time (x: xx/xx/xxxx xx:xx:xx), severity and thread name
+	// the time is given in nanoseconds since the epoch of the system clock; config messages do not have a header
+	void formatLogHeader(std::string& out, const uint64_t lineNumber, const int64_t time, const SeverityType severity, const std::string& threadName);
+
+	// appends the message, applying the conversions of the format string to the encoded arguments
+	void formatLogArguments(std::string& out, const char* format, const char* arguments, const size_t length);
+
+	// the current time in nanoseconds since the epoch of the system clock
+	int64_t getLogTime();
+
+	/////////////////////////////////////////////////////////////////////////////////////
+	////////////////////////////// BINARY LOG FILES /////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////
+
+	// a binary log file starts with a magic number and its version, followed by records: [kind][length][data]
+	//		- Format:		the id of a format string and the string itself, written before the first message that uses it
+	//		- ThreadName:	the index of a thread and its name
+	//		- Text:			a message that was formatted by the calling thread
+	//		- Message:		the index of the thread, the id of the format string, the severity, the line number, the time and the arguments
+	namespace binaryLog
+	{
+		const char magic[4] = { 'b', '0', 'l', 'g' };
+		const uint32_t version = 1;
+		enum RecordKinds : uint8_t { Format = 1, ThreadName, Text, Message };
+		const size_t recordHeaderSize = sizeof(uint8_t) + sizeof(uint32_t);
+		const uint32_t maxThreads = 64 * 1024;			// thread name records with a larger index are corrupt
+
+		// the fixed part of a message record, the arguments follow
+		struct MessageHeader
+		{
+			uint32_t thread;
+			uint32_t format;
+			uint64_t lineNumber;
+			int64_t time;
+			uint8_t severity;
+		};
+		const size_t messageHeaderSize = 2 * sizeof(uint32_t) + sizeof(uint64_t) + sizeof(int64_t) + sizeof(uint8_t);
+
+		// appends a record to the buffer
+		void appendRecord(std::string& out, const RecordKinds kind, const char* const data, const size_t length);
+		void appendMessageHeader(std::string& out, const MessageHeader& header);
+		bool readMessageHeader(const char* const data, const size_t length, MessageHeader& header);
+	}
+
+	// decodes a binary log file into the layout of the text log files; corrupt files are rejected with an error
+	Expected<void> decodeBinaryLog(std::istream& in, std::ostream& out);
+}
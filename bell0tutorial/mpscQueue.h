@@ -0,0 +1,147 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		03/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		a bounded lock-free multi-producer single-consumer queue to be used in the event pattern
+*			the queue is a ring buffer, each cell stores a sequence number telling whether the cell is ready to be written to or read from (Vyukov),
+*			producers claim a cell with a single compare-and-swap, the consumer never has to synchronize with other consumers;
+*			the indices of the producers and the consumer live on separate cache lines, such that they do not invalidate each other
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <atomic>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <type_traits>
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace util
+{
+	static const size_t cacheLineSize = 64;
+
+	template<class T, size_t capacity = 4096>
+	class MPSCQueue
+	{
+		static_assert(capacity >= 2 && (capacity & (capacity - 1)) == 0, "The capacity of the queue must be a power of two!");
+
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> sequence;										// equal to the index of the cell if it is free, index + 1 if it holds a message
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;	// the message, T does not have to be default constructible or assignable
+		};
+
+		static const size_t mask = capacity - 1;
+
+		std::unique_ptr<Cell[]> cells;											// the ring buffer
+		alignas(cacheLineSize) std::atomic<size_t> enqueuePosition;				// the next position to write to, shared by all producers
+		alignas(cacheLineSize) std::atomic<size_t> dequeuePosition;				// the next position to read from, only written by the consumer
+
+	public:
+		// constructor and destructor
+		MPSCQueue() : cells(new Cell[capacity]), enqueuePosition(0), dequeuePosition(0)
+		{
+			for (size_t i = 0; i < capacity; i++)
+				cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+
+		~MPSCQueue()
+		{
+			// destroy the messages that were never read
+			drain([](const T&) { return true; });
+		}
+
+		MPSCQueue(MPSCQueue const&) = delete;
+		MPSCQueue& operator = (MPSCQueue const&) = delete;
+
+		// add a message to the queue (thread-safe)
+		// returns false if the queue is full
+		bool tryPush(const T& t)
+		{
+			Cell* cell;
+			size_t position = enqueuePosition.load(std::memory_order_relaxed);
+
+			for (;;)
+			{
+				cell = &cells[position & mask];
+				const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t difference = (std::ptrdiff_t)sequence - (std::ptrdiff_t)position;
+
+				if (difference == 0)
+				{
+					// the cell is free: try to claim it
+					if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (difference < 0)
+					// the consumer did not read this cell yet: the queue is full
+					return false;
+				else
+					// another producer claimed the cell: try again
+					position = enqueuePosition.load(std::memory_order_relaxed);
+			}
+
+			// write the message and publish it to the consumer
+			new (&cell->storage) T(t);
+			cell->sequence.store(position + 1, std::memory_order_release);
+			return true;
+		}
+
+		// hands the front message to the callback, which reads it in place, and removes it from the queue (consumer thread only)
+		// returns false if the queue is empty
+		template<class Callback>
+		bool tryPop(Callback&& callback)
+		{
+			const size_t position = dequeuePosition.load(std::memory_order_relaxed);
+			Cell& cell = cells[position & mask];
+
+			if (cell.sequence.load(std::memory_order_acquire) != position + 1)
+				return false;
+
+			T* message = reinterpret_cast<T*>(&cell.storage);
+			callback(static_cast<const T&>(*message));
+			message->~T();
+
+			// hand the cell back to the producers, one lap later
+			dequeuePosition.store(position + 1, std::memory_order_relaxed);
+			cell.sequence.store(position + capacity, std::memory_order_release);
+			return true;
+		}
+
+		// hands all messages to the callback, including those added while draining (consumer thread only)
+		// the callback returns false to stop draining; returns the number of messages handed to the callback
+		template<class Callback>
+		size_t drain(Callback&& callback)
+		{
+			size_t n = 0;
+			bool proceed = true;
+			while (proceed && tryPop([&callback, &proceed](const T& message) { proceed = callback(message); }))
+				n++;
+			return n;
+		}
+
+		// the queue is empty (exact for the consumer thread, an estimate for all other threads)
+		bool isEmpty() const
+		{
+			const size_t position = dequeuePosition.load(std::memory_order_relaxed);
+			return cells[position & mask].sequence.load(std::memory_order_acquire) != position + 1;
+		}
+
+		// the number of messages in the queue (an estimate while producers are active)
+		size_t size() const
+		{
+			const size_t tail = dequeuePosition.load(std::memory_order_relaxed);
+			const size_t head = enqueuePosition.load(std::memory_order_relaxed);
+			return head > tail ? head - tail : 0;
+		}
+
+		static constexpr size_t getCapacity() { return capacity; };
+	};
+}
@@ -0,0 +1,496 @@
+#include "noise.h"
+
+// SIMD
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NOISE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace mathematics
+{
+	namespace noise
+	{
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// CONSTANTS ///////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		static const float F2 = 0.366025403f;				// skew factor in 2D: (sqrt(3)-1)/2
+		static const float G2 = 0.211324865f;				// unskew factor in 2D: (3-sqrt(3))/6
+		static const float F3 = 1.0f / 3.0f;				// skew factor in 3D
+		static const float G3 = 1.0f / 6.0f;				// unskew factor in 3D
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// HELPERS /////////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		static inline int fastFloor(const float x)
+		{
+			const int i = (int)x;
+			return x < (float)i ? i - 1 : i;
+		}
+
+		// hashes the coordinates of a lattice point
+		static inline uint32_t hash(const uint32_t seed, const int i, const int j, const int k)
+		{
+			uint32_t h = seed ^ ((uint32_t)i * 0x8DA6B343u) ^ ((uint32_t)j * 0xD8163841u) ^ ((uint32_t)k * 0xCB1AB31Fu);
+			h ^= h >> 15;
+			h *= 0x2C1B3C6Du;
+			h ^= h >> 12;
+			h *= 0x297A2D39u;
+			h ^= h >> 15;
+			return h;
+		}
+
+		// the radial falloff of the contribution of each corner
+		static inline float falloff(float t)
+		{
+			t = t > 0.0f ? t : 0.0f;
+			t *= t;
+			return t * t;
+		}
+
+		// gradients: 16 directions in 1D, 8 in 2D and 12 in 3D
+		static inline float grad1(const uint32_t h, const float x)
+		{
+			float g = (float)(h & 7) + 1.0f;
+			return (h & 8) ? -g * x : g * x;
+		}
+
+		static inline float grad2(const uint32_t h, const float x, const float y)
+		{
+			const float u = (h & 4) ? y : x;
+			const float v = 2.0f * ((h & 4) ? x : y);
+			return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+		}
+
+		static inline float grad3(const uint32_t h, const float x, const float y, const float z)
+		{
+			const uint32_t h15 = h & 15;
+			const float u = h15 < 8 ? x : y;
+			const float v = h15 < 4 ? y : (h15 == 12 || h15 == 14) ? x : z;
+			return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+		}
+
+		// the offsets of a point to the four corners of its simplex in 3D and the hashes of the corners
+		struct Simplex3
+		{
+			float x[4], y[4], z[4];
+			uint32_t h[4];
+		};
+
+		static inline void findSimplex3(const uint32_t seed, const float x, const float y, const float z, Simplex3& simplex)
+		{
+			// skew the input space to find the simplex cell
+			const float s = (x + y + z) * F3;
+			const int i = fastFloor(x + s);
+			const int j = fastFloor(y + s);
+			const int k = fastFloor(z + s);
+			const float t = (float)(i + j + k) * G3;
+			const float x0 = x - ((float)i - t);
+			const float y0 = y - ((float)j - t);
+			const float z0 = z - ((float)k - t);
+
+			// the second and third corners of the tetrahedron, depending on the order of the coordinates
+			const bool xy = x0 >= y0, yz = y0 >= z0, xz = x0 >= z0;
+			const int i1 = xy && xz, j1 = !xy && yz, k1 = !xz && !yz;
+			const int i2 = xy || xz, j2 = !xy || yz, k2 = !(xz && yz);
+
+			simplex.x[0] = x0;
+			simplex.y[0] = y0;
+			simplex.z[0] = z0;
+			simplex.x[1] = x0 - (float)i1 + G3;
+			simplex.y[1] = y0 - (float)j1 + G3;
+			simplex.z[1] = z0 - (float)k1 + G3;
+			simplex.x[2] = x0 - (float)i2 + 2.0f * G3;
+			simplex.y[2] = y0 - (float)j2 + 2.0f * G3;
+			simplex.z[2] = z0 - (float)k2 + 2.0f * G3;
+			simplex.x[3] = x0 - 1.0f + 3.0f * G3;
+			simplex.y[3] = y0 - 1.0f + 3.0f * G3;
+			simplex.z[3] = z0 - 1.0f + 3.0f * G3;
+
+			simplex.h[0] = hash(seed, i, j, k);
+			simplex.h[1] = hash(seed, i + i1, j + j1, k + k1);
+			simplex.h[2] = hash(seed, i + i2, j + j2, k + k2);
+			simplex.h[3] = hash(seed, i + 1, j + 1, k + 1);
+		}
+
+		// the partial derivatives in x and y of the contribution of a corner in 3D
+		static inline void cornerDerivatives3(const uint32_t h, const float x, const float y, const float z, float& dx, float& dy)
+		{
+			float t = 0.6f - x * x - y * y - z * z;
+			t = t > 0.0f ? t : 0.0f;
+			const float t2 = t * t;
+			const float t4 = t2 * t2;
+			const float t3x8 = 8.0f * t2 * t;
+
+			// the gradient vector, see grad3
+			const uint32_t h15 = h & 15;
+			const float su = (h & 1) ? -1.0f : 1.0f;
+			const float sv = (h & 2) ? -1.0f : 1.0f;
+			const float gx = (h15 < 8 ? su : 0.0f) + ((h15 == 12 || h15 == 14) ? sv : 0.0f);
+			const float gy = (h15 < 8 ? 0.0f : su) + (h15 < 4 ? sv : 0.0f);
+			const float dot = grad3(h, x, y, z);
+
+			// product rule: d(t^4 * dot) = t^4 * grad - 8 t^3 * dot * offset
+			dx = t4 * gx - t3x8 * dot * x;
+			dy = t4 * gy - t3x8 * dot * y;
+		}
+
+#ifdef NOISE_SSE2
+		// SSE2 counterparts of the helpers above
+		static inline __m128i mullo(const __m128i a, const __m128i b)
+		{
+			const __m128i even = _mm_mul_epu32(a, b);
+			const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+			return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(2, 0, 2, 0)));
+		}
+
+		static inline __m128i fastFloor4(const __m128 x)
+		{
+			const __m128i i = _mm_cvttps_epi32(x);
+			return _mm_add_epi32(i, _mm_castps_si128(_mm_cmplt_ps(x, _mm_cvtepi32_ps(i))));		// adds -1 where the truncation rounded up
+		}
+
+		static inline __m128i hash4(const __m128i seed, const __m128i i, const __m128i j, const __m128i k)
+		{
+			__m128i h = _mm_xor_si128(seed, mullo(i, _mm_set1_epi32((int)0x8DA6B343u)));
+			h = _mm_xor_si128(h, mullo(j, _mm_set1_epi32((int)0xD8163841u)));
+			h = _mm_xor_si128(h, mullo(k, _mm_set1_epi32((int)0xCB1AB31Fu)));
+			h = _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+			h = mullo(h, _mm_set1_epi32((int)0x2C1B3C6Du));
+			h = _mm_xor_si128(h, _mm_srli_epi32(h, 12));
+			h = mullo(h, _mm_set1_epi32((int)0x297A2D39u));
+			return _mm_xor_si128(h, _mm_srli_epi32(h, 15));
+		}
+
+		static inline __m128 falloff4(__m128 t)
+		{
+			t = _mm_max_ps(t, _mm_setzero_ps());
+			t = _mm_mul_ps(t, t);
+			return _mm_mul_ps(t, t);
+		}
+
+		static inline __m128 select4(const __m128 mask, const __m128 a, const __m128 b)
+		{
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+
+		// flips the sign of the value where the given bit of the hash is set
+		static inline __m128 flipSign4(const __m128 x, const __m128i h, const int bit)
+		{
+			return _mm_xor_ps(x, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1 << bit)), 31 - bit)));
+		}
+
+		static inline __m128 grad1x4(const __m128i h, const __m128 x)
+		{
+			const __m128 g = _mm_add_ps(_mm_cvtepi32_ps(_mm_and_si128(h, _mm_set1_epi32(7))), _mm_set1_ps(1.0f));
+			return flipSign4(_mm_mul_ps(g, x), h, 3);
+		}
+
+		static inline __m128 grad2x4(const __m128i h, const __m128 x, const __m128 y)
+		{
+			const __m128 lower = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(h, _mm_set1_epi32(4)), _mm_setzero_si128()));
+			const __m128 u = select4(lower, x, y);
+			const __m128 v = _mm_mul_ps(_mm_set1_ps(2.0f), select4(lower, y, x));
+			return _mm_add_ps(flipSign4(u, h, 0), flipSign4(v, h, 1));
+		}
+
+		static inline __m128 grad3x4(const __m128i h, const __m128 x, const __m128 y, const __m128 z)
+		{
+			const __m128i h15 = _mm_and_si128(h, _mm_set1_epi32(15));
+			const __m128 below8 = _mm_castsi128_ps(_mm_cmplt_epi32(h15, _mm_set1_epi32(8)));
+			const __m128 below4 = _mm_castsi128_ps(_mm_cmplt_epi32(h15, _mm_set1_epi32(4)));
+			const __m128 is12or14 = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h15, _mm_set1_epi32(12)), _mm_cmpeq_epi32(h15, _mm_set1_epi32(14))));
+			const __m128 u = select4(below8, x, y);
+			const __m128 v = select4(below4, y, select4(is12or14, x, z));
+			return _mm_add_ps(flipSign4(u, h, 0), flipSign4(v, h, 1));
+		}
+
+		struct Simplex3x4
+		{
+			__m128 x[4], y[4], z[4];
+			__m128i h[4];
+		};
+
+		static inline void findSimplex3x4(const __m128i seed4, const __m128 px, const __m128 py, const __m128 pz, Simplex3x4& simplex)
+		{
+			const __m128i one = _mm_set1_epi32(1);
+			const __m128 allBits = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			const __m128 onef = _mm_set1_ps(1.0f);
+			const __m128 g3 = _mm_set1_ps(G3);
+			const __m128 g3x2 = _mm_set1_ps(2.0f * G3);
+			const __m128 g3x3 = _mm_set1_ps(3.0f * G3);
+
+			// skew the input space to find the simplex cell
+			const __m128 s = _mm_mul_ps(_mm_add_ps(_mm_add_ps(px, py), pz), _mm_set1_ps(F3));
+			const __m128i i = fastFloor4(_mm_add_ps(px, s));
+			const __m128i j = fastFloor4(_mm_add_ps(py, s));
+			const __m128i k = fastFloor4(_mm_add_ps(pz, s));
+			const __m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_add_epi32(i, j), k)), g3);
+			const __m128 x0 = _mm_sub_ps(px, _mm_sub_ps(_mm_cvtepi32_ps(i), t));
+			const __m128 y0 = _mm_sub_ps(py, _mm_sub_ps(_mm_cvtepi32_ps(j), t));
+			const __m128 z0 = _mm_sub_ps(pz, _mm_sub_ps(_mm_cvtepi32_ps(k), t));
+
+			// the second and third corners of the tetrahedron, depending on the order of the coordinates
+			const __m128 xy = _mm_cmpge_ps(x0, y0), yz = _mm_cmpge_ps(y0, z0), xz = _mm_cmpge_ps(x0, z0);
+			const __m128i i1 = _mm_and_si128(_mm_castps_si128(_mm_and_ps(xy, xz)), one);
+			const __m128i j1 = _mm_and_si128(_mm_castps_si128(_mm_andnot_ps(xy, yz)), one);
+			const __m128i k1 = _mm_and_si128(_mm_castps_si128(_mm_andnot_ps(_mm_or_ps(xz, yz), allBits)), one);
+			const __m128i i2 = _mm_and_si128(_mm_castps_si128(_mm_or_ps(xy, xz)), one);
+			const __m128i j2 = _mm_and_si128(_mm_castps_si128(_mm_or_ps(_mm_andnot_ps(xy, allBits), yz)), one);
+			const __m128i k2 = _mm_and_si128(_mm_castps_si128(_mm_andnot_ps(_mm_and_ps(xz, yz), allBits)), one);
+
+			simplex.x[0] = x0;
+			simplex.y[0] = y0;
+			simplex.z[0] = z0;
+			simplex.x[1] = _mm_add_ps(_mm_sub_ps(x0, _mm_cvtepi32_ps(i1)), g3);
+			simplex.y[1] = _mm_add_ps(_mm_sub_ps(y0, _mm_cvtepi32_ps(j1)), g3);
+			simplex.z[1] = _mm_add_ps(_mm_sub_ps(z0, _mm_cvtepi32_ps(k1)), g3);
+			simplex.x[2] = _mm_add_ps(_mm_sub_ps(x0, _mm_cvtepi32_ps(i2)), g3x2);
+			simplex.y[2] = _mm_add_ps(_mm_sub_ps(y0, _mm_cvtepi32_ps(j2)), g3x2);
+			simplex.z[2] = _mm_add_ps(_mm_sub_ps(z0, _mm_cvtepi32_ps(k2)), g3x2);
+			simplex.x[3] = _mm_add_ps(_mm_sub_ps(x0, onef), g3x3);
+			simplex.y[3] = _mm_add_ps(_mm_sub_ps(y0, onef), g3x3);
+			simplex.z[3] = _mm_add_ps(_mm_sub_ps(z0, onef), g3x3);
+
+			simplex.h[0] = hash4(seed4, i, j, k);
+			simplex.h[1] = hash4(seed4, _mm_add_epi32(i, i1), _mm_add_epi32(j, j1), _mm_add_epi32(k, k1));
+			simplex.h[2] = hash4(seed4, _mm_add_epi32(i, i2), _mm_add_epi32(j, j2), _mm_add_epi32(k, k2));
+			simplex.h[3] = hash4(seed4, _mm_add_epi32(i, one), _mm_add_epi32(j, one), _mm_add_epi32(k, one));
+		}
+
+		static inline void cornerDerivatives3x4(const __m128i h, const __m128 x, const __m128 y, const __m128 z, __m128& dx, __m128& dy)
+		{
+			const __m128 t = _mm_max_ps(_mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_set1_ps(0.6f), _mm_mul_ps(x, x)), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)), _mm_setzero_ps());
+			const __m128 t2 = _mm_mul_ps(t, t);
+			const __m128 t4 = _mm_mul_ps(t2, t2);
+			const __m128 t3x8 = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(8.0f), t2), t);
+
+			// the gradient vector, see grad3x4
+			const __m128i h15 = _mm_and_si128(h, _mm_set1_epi32(15));
+			const __m128 below8 = _mm_castsi128_ps(_mm_cmplt_epi32(h15, _mm_set1_epi32(8)));
+			const __m128 below4 = _mm_castsi128_ps(_mm_cmplt_epi32(h15, _mm_set1_epi32(4)));
+			const __m128 is12or14 = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h15, _mm_set1_epi32(12)), _mm_cmpeq_epi32(h15, _mm_set1_epi32(14))));
+			const __m128 su = flipSign4(_mm_set1_ps(1.0f), h, 0);
+			const __m128 sv = flipSign4(_mm_set1_ps(1.0f), h, 1);
+			const __m128 gx = _mm_add_ps(_mm_and_ps(below8, su), _mm_and_ps(is12or14, sv));
+			const __m128 gy = _mm_add_ps(_mm_andnot_ps(below8, su), _mm_and_ps(below4, sv));
+			const __m128 dot = grad3x4(h, x, y, z);
+
+			dx = _mm_sub_ps(_mm_mul_ps(t4, gx), _mm_mul_ps(_mm_mul_ps(t3x8, dot), x));
+			dy = _mm_sub_ps(_mm_mul_ps(t4, gy), _mm_mul_ps(_mm_mul_ps(t3x8, dot), y));
+		}
+#endif
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// SINGLE POINTS ///////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		float SimplexNoise::noise1D(const float x) const
+		{
+			const int i0 = fastFloor(x);
+			const float x0 = x - (float)i0;
+			const float x1 = x0 - 1.0f;
+
+			const float n0 = falloff(1.0f - x0 * x0) * grad1(hash(seed, i0, 0, 0), x0);
+			const float n1 = falloff(1.0f - x1 * x1) * grad1(hash(seed, i0 + 1, 0, 0), x1);
+
+			return 0.395f * (n0 + n1);
+		}
+
+		float SimplexNoise::noise2D(const float x, const float y) const
+		{
+			// skew the input space to find the simplex cell
+			const float s = (x + y) * F2;
+			const int i = fastFloor(x + s);
+			const int j = fastFloor(y + s);
+			const float t = (float)(i + j) * G2;
+			const float x0 = x - ((float)i - t);
+			const float y0 = y - ((float)j - t);
+
+			// the middle corner of the triangle
+			const int i1 = x0 > y0 ? 1 : 0;
+			const int j1 = 1 - i1;
+
+			const float x1 = x0 - (float)i1 + G2;
+			const float y1 = y0 - (float)j1 + G2;
+			const float x2 = x0 - 1.0f + 2.0f * G2;
+			const float y2 = y0 - 1.0f + 2.0f * G2;
+
+			// the contributions of the three corners
+			const float n0 = falloff(0.5f - x0 * x0 - y0 * y0) * grad2(hash(seed, i, j, 0), x0, y0);
+			const float n1 = falloff(0.5f - x1 * x1 - y1 * y1) * grad2(hash(seed, i + i1, j + j1, 0), x1, y1);
+			const float n2 = falloff(0.5f - x2 * x2 - y2 * y2) * grad2(hash(seed, i + 1, j + 1, 0), x2, y2);
+
+			return 40.0f * (n0 + n1 + n2);
+		}
+
+		float SimplexNoise::noise3D(const float x, const float y, const float z) const
+		{
+			Simplex3 simplex;
+			findSimplex3(seed, x, y, z, simplex);
+
+			// the contributions of the four corners
+			float n = 0.0f;
+			for (unsigned int c = 0; c < 4; c++)
+				n += falloff(0.6f - simplex.x[c] * simplex.x[c] - simplex.y[c] * simplex.y[c] - simplex.z[c] * simplex.z[c]) * grad3(simplex.h[c], simplex.x[c], simplex.y[c], simplex.z[c]);
+
+			return 32.0f * n;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// BATCH ///////////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		void SimplexNoise::noise1D(const float* const x, float* const out, const size_t n) const
+		{
+			size_t p = 0;
+
+#ifdef NOISE_SSE2
+			const __m128i seed4 = _mm_set1_epi32((int)seed);
+			const __m128i one = _mm_set1_epi32(1);
+			const __m128i zero = _mm_setzero_si128();
+			const __m128 onef = _mm_set1_ps(1.0f);
+
+			for (; p + 4 <= n; p += 4)
+			{
+				const __m128 px = _mm_loadu_ps(x + p);
+				const __m128i i0 = fastFloor4(px);
+				const __m128 x0 = _mm_sub_ps(px, _mm_cvtepi32_ps(i0));
+				const __m128 x1 = _mm_sub_ps(x0, onef);
+
+				const __m128 n0 = _mm_mul_ps(falloff4(_mm_sub_ps(onef, _mm_mul_ps(x0, x0))), grad1x4(hash4(seed4, i0, zero, zero), x0));
+				const __m128 n1 = _mm_mul_ps(falloff4(_mm_sub_ps(onef, _mm_mul_ps(x1, x1))), grad1x4(hash4(seed4, _mm_add_epi32(i0, one), zero, zero), x1));
+
+				_mm_storeu_ps(out + p, _mm_mul_ps(_mm_set1_ps(0.395f), _mm_add_ps(n0, n1)));
+			}
+#endif
+			for (; p < n; p++)
+				out[p] = noise1D(x[p]);
+		}
+
+		void SimplexNoise::noise2D(const float* const x, const float* const y, float* const out, const size_t n) const
+		{
+			size_t p = 0;
+
+#ifdef NOISE_SSE2
+			const __m128i seed4 = _mm_set1_epi32((int)seed);
+			const __m128i one = _mm_set1_epi32(1);
+			const __m128i zero = _mm_setzero_si128();
+			const __m128 onef = _mm_set1_ps(1.0f);
+			const __m128 half = _mm_set1_ps(0.5f);
+			const __m128 g2 = _mm_set1_ps(G2);
+			const __m128 g2x2 = _mm_set1_ps(2.0f * G2);
+
+			for (; p + 4 <= n; p += 4)
+			{
+				const __m128 px = _mm_loadu_ps(x + p);
+				const __m128 py = _mm_loadu_ps(y + p);
+
+				// skew the input space to find the simplex cell
+				const __m128 s = _mm_mul_ps(_mm_add_ps(px, py), _mm_set1_ps(F2));
+				const __m128i i = fastFloor4(_mm_add_ps(px, s));
+				const __m128i j = fastFloor4(_mm_add_ps(py, s));
+				const __m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(i, j)), g2);
+				const __m128 x0 = _mm_sub_ps(px, _mm_sub_ps(_mm_cvtepi32_ps(i), t));
+				const __m128 y0 = _mm_sub_ps(py, _mm_sub_ps(_mm_cvtepi32_ps(j), t));
+
+				// the middle corner of the triangle
+				const __m128i i1 = _mm_and_si128(_mm_castps_si128(_mm_cmpgt_ps(x0, y0)), one);
+				const __m128i j1 = _mm_sub_epi32(one, i1);
+
+				const __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, _mm_cvtepi32_ps(i1)), g2);
+				const __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, _mm_cvtepi32_ps(j1)), g2);
+				const __m128 x2 = _mm_add_ps(_mm_sub_ps(x0, onef), g2x2);
+				const __m128 y2 = _mm_add_ps(_mm_sub_ps(y0, onef), g2x2);
+
+				// the contributions of the three corners
+				const __m128 n0 = _mm_mul_ps(falloff4(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0))), grad2x4(hash4(seed4, i, j, zero), x0, y0));
+				const __m128 n1 = _mm_mul_ps(falloff4(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1))), grad2x4(hash4(seed4, _mm_add_epi32(i, i1), _mm_add_epi32(j, j1), zero), x1, y1));
+				const __m128 n2 = _mm_mul_ps(falloff4(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x2, x2)), _mm_mul_ps(y2, y2))), grad2x4(hash4(seed4, _mm_add_epi32(i, one), _mm_add_epi32(j, one), zero), x2, y2));
+
+				_mm_storeu_ps(out + p, _mm_mul_ps(_mm_set1_ps(40.0f), _mm_add_ps(_mm_add_ps(n0, n1), n2)));
+			}
+#endif
+			for (; p < n; p++)
+				out[p] = noise2D(x[p], y[p]);
+		}
+
+		void SimplexNoise::noise3D(const float* const x, const float* const y, const float* const z, float* const out, const size_t n) const
+		{
+			size_t p = 0;
+
+#ifdef NOISE_SSE2
+			const __m128i seed4 = _mm_set1_epi32((int)seed);
+			const __m128 c = _mm_set1_ps(0.6f);
+			Simplex3x4 simplex;
+
+			for (; p + 4 <= n; p += 4)
+			{
+				findSimplex3x4(seed4, _mm_loadu_ps(x + p), _mm_loadu_ps(y + p), _mm_loadu_ps(z + p), simplex);
+
+				// the contributions of the four corners
+				__m128 sum = _mm_setzero_ps();
+				for (unsigned int k = 0; k < 4; k++)
+				{
+					const __m128 t = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(c, _mm_mul_ps(simplex.x[k], simplex.x[k])), _mm_mul_ps(simplex.y[k], simplex.y[k])), _mm_mul_ps(simplex.z[k], simplex.z[k]));
+					sum = _mm_add_ps(sum, _mm_mul_ps(falloff4(t), grad3x4(simplex.h[k], simplex.x[k], simplex.y[k], simplex.z[k])));
+				}
+
+				_mm_storeu_ps(out + p, _mm_mul_ps(_mm_set1_ps(32.0f), sum));
+			}
+#endif
+			for (; p < n; p++)
+				out[p] = noise3D(x[p], y[p], z[p]);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// CURL ////////////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		void SimplexNoise::curl2D(const float x, const float y, const float t, float& vx, float& vy) const
+		{
+			Simplex3 simplex;
+			findSimplex3(seed, x, y, t, simplex);
+
+			// the analytic derivatives of the noise, summed over the four corners
+			float dx = 0.0f, dy = 0.0f;
+			for (unsigned int c = 0; c < 4; c++)
+			{
+				float cdx, cdy;
+				cornerDerivatives3(simplex.h[c], simplex.x[c], simplex.y[c], simplex.z[c], cdx, cdy);
+				dx += cdx;
+				dy += cdy;
+			}
+
+			// the curl of the scalar potential: (d/dy, -d/dx)
+			vx = 32.0f * dy;
+			vy = -32.0f * dx;
+		}
+
+		void SimplexNoise::curl2D(const float* const x, const float* const y, const float t, float* const vx, float* const vy, const size_t n) const
+		{
+			size_t p = 0;
+
+#ifdef NOISE_SSE2
+			const __m128i seed4 = _mm_set1_epi32((int)seed);
+			const __m128 pt = _mm_set1_ps(t);
+			Simplex3x4 simplex;
+
+			for (; p + 4 <= n; p += 4)
+			{
+				findSimplex3x4(seed4, _mm_loadu_ps(x + p), _mm_loadu_ps(y + p), pt, simplex);
+
+				__m128 dx = _mm_setzero_ps(), dy = _mm_setzero_ps();
+				for (unsigned int c = 0; c < 4; c++)
+				{
+					__m128 cdx, cdy;
+					cornerDerivatives3x4(simplex.h[c], simplex.x[c], simplex.y[c], simplex.z[c], cdx, cdy);
+					dx = _mm_add_ps(dx, cdx);
+					dy = _mm_add_ps(dy, cdy);
+				}
+
+				_mm_storeu_ps(vx + p, _mm_mul_ps(_mm_set1_ps(32.0f), dy));
+				_mm_storeu_ps(vy + p, _mm_mul_ps(_mm_set1_ps(-32.0f), dx));
+			}
+#endif
+			for (; p < n; p++)
+				curl2D(x[p], y[p], t, vx[p], vy[p]);
+		}
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		02/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		procedural noise: simplex noise in one, two and three dimensions and curl noise
+*			the lattice gradients are chosen by an integer hash instead of a permutation table, such that the batch functions can evaluate four points at once using SIMD
+*			the batch functions expect the coordinates as separate arrays (structure of arrays) and return the same values as the single point functions
+*
+* History:	- 02/09/2019: simplex noise and curl noise
+*
+* ToDo:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <cstddef>
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace mathematics
+{
+	namespace noise
+	{
+		class SimplexNoise
+		{
+		private:
+			uint32_t seed;									// different seeds yield different noise fields
+
+		public:
+			SimplexNoise(const uint32_t seed = 0) : seed(seed) {};
+
+			// seeding
+			void setSeed(const uint32_t seed) { this->seed = seed; };
+			uint32_t getSeed() const { return seed; };
+
+			// single points, the results are roughly in [-1,1]
+			float noise1D(const float x) const;
+			float noise2D(const float x, const float y) const;
+			float noise3D(const float x, const float y, const float z) const;
+
+			// batch evaluation
+			void noise1D(const float* const x, float* const out, const size_t n) const;
+			void noise2D(const float* const x, const float* const y, float* const out, const size_t n) const;
+			void noise3D(const float* const x, const float* const y, const float* const z, float* const out, const size_t n) const;
+
+			// curl noise: the curl of the noise field at time t, i.e. a divergence-free two-dimensional flow, think of smoke or water
+			// the flow is computed from the analytic derivatives of the three-dimensional noise, with the time as third coordinate
+			void curl2D(const float x, const float y, const float t, float& vx, float& vy) const;
+			void curl2D(const float* const x, const float* const y, const float t, float* const vx, float* const vy, const size_t n) const;
+		};
+	}
+}
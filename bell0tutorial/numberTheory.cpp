@@ -1,28 +1,431 @@
 #include "numberTheory.h"
 #include <random>
+#include <climits>
+
+// SIMD
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NUMBERTHEORY_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace mathematics
 {
 	namespace numberTheory
 	{
-		NumberTheory::NumberTheory()
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// HELPERS /////////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		static inline uint64_t rotl(const uint64_t x, const int k)
+		{
+			return (x << k) | (x >> (64 - k));
+		}
+
+		// the upper 24 bits of a random number are mapped to a float in [0,1)
+		static inline float toUnitFloat(const uint64_t x)
+		{
+			return (x >> 40) * (1.0f / 16777216.0f);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// SPLITMIX64 //////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		uint64_t SplitMix64::operator()()
+		{
+			uint64_t z = (state += 0x9e3779b97f4a7c15);
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+			return z ^ (z >> 31);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// XOSHIRO256++ ////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		Xoshiro256PlusPlus::Xoshiro256PlusPlus(const uint64_t seed)
+		{
+			// the state must not be all zero, SplitMix64 guarantees that
+			SplitMix64 sm(seed);
+			for (unsigned int i = 0; i < 4; i++)
+				s[i] = sm();
+		}
+
+		Xoshiro256PlusPlus::result_type Xoshiro256PlusPlus::operator()()
+		{
+			const uint64_t result = rotl(s[0] + s[3], 23) + s[0];
+			const uint64_t t = s[1] << 17;
+
+			s[2] ^= s[0];
+			s[3] ^= s[1];
+			s[1] ^= s[2];
+			s[0] ^= s[3];
+			s[2] ^= t;
+			s[3] = rotl(s[3], 45);
+
+			return result;
+		}
+
+		float Xoshiro256PlusPlus::nextFloat()
+		{
+			return toUnitFloat((*this)());
+		}
+
+		float Xoshiro256PlusPlus::nextFloat(const float min, const float max)
+		{
+			return min + nextFloat() * (max - min);
+		}
+
+		void Xoshiro256PlusPlus::jump()
+		{
+			static const uint64_t JUMP[] = { 0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c };
+
+			uint64_t t[4] = { 0, 0, 0, 0 };
+			for (unsigned int i = 0; i < 4; i++)
+				for (unsigned int b = 0; b < 64; b++)
+				{
+					if (JUMP[i] & (uint64_t)1 << b)
+						for (unsigned int j = 0; j < 4; j++)
+							t[j] ^= s[j];
+					(*this)();
+				}
+
+			for (unsigned int j = 0; j < 4; j++)
+				s[j] = t[j];
+		}
+
+		void Xoshiro256PlusPlus::longJump()
+		{
+			static const uint64_t LONG_JUMP[] = { 0x76e15d3efefdcbbf, 0xc5004e441c522fb3, 0x77710069854ee241, 0x39109bb02acbe635 };
+
+			uint64_t t[4] = { 0, 0, 0, 0 };
+			for (unsigned int i = 0; i < 4; i++)
+				for (unsigned int b = 0; b < 64; b++)
+				{
+					if (LONG_JUMP[i] & (uint64_t)1 << b)
+						for (unsigned int j = 0; j < 4; j++)
+							t[j] ^= s[j];
+					(*this)();
+				}
+
+			for (unsigned int j = 0; j < 4; j++)
+				s[j] = t[j];
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// XOSHIRO256++ X4 /////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		Xoshiro256PlusPlusX4::Xoshiro256PlusPlusX4(const Xoshiro256PlusPlus& engine)
+		{
+			Xoshiro256PlusPlus lane = engine;
+			for (unsigned int l = 0; l < 4; l++)
+			{
+				for (unsigned int w = 0; w < 4; w++)
+					s[w][l] = lane.s[w];
+				lane.jump();
+			}
+		}
+
+		void Xoshiro256PlusPlusX4::fill(float* const data, const size_t n, const float min, const float max)
+		{
+			const float scale = (max - min) * (1.0f / 16777216.0f);
+			size_t i = 0;
+
+#ifdef NUMBERTHEORY_SSE2
+			// two lanes per register, the four lanes are processed as a low and a high pair
+			__m128i s0[2], s1[2], s2[2], s3[2];
+			for (unsigned int p = 0; p < 2; p++)
+			{
+				s0[p] = _mm_load_si128((const __m128i*)&s[0][2 * p]);
+				s1[p] = _mm_load_si128((const __m128i*)&s[1][2 * p]);
+				s2[p] = _mm_load_si128((const __m128i*)&s[2][2 * p]);
+				s3[p] = _mm_load_si128((const __m128i*)&s[3][2 * p]);
+			}
+
+			const __m128 scale4 = _mm_set1_ps(scale);
+			const __m128 min4 = _mm_set1_ps(min);
+
+			for (; i + 4 <= n; i += 4)
+			{
+				__m128i result[2];
+				for (unsigned int p = 0; p < 2; p++)
+				{
+					// result = rotl(s0 + s3, 23) + s0
+					__m128i sum = _mm_add_epi64(s0[p], s3[p]);
+					result[p] = _mm_add_epi64(_mm_or_si128(_mm_slli_epi64(sum, 23), _mm_srli_epi64(sum, 41)), s0[p]);
+
+					// advance the state
+					__m128i t = _mm_slli_epi64(s1[p], 17);
+					s2[p] = _mm_xor_si128(s2[p], s0[p]);
+					s3[p] = _mm_xor_si128(s3[p], s1[p]);
+					s1[p] = _mm_xor_si128(s1[p], s2[p]);
+					s0[p] = _mm_xor_si128(s0[p], s3[p]);
+					s2[p] = _mm_xor_si128(s2[p], t);
+					s3[p] = _mm_or_si128(_mm_slli_epi64(s3[p], 45), _mm_srli_epi64(s3[p], 19));
+
+					// keep the upper 24 bits, they fit into the lower 32 bits of each lane
+					result[p] = _mm_srli_epi64(result[p], 40);
+				}
+
+				// pack the four lanes into four 32-bit integers and convert them to floats
+				__m128i packed = _mm_unpacklo_epi64(_mm_shuffle_epi32(result[0], _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_epi32(result[1], _MM_SHUFFLE(2, 0, 2, 0)));
+				_mm_storeu_ps(data + i, _mm_add_ps(min4, _mm_mul_ps(_mm_cvtepi32_ps(packed), scale4)));
+			}
+
+			for (unsigned int p = 0; p < 2; p++)
+			{
+				_mm_store_si128((__m128i*)&s[0][2 * p], s0[p]);
+				_mm_store_si128((__m128i*)&s[1][2 * p], s1[p]);
+				_mm_store_si128((__m128i*)&s[2][2 * p], s2[p]);
+				_mm_store_si128((__m128i*)&s[3][2 * p], s3[p]);
+			}
+#endif
+			// scalar path, also used for the remainder; the lanes are used in the same order as in the SIMD path
+			for (unsigned int l = 0; i < n; i++, l = (l + 1) % 4)
+			{
+				const uint64_t result = rotl(s[0][l] + s[3][l], 23) + s[0][l];
+				const uint64_t t = s[1][l] << 17;
+
+				s[2][l] ^= s[0][l];
+				s[3][l] ^= s[1][l];
+				s[1][l] ^= s[2][l];
+				s[0][l] ^= s[3][l];
+				s[2][l] ^= t;
+				s[3][l] = rotl(s[3][l], 45);
+
+				data[i] = min + (result >> 40) * scale;
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// PCG32 ///////////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		PCG32::PCG32(const uint64_t seed, const uint64_t stream) : state(0), increment((stream << 1) | 1)
+		{
+			(*this)();
+			state += seed;
+			(*this)();
+		}
+
+		PCG32::result_type PCG32::operator()()
+		{
+			const uint64_t oldState = state;
+			state = oldState * 6364136223846793005ULL + increment;
+
+			// permutation: xorshift high, then random rotation
+			const uint32_t xorShifted = (uint32_t)(((oldState >> 18) ^ oldState) >> 27);
+			const uint32_t rotation = (uint32_t)(oldState >> 59);
+			return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31));
+		}
+
+		float PCG32::nextFloat()
 		{
-			this->rd = new std::random_device;
-			this->mt = new std::mt19937_64((*rd)());
+			return ((*this)() >> 8) * (1.0f / 16777216.0f);
+		}
+
+		float PCG32::nextFloat(const float min, const float max)
+		{
+			return min + nextFloat() * (max - min);
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// PHILOX4x32-10 ///////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		static const uint32_t PHILOX_M0 = 0xD2511F53;		// multipliers
+		static const uint32_t PHILOX_M1 = 0xCD9E8D57;
+		static const uint32_t PHILOX_W0 = 0x9E3779B9;		// Weyl sequence to bump the key
+		static const uint32_t PHILOX_W1 = 0xBB67AE85;
+		static const unsigned int PHILOX_ROUNDS = 10;
+
+		Philox4x32::Philox4x32(const uint64_t seed, const uint64_t entityID)
+		{
+			key[0] = (uint32_t)seed;
+			key[1] = (uint32_t)(seed >> 32);
+			entity[0] = (uint32_t)entityID;
+			entity[1] = (uint32_t)(entityID >> 32);
+		}
+
+		void Philox4x32::block(const uint64_t blockIndex, uint32_t out[4]) const
+		{
+			uint32_t c0 = (uint32_t)blockIndex, c1 = (uint32_t)(blockIndex >> 32), c2 = entity[0], c3 = entity[1];
+			uint32_t k0 = key[0], k1 = key[1];
+
+			for (unsigned int r = 0; r < PHILOX_ROUNDS; r++)
+			{
+				const uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+				const uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+
+				c0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+				c2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+				c1 = (uint32_t)p1;
+				c3 = (uint32_t)p0;
+
+				k0 += PHILOX_W0;
+				k1 += PHILOX_W1;
+			}
+
+			out[0] = c0;
+			out[1] = c1;
+			out[2] = c2;
+			out[3] = c3;
+		}
+
+		uint32_t Philox4x32::get(const uint64_t index) const
+		{
+			uint32_t out[4];
+			block(index / 4, out);
+			return out[index % 4];
+		}
+
+		float Philox4x32::getFloat(const uint64_t index) const
+		{
+			return (get(index) >> 8) * (1.0f / 16777216.0f);
+		}
+
+		float Philox4x32::getFloat(const uint64_t index, const float min, const float max) const
+		{
+			return min + getFloat(index) * (max - min);
+		}
+
+#ifdef NUMBERTHEORY_SSE2
+		// multiplies four 32-bit integers by a constant and returns the low and high 32 bits of the products
+		static inline void mulhilo(const __m128i a, const __m128i m, __m128i& lo, __m128i& hi)
+		{
+			const __m128i even = _mm_mul_epu32(a, m);						// products of lanes 0 and 2
+			const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);	// products of lanes 1 and 3
+			lo = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(2, 0, 2, 0)));
+			hi = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(3, 1, 3, 1)));
+		}
+#endif
+
+		void Philox4x32::fill(float* const data, const size_t n, const uint64_t firstIndex, const float min, const float max) const
+		{
+			const float scale = (max - min) * (1.0f / 16777216.0f);
+			size_t i = 0;
+
+			// scalar head, until the index is aligned to a block
+			for (; i < n && (firstIndex + i) % 4 != 0; i++)
+				data[i] = min + (get(firstIndex + i) >> 8) * scale;
+
+#ifdef NUMBERTHEORY_SSE2
+			// four blocks at once: each register holds the same word of four consecutive blocks
+			const __m128i m0 = _mm_set1_epi32((int)PHILOX_M0);
+			const __m128i m1 = _mm_set1_epi32((int)PHILOX_M1);
+			const __m128 scale4 = _mm_set1_ps(scale);
+			const __m128 min4 = _mm_set1_ps(min);
+
+			for (; i + 16 <= n; i += 16)
+			{
+				const uint64_t b = (firstIndex + i) / 4;
+				__m128i c0 = _mm_set_epi32((int)(uint32_t)(b + 3), (int)(uint32_t)(b + 2), (int)(uint32_t)(b + 1), (int)(uint32_t)b);
+				__m128i c1 = _mm_set_epi32((int)(uint32_t)((b + 3) >> 32), (int)(uint32_t)((b + 2) >> 32), (int)(uint32_t)((b + 1) >> 32), (int)(uint32_t)(b >> 32));
+				__m128i c2 = _mm_set1_epi32((int)entity[0]);
+				__m128i c3 = _mm_set1_epi32((int)entity[1]);
+				uint32_t k0 = key[0], k1 = key[1];
+
+				for (unsigned int r = 0; r < PHILOX_ROUNDS; r++)
+				{
+					__m128i lo0, hi0, lo1, hi1;
+					mulhilo(c0, m0, lo0, hi0);
+					mulhilo(c2, m1, lo1, hi1);
+
+					c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32((int)k0));
+					c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32((int)k1));
+					c1 = lo1;
+					c3 = lo0;
+
+					k0 += PHILOX_W0;
+					k1 += PHILOX_W1;
+				}
+
+				// convert to floats and transpose, such that the four words of each block are stored consecutively
+				__m128 f0 = _mm_add_ps(min4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(c0, 8)), scale4));
+				__m128 f1 = _mm_add_ps(min4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(c1, 8)), scale4));
+				__m128 f2 = _mm_add_ps(min4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(c2, 8)), scale4));
+				__m128 f3 = _mm_add_ps(min4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(c3, 8)), scale4));
+				_MM_TRANSPOSE4_PS(f0, f1, f2, f3);
+
+				_mm_storeu_ps(data + i, f0);
+				_mm_storeu_ps(data + i + 4, f1);
+				_mm_storeu_ps(data + i + 8, f2);
+				_mm_storeu_ps(data + i + 12, f3);
+			}
+#endif
+			// scalar path, also used for the remainder
+			for (; i + 4 <= n; i += 4)
+			{
+				uint32_t out[4];
+				block((firstIndex + i) / 4, out);
+				for (unsigned int w = 0; w < 4; w++)
+					data[i + w] = min + (out[w] >> 8) * scale;
+			}
+			for (; i < n; i++)
+				data[i] = min + (get(firstIndex + i) >> 8) * scale;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// NUMBER THEORY ///////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		NumberTheory::NumberTheory() : generation(0)
+		{
+			// by default, the game is seeded randomly; setSeed can be used to replay a game
+			std::random_device rd;
+			setSeed(((uint64_t)rd() << 32) | rd());
 		}
 
 		NumberTheory::~NumberTheory()
+		{ }
+
+		void NumberTheory::setSeed(const uint64_t seed)
+		{
+			std::lock_guard<std::mutex> lock(streamMutex);
+			this->seed = seed;
+			master = Xoshiro256PlusPlus(seed);
+			generation++;
+		}
+
+		Xoshiro256PlusPlus NumberTheory::createStream() const
+		{
+			std::lock_guard<std::mutex> lock(streamMutex);
+
+			// the new stream starts where the master is now, the master then jumps 2^192 steps ahead
+			// the lanes of the SIMD engine are only 2^128 steps apart, thus they never reach the next stream
+			Xoshiro256PlusPlus stream = master;
+			master.longJump();
+			return stream;
+		}
+
+		Xoshiro256PlusPlus& NumberTheory::getThreadStream() const
+		{
+			static thread_local unsigned int streamGeneration = UINT_MAX;
+			static thread_local Xoshiro256PlusPlus stream;
+
+			if (streamGeneration != generation)
+			{
+				stream = createStream();
+				streamGeneration = generation;
+			}
+			return stream;
+		}
+
+		Xoshiro256PlusPlusX4& NumberTheory::getThreadStreamX4() const
 		{
-			if (rd)
-				delete rd;
-			if (mt)
-				delete mt;
+			static thread_local unsigned int streamGeneration = UINT_MAX;
+			static thread_local Xoshiro256PlusPlusX4 stream = Xoshiro256PlusPlusX4(Xoshiro256PlusPlus());
+
+			if (streamGeneration != generation)
+			{
+				stream = Xoshiro256PlusPlusX4(createStream());
+				streamGeneration = generation;
+			}
+			return stream;
 		}
 
 		float NumberTheory::generateRandomFloat(float min, float max) const
 		{
-			std::uniform_real_distribution<float> dist(min, max);
-			return dist(*mt);
+			return getThreadStream().nextFloat(min, max);
+		}
+
+		void NumberTheory::fill(float* const data, const size_t n, const float min, const float max) const
+		{
+			getThreadStreamX4().fill(data, n, min, max);
 		}
 	}
-}
\ No newline at end of file
+}
@@ -7,24 +7,125 @@
 * Desc:		number theory class
 *
 * History:	- 24/07/2019: singleton
+*			- 30/08/2019: xoshiro256++ and PCG32 engines, batch generation and independent streams per thread
+*			- 01/09/2019: counter-based Philox4x32-10 generator
 *
 * ToDo:
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
-#include <random>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <mutex>
+#include <atomic>
 
 // CLASSES //////////////////////////////////////////////////////////////////////////////
 namespace mathematics
 {
 	namespace numberTheory
 	{
+		// SplitMix64 - used to expand a single seed into the state of the other engines
+		class SplitMix64
+		{
+		private:
+			uint64_t state;
+
+		public:
+			SplitMix64(const uint64_t seed) : state(seed) {};
+			uint64_t operator()();
+		};
+
+		// xoshiro256++ by Blackman and Vigna, period 2^256-1
+		// the jump functions advance the state by 2^128 and 2^192 steps, which is used to create non-overlapping streams
+		class Xoshiro256PlusPlus
+		{
+		private:
+			uint64_t s[4];							// the state of the engine
+
+			friend class Xoshiro256PlusPlusX4;
+
+		public:
+			// satisfy the UniformRandomBitGenerator requirements, such that the engine can be used with the standard distributions
+			typedef uint64_t result_type;
+			static constexpr result_type min() { return 0; };
+			static constexpr result_type max() { return UINT64_MAX; };
+
+			Xoshiro256PlusPlus(const uint64_t seed = 0);
+
+			result_type operator()();						// returns the next 64 random bits
+			float nextFloat();								// returns a float in [0,1)
+			float nextFloat(const float min, const float max);	// returns a float in [min, max)
+
+			void jump();									// equivalent to 2^128 calls to the engine
+			void longJump();								// equivalent to 2^192 calls to the engine
+		};
+
+		// four independent xoshiro256++ streams, stored lane by lane to generate four numbers at once using SIMD
+		class Xoshiro256PlusPlusX4
+		{
+		private:
+			alignas(16) uint64_t s[4][4];			// the state of the engines: s[word][lane]
+
+		public:
+			Xoshiro256PlusPlusX4(const Xoshiro256PlusPlus& engine);	// the lanes are copies of the engine, each jumped one more time than the previous one
+
+			void fill(float* const data, const size_t n, const float min, const float max);	// fills the array with floats in [min, max)
+		};
+
+		// PCG32 by O'Neill, period 2^64, 2^63 selectable streams
+		class PCG32
+		{
+		private:
+			uint64_t state;							// the state of the engine
+			uint64_t increment;						// the stream, must be odd
+
+		public:
+			typedef uint32_t result_type;
+			static constexpr result_type min() { return 0; };
+			static constexpr result_type max() { return UINT32_MAX; };
+
+			PCG32(const uint64_t seed = 0, const uint64_t stream = 0);
+
+			result_type operator()();						// returns the next 32 random bits
+			float nextFloat();								// returns a float in [0,1)
+			float nextFloat(const float min, const float max);	// returns a float in [min, max)
+		};
+
+		// Philox4x32-10 by Salmon et al., a counter-based generator
+		// the i-th number of a stream only depends on the seed, the entity id and i, thus the numbers can be generated in any order and on any thread
+		// the counter of each block is (block index, entity id), the key is the seed; each block yields four numbers
+		class Philox4x32
+		{
+		private:
+			uint32_t key[2];						// the seed
+			uint32_t entity[2];						// the id of the entity, i.e. a particle system or a chunk of the world
+
+		public:
+			Philox4x32(const uint64_t seed, const uint64_t entityID);
+
+			void block(const uint64_t blockIndex, uint32_t out[4]) const;	// computes the four numbers of the given block
+			uint32_t get(const uint64_t index) const;						// returns the index-th 32-bit number of the stream
+			float getFloat(const uint64_t index) const;						// returns the index-th number of the stream as a float in [0,1)
+			float getFloat(const uint64_t index, const float min, const float max) const;	// returns the index-th number of the stream as a float in [min, max)
+
+			// fills the array with the numbers firstIndex, ..., firstIndex+n-1 of the stream, mapped to [min, max)
+			// splitting a range between threads yields exactly the same numbers as filling it at once
+			void fill(float* const data, const size_t n, const uint64_t firstIndex, const float min, const float max) const;
+		};
+
 		class NumberTheory
 		{
 		private:
-			// random device
-			std::random_device* rd;
-			std::mt19937_64* mt;
+			// seeding
+			uint64_t seed;							// the master seed; set it to a known value to replay a game
+			mutable Xoshiro256PlusPlus master;		// the master engine, each new stream is a copy of this engine
+			std::atomic<unsigned int> generation;	// incremented each time the seed changes, threads recreate their streams when it changes
+			mutable std::mutex streamMutex;			// protects the master engine
+
+			// the stream of the calling thread
+			Xoshiro256PlusPlus& getThreadStream() const;
+			Xoshiro256PlusPlusX4& getThreadStreamX4() const;
 
 		protected:
 			// protected constructor -> singleton
@@ -45,8 +146,20 @@ namespace mathematics
 			NumberTheory(NumberTheory const&) = delete;
 			NumberTheory& operator = (NumberTheory const&) = delete;
 
-			// random number generators
+			// seeding
+			void setSeed(const uint64_t seed);			// resets the master engine and all thread streams
+			uint64_t getSeed() const { return seed; };
+
+			// independent streams, i.e. for each emitter or each worker thread; deterministic for a given seed and order of creation
+			Xoshiro256PlusPlus createStream() const;
+
+			// counter-based streams, the numbers only depend on the seed, the entity and their index
+			Philox4x32 createCounterStream(const uint64_t entityID) const { return Philox4x32(seed, entityID); };
+
+			// random number generators (thread-safe, each thread draws from its own stream)
 			float generateRandomFloat(float min, float max) const;		// generates a random number between min and max
+			void fill(float* const data, const size_t n, const float min, const float max) const;	// fills the array with random numbers between min and max
+			void fill(std::vector<float>& data, const float min, const float max) const { fill(data.data(), data.size(), min, max); };
 		};
 	}
-}
\ No newline at end of file
+}
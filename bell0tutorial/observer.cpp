@@ -11,29 +11,112 @@ namespace util
 	/////////////////////////////////////////////////////////////////////////////////////////
 	////////////////////////////// The Subject //////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
-	void Subject::addObserver(Observer* const observer)
+	void Subject::addObserver(Observer* const observer, const uint64_t events, const int priority)
 	{
-		// add observer to observer list
-		observers.insert(observer);
+		if (observer == nullptr)
+			return;
+
+		// each observer is only added once
+		for (const ObserverEntry& entry : observers)
+			if (entry.observer == observer)
+				return;
+		for (const ObserverEntry& entry : addedObservers)
+			if (entry.observer == observer)
+				return;
+
+		ObserverEntry entry = { observer, events, priority };
+		if (notificationDepth > 0)
+			// the list is being walked: add the observer later
+			addedObservers.push_back(entry);
+		else
+			insertObserver(entry);
 	}
 
 	void Subject::removeObserver(Observer* const observer)
 	{
-		// remove the observer from the list
-		observers.erase(observer);
+		// the observer might have been added during the current notification
+		for (std::vector<ObserverEntry>::iterator it = addedObservers.begin(); it != addedObservers.end(); it++)
+			if (it->observer == observer)
+			{
+				addedObservers.erase(it);
+				return;
+			}
+
+		for (std::vector<ObserverEntry>::iterator it = observers.begin(); it != observers.end(); it++)
+			if (it->observer == observer)
+			{
+				if (notificationDepth > 0)
+				{
+					// the list is being walked: mark the observer as removed, it is erased later
+					it->observer = nullptr;
+					removedObservers = true;
+				}
+				else
+					observers.erase(it);
+				return;
+			}
+	}
+
+	size_t Subject::getNumberOfObservers() const
+	{
+		size_t n = addedObservers.size();
+		for (const ObserverEntry& entry : observers)
+			if (entry.observer)
+				n++;
+		return n;
+	}
+
+	void Subject::insertObserver(const ObserverEntry& entry)
+	{
+		std::vector<ObserverEntry>::iterator it = observers.begin();
+		while (it != observers.end() && it->priority >= entry.priority)
+			it++;
+		observers.insert(it, entry);
 	}
 
-	util::Expected<void> Subject::notify(const int event) const
+	void Subject::applyChanges()
+	{
+		if (removedObservers)
+		{
+			std::vector<ObserverEntry>::iterator last = observers.begin();
+			for (std::vector<ObserverEntry>::iterator it = observers.begin(); it != observers.end(); it++)
+				if (it->observer)
+					*last++ = *it;
+			observers.erase(last, observers.end());
+			removedObservers = false;
+		}
+
+		for (const ObserverEntry& entry : addedObservers)
+			insertObserver(entry);
+		addedObservers.clear();
+	}
+
+	util::Expected<void> Subject::notify(const int event)
 	{
 		util::Expected<void> notificationResult;
+		const uint64_t bit = eventBit(event);
 
-		for (auto x : observers)
+		// observers added during notification are appended to a separate list, thus the size of the list does not change
+		notificationDepth++;
+		const size_t nObservers = observers.size();
+		for (size_t i = 0; i < nObservers; i++)
 		{
-			notificationResult = x->onNotify(event);
+			const ObserverEntry& entry = observers[i];
+			if (entry.observer == nullptr || !(entry.events & bit || entry.events == allEvents))
+				continue;
+
+			notificationResult = entry.observer->onNotify(event);
 			if (!notificationResult.isValid())
-				return notificationResult;
+				break;
 		}
+		notificationDepth--;
+
+		if (notificationDepth == 0)
+			applyChanges();
+
+		if (!notificationResult.isValid())
+			return notificationResult;
 
 		return { };
 	}
-}
\ No newline at end of file
+}
@@ -6,13 +6,15 @@
 *
 * Desc:		The Observer pattern
 *
-* History:
+* History:	- 08/09/2019: flat list of observers, ordered by priority, then by insertion; observers can be added or removed during
+*						  notification and only receive the events they registered for
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
 
 // c++ includes
-#include <unordered_set>
+#include <vector>
+#include <cstdint>
 
 // bell0bytes util
 #include "expected.h"
@@ -39,20 +41,39 @@ namespace util
 	class Subject
 	{
 	private:
-		std::unordered_set<Observer*> observers;					// a set of observers				
+		struct ObserverEntry
+		{
+			Observer* observer;						// the observer, null if it was removed during notification
+			uint64_t events;						// the events the observer is interested in
+			int priority;							// observers with a higher priority are notified first
+		};
+
+		std::vector<ObserverEntry> observers;		// the observers, in the order they are notified
+		std::vector<ObserverEntry> addedObservers;	// the observers that were added during notification
+		unsigned int notificationDepth;				// the number of notifications in progress, notifications might be nested
+		bool removedObservers;						// true iff observers were removed during notification
+
+		void insertObserver(const ObserverEntry& entry);	// inserts the observer after all observers with the same or a higher priority
+		void applyChanges();						// applies the changes made during notification
 
 	protected:
-		Expected<void> notify(const int) const;
+		Expected<void> notify(const int);
 
 	public:
-		Subject() {};
+		static const uint64_t allEvents = ~(uint64_t)0;
+
+		// the filter bit of an event; events outside of [0, 63] are only received by observers registered for all events
+		static uint64_t eventBit(const int event) { return (event >= 0 && event < 64) ? (uint64_t)1 << event : 0; };
+
+		Subject() : notificationDepth(0), removedObservers(false) {};
 		~Subject() {};
 
 		// add or remove observers
-		void addObserver(Observer* const observer);
+		// during notification, new observers are added once the notification is completed, removed observers are not notified anymore
+		void addObserver(Observer* const observer, const uint64_t events = allEvents, const int priority = 0);
 		void removeObserver(Observer* const observer);
 
 		// get number of observers (for debugging)
-		auto getNumberOfObservers() { return observers.size(); };
+		size_t getNumberOfObservers() const;
 	};
 }
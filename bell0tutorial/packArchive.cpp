@@ -0,0 +1,312 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// the header
+#include "packArchive.h"
+
+// c++ includes
+#include <cstring>
+#include <cwctype>
+#include <stdexcept>
+#include <algorithm>
+
+// bell0bytes util
+#include "compression.h"
+
+#ifdef _WIN32
+// windows includes
+#include <Windows.h>
+#else
+// posix includes
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <filesystem>
+#endif
+
+namespace fileSystem
+{
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// Names ///////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	namespace pack
+	{
+		std::string normalizeName(const std::wstring& name)
+		{
+			std::string normalizedName;
+			normalizedName.reserve(name.size());
+
+			for (size_t i = 0; i < name.size(); i++)
+			{
+				uint32_t c = (uint32_t)std::towlower(name[i]);
+				if (c == L'\\')
+					c = L'/';
+
+				// no leading separators
+				if (c == L'/' && normalizedName.empty())
+					continue;
+
+				// combine surrogate pairs (wide strings are UTF-16 on Windows)
+				if (c >= 0xD800 && c < 0xDC00 && i + 1 < name.size() && (uint32_t)name[i + 1] >= 0xDC00 && (uint32_t)name[i + 1] < 0xE000)
+					c = 0x10000 + ((c - 0xD800) << 10) + ((uint32_t)name[++i] - 0xDC00);
+
+				// UTF-8
+				if (c < 0x80)
+					normalizedName += (char)c;
+				else if (c < 0x800)
+				{
+					normalizedName += (char)(0xC0 | (c >> 6));
+					normalizedName += (char)(0x80 | (c & 0x3F));
+				}
+				else if (c < 0x10000)
+				{
+					normalizedName += (char)(0xE0 | (c >> 12));
+					normalizedName += (char)(0x80 | ((c >> 6) & 0x3F));
+					normalizedName += (char)(0x80 | (c & 0x3F));
+				}
+				else
+				{
+					normalizedName += (char)(0xF0 | (c >> 18));
+					normalizedName += (char)(0x80 | ((c >> 12) & 0x3F));
+					normalizedName += (char)(0x80 | ((c >> 6) & 0x3F));
+					normalizedName += (char)(0x80 | (c & 0x3F));
+				}
+			}
+
+			return normalizedName;
+		}
+
+		uint64_t hashName(const std::string& normalizedName)
+		{
+			uint64_t hash = 14695981039346656037ull;
+			for (const char c : normalizedName)
+			{
+				hash ^= (uint8_t)c;
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// Mapped Files ////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	MappedFile::MappedFile() : data(nullptr), size(0)
+	{
+#ifdef _WIN32
+		fileHandle = INVALID_HANDLE_VALUE;
+		mappingHandle = NULL;
+#endif
+	}
+
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	util::Expected<void> MappedFile::open(const std::wstring& file)
+	{
+		close();
+
+#ifdef _WIN32
+		fileHandle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (fileHandle == INVALID_HANDLE_VALUE)
+			return std::runtime_error("Unable to open the file!");
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(fileHandle, &fileSize))
+		{
+			close();
+			return std::runtime_error("Unable to get the size of the file!");
+		}
+		size = (size_t)fileSize.QuadPart;
+
+		// empty files can not be mapped
+		if (size == 0)
+			return { };
+
+		mappingHandle = CreateFileMappingW(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (mappingHandle == NULL)
+		{
+			close();
+			return std::runtime_error("Unable to map the file into memory!");
+		}
+
+		data = static_cast<const uint8_t*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+		if (data == nullptr)
+		{
+			close();
+			return std::runtime_error("Unable to map the file into memory!");
+		}
+#else
+		const int handle = ::open(std::filesystem::path(file).c_str(), O_RDONLY | O_CLOEXEC);
+		if (handle < 0)
+			return std::runtime_error("Unable to open the file!");
+
+		struct stat status;
+		if (fstat(handle, &status) != 0)
+		{
+			::close(handle);
+			return std::runtime_error("Unable to get the size of the file!");
+		}
+		size = (size_t)status.st_size;
+
+		// empty files can not be mapped
+		if (size == 0)
+		{
+			::close(handle);
+			return { };
+		}
+
+		// the mapping stays valid once the file is closed
+		void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, handle, 0);
+		::close(handle);
+		if (mapping == MAP_FAILED)
+		{
+			size = 0;
+			return std::runtime_error("Unable to map the file into memory!");
+		}
+		data = static_cast<const uint8_t*>(mapping);
+#endif
+
+		// return success
+		return { };
+	}
+
+	void MappedFile::close()
+	{
+#ifdef _WIN32
+		if (data != nullptr)
+			UnmapViewOfFile(data);
+		if (mappingHandle != NULL)
+			CloseHandle(mappingHandle);
+		if (fileHandle != INVALID_HANDLE_VALUE)
+			CloseHandle(fileHandle);
+		mappingHandle = NULL;
+		fileHandle = INVALID_HANDLE_VALUE;
+#else
+		if (data != nullptr)
+			munmap(const_cast<uint8_t*>(data), size);
+#endif
+		data = nullptr;
+		size = 0;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// Mount ///////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	util::Expected<void> PackArchive::mount(const std::wstring& file)
+	{
+		unmount();
+
+		std::shared_ptr<MappedFile> mappedFile = std::make_shared<MappedFile>();
+		util::Expected<void> result = mappedFile->open(file);
+		if (!result.isValid())
+			return result;
+
+		// validate the header
+		const uint8_t* const data = mappedFile->getData();
+		const uint64_t size = mappedFile->getSize();
+		if (size < sizeof(pack::Header))
+			return std::runtime_error("The pack archive is too small!");
+
+		const pack::Header* header = reinterpret_cast<const pack::Header*>(data);
+		if (std::memcmp(header->magic, pack::magic, sizeof(pack::magic)) != 0 || header->version != pack::version)
+			return std::runtime_error("The file is not a pack archive of this version!");
+
+		if (header->tocOffset > size || header->nEntries > (size - header->tocOffset) / sizeof(pack::Entry) || header->namesOffset > size || header->namesOffset < header->tocOffset + (uint64_t)header->nEntries * sizeof(pack::Entry))
+			return std::runtime_error("The table of contents of the pack archive is corrupt!");
+
+		// validate the entries once, such that reading a file never leaves the archive
+		const pack::Entry* toc = reinterpret_cast<const pack::Entry*>(data + header->tocOffset);
+		const uint64_t namesSize = size - header->namesOffset;
+		for (uint32_t i = 0; i < header->nEntries; i++)
+		{
+			const pack::Entry& entry = toc[i];
+			const bool validData = entry.offset <= header->tocOffset && entry.packedSize <= header->tocOffset - entry.offset;
+			const bool validName = (uint64_t)entry.nameOffset + entry.nameLength <= namesSize;
+			const bool validCompression = entry.compression == pack::Stored ? entry.packedSize == entry.size : entry.compression == pack::Compressed;
+			const bool sorted = i == 0 || toc[i - 1].hash <= entry.hash;
+			if (!validData || !validName || !validCompression || !sorted)
+				return std::runtime_error("The table of contents of the pack archive is corrupt!");
+		}
+
+		archive = mappedFile;
+		entries = toc;
+		nEntries = header->nEntries;
+		names = reinterpret_cast<const char*>(data + header->namesOffset);
+
+		// return success
+		return { };
+	}
+
+	void PackArchive::unmount()
+	{
+		archive.reset();
+		entries = nullptr;
+		nEntries = 0;
+		names = nullptr;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// Read Files //////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	const pack::Entry* PackArchive::findEntry(const std::wstring& name) const
+	{
+		if (!archive)
+			return nullptr;
+
+		const std::string normalizedName = pack::normalizeName(name);
+		const uint64_t hash = pack::hashName(normalizedName);
+
+		// binary search, then compare the names of the entries with the same hash
+		const pack::Entry* entry = std::lower_bound(entries, entries + nEntries, hash, [](const pack::Entry& e, const uint64_t h) { return e.hash < h; });
+		for (; entry != entries + nEntries && entry->hash == hash; entry++)
+			if (entry->nameLength == normalizedName.size() && std::memcmp(names + entry->nameOffset, normalizedName.data(), normalizedName.size()) == 0)
+				return entry;
+
+		return nullptr;
+	}
+
+	bool PackArchive::contains(const std::wstring& name) const
+	{
+		return findEntry(name) != nullptr;
+	}
+
+	util::Expected<void> PackArchive::readFile(const std::wstring& name, FileData& fileData) const
+	{
+		const pack::Entry* entry = findEntry(name);
+		if (entry == nullptr)
+			return std::runtime_error("The file is not in the pack archive!");
+
+		return readEntry(*entry, fileData);
+	}
+
+	util::Expected<void> PackArchive::readEntry(const pack::Entry& entry, FileData& fileData) const
+	{
+		if (!archive)
+			return std::runtime_error("The pack archive is not mounted!");
+
+		const uint8_t* packedData = archive->getData() + entry.offset;
+
+		// stored files are views into the archive
+		if (entry.compression == pack::Stored)
+		{
+			fileData = FileData(packedData, (size_t)entry.size, archive);
+			return { };
+		}
+
+		// compressed files are decompressed on demand
+		std::shared_ptr<std::vector<uint8_t> > buffer;
+		try { buffer = std::make_shared<std::vector<uint8_t> >((size_t)entry.size); }
+		catch (std::exception& e) { return e; }
+
+		if (!util::decompressBlock(packedData, (size_t)entry.packedSize, buffer->data(), buffer->size()))
+			return std::runtime_error("The file in the pack archive is corrupt!");
+
+		fileData = FileData(buffer->data(), buffer->size(), buffer);
+
+		// return success
+		return { };
+	}
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		16/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		pack archives: all data files in a single file, which is mapped into memory
+*			the table of contents is sorted by the hashes of the normalized file names (lower case, '/' as separator, relative
+*			to the data folder), thus a file is found with a binary search, without touching the disk
+*			uncompressed files are returned as views into the mapped archive, without any copy; compressed files (see compression.h)
+*			are decompressed when they are read
+*			the archives are built by the packer tool (tools/packer)
+*
+*			layout (little endian): header | file data | table of contents | names
+*
+* History:	- 18/09/2019: the entries can be looked up once and then read without a search
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// bell0bytes util
+#include "expected.h"
+
+// DEFINITIONS //////////////////////////////////////////////////////////////////////////
+namespace fileSystem
+{
+	namespace pack
+	{
+		const char magic[4] = { 'b', '0', 'p', 'k' };
+		const uint32_t version = 1;
+
+		enum Compression : uint32_t { Stored = 0, Compressed = 1 };
+
+		#pragma pack(push, 1)
+		struct Header
+		{
+			char magic[4];
+			uint32_t version;
+			uint32_t nEntries;
+			uint32_t reserved;
+			uint64_t tocOffset;			// the table of contents, sorted by hash
+			uint64_t namesOffset;		// the normalized names, in UTF-8
+		};
+
+		struct Entry
+		{
+			uint64_t hash;				// the hash of the normalized name
+			uint64_t offset;			// the position of the data in the archive
+			uint64_t size;				// the size of the file
+			uint64_t packedSize;		// the size of the data in the archive
+			uint32_t nameOffset;		// the position of the name, relative to the names
+			uint32_t nameLength;
+			uint32_t compression;
+			uint32_t reserved;
+		};
+		#pragma pack(pop)
+
+		static_assert(sizeof(Header) == 32 && sizeof(Entry) == 48, "The layout of the pack archives must not change!");
+
+		// the name of a file in the archive: relative to the data folder, lower case, '/' as separator, UTF-8
+		std::string normalizeName(const std::wstring& name);
+
+		// 64-bit FNV-1a
+		uint64_t hashName(const std::string& normalizedName);
+	}
+
+	// CLASSES //////////////////////////////////////////////////////////////////////////////
+
+	// a read-only file mapped into memory
+	class MappedFile
+	{
+	private:
+		const uint8_t* data;
+		size_t size;
+#ifdef _WIN32
+		void* fileHandle;
+		void* mappingHandle;
+#endif
+
+	public:
+		MappedFile();
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		util::Expected<void> open(const std::wstring& file);
+		void close();
+
+		const uint8_t* getData() const { return data; };
+		size_t getSize() const { return size; };
+	};
+
+	// the contents of a file: a view into a mapped file, or a buffer holding decompressed data
+	class FileData
+	{
+	private:
+		const uint8_t* data;
+		size_t size;
+		std::shared_ptr<const void> owner;		// keeps the mapped file or the buffer alive
+
+	public:
+		FileData() : data(nullptr), size(0), owner() {};
+		FileData(const uint8_t* data, const size_t size, std::shared_ptr<const void> owner) : data(data), size(size), owner(std::move(owner)) {};
+
+		const uint8_t* getData() const { return data; };
+		size_t getSize() const { return size; };
+		bool isEmpty() const { return size == 0; };
+	};
+
+	class PackArchive
+	{
+	private:
+		std::shared_ptr<MappedFile> archive;	// shared with the views into the archive
+		const pack::Entry* entries;				// the table of contents, in the mapped archive
+		uint32_t nEntries;
+		const char* names;
+
+	public:
+		PackArchive() : archive(), entries(nullptr), nEntries(0), names(nullptr) {};
+
+		// maps the archive into memory and validates the table of contents
+		util::Expected<void> mount(const std::wstring& file);
+		void unmount();
+		bool isMounted() const { return archive != nullptr; };
+
+		// the name is relative to the data folder, i.e. Artwork\Cursors\cursorHand.png
+		bool contains(const std::wstring& name) const;
+		util::Expected<void> readFile(const std::wstring& name, FileData& fileData) const;
+
+		// the entries stay valid while the archive is mounted, thus they can be looked up once and then read without a search
+		const pack::Entry* findEntry(const std::wstring& name) const;
+		util::Expected<void> readEntry(const pack::Entry& entry, FileData& fileData) const;
+
+		uint32_t getNumberOfFiles() const { return nEntries; };
+	};
+}
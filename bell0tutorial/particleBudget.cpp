@@ -0,0 +1,111 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// C++ includes
+#include <algorithm>
+#include <sstream>
+
+// the header
+#include "particleBudget.h"
+
+// bell0bytes mathematics
+#include "geometry.h"
+
+// bell0bytes util
+#include "serviceLocator.h"
+#include "logFilter.h"
+
+namespace physics
+{
+	namespace particles
+	{
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// SPAWNING ////////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		SpawnGrant ParticleBudget::requestSpawn(const EmitterPriority priority, const unsigned int desiredParticles, const mathematics::linearAlgebra::Vector2F& position)
+		{
+			SpawnGrant grant = { 0, 0.0f };
+
+			// under heavy load, purely decorative emitters are dropped
+			if (priority == EmitterPriority::Low && load < lowPriorityLoad)
+			{
+				droppedEmitters++;
+				return grant;
+			}
+
+			// the number of particles still available in the global budget
+			unsigned int available = (unsigned int)(maxParticles * (priority == EmitterPriority::High ? 1.0f : load));
+			if (aliveParticles >= available)
+			{
+				droppedEmitters++;
+				return grant;
+			}
+			available -= aliveParticles;
+
+			// level of detail: emitters far away from the focus get fewer and smaller particles
+			float distance = mathematics::geometry::distance2D(position, focus);
+			float detail = std::max(minDetail, 1.0f - distance / lodDistance);
+
+			// high priority emitters are not affected by the load
+			if (priority != EmitterPriority::High)
+				detail *= load;
+
+			// grant the request
+			grant.detail = std::max(minLoad * minDetail, detail);
+			grant.nParticles = std::min(available, (unsigned int)(desiredParticles * grant.detail));
+			if (grant.nParticles == 0)
+			{
+				droppedEmitters++;
+				return grant;
+			}
+
+			aliveParticles += grant.nParticles;
+			grantedEmitters++;
+			return grant;
+		}
+
+		void ParticleBudget::releaseParticles(const unsigned int n)
+		{
+			aliveParticles = n > aliveParticles ? 0 : aliveParticles - n;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// GOVERNOR ////////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		void ParticleBudget::reportFrameTime(const double milliseconds)
+		{
+			// smooth the frame time to not react to single spikes
+			if (smoothedFrameTime == 0.0)
+				smoothedFrameTime = milliseconds;
+			else
+				smoothedFrameTime += 0.1 * (milliseconds - smoothedFrameTime);
+
+			// reduce the load quickly if the frame takes too long, recover slowly once there is headroom again
+			if (smoothedFrameTime > targetFrameTime)
+				load = std::max(minLoad, load - 0.05f);
+			else if (smoothedFrameTime < 0.9 * targetFrameTime)
+				load = std::min(1.0f, load + 0.01f);
+
+			// report once per second
+			telemetryTime += milliseconds;
+			if (telemetryTime >= 1000.0)
+			{
+				printTelemetry();
+				telemetryTime = 0.0;
+				grantedEmitters = 0;
+				droppedEmitters = 0;
+			}
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// TELEMETRY ///////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		void ParticleBudget::printTelemetry()
+		{
+			// only print something if there were particles to govern
+			if (aliveParticles == 0 && grantedEmitters == 0 && droppedEmitters == 0)
+				return;
+
+			LOG_DEBUG(PhysicsLog, "Particle budget: frame time %g ms (target: %g ms), load: %g, particles: %u/%u, emitters granted: %u, emitters dropped: %u", smoothedFrameTime, targetFrameTime, load, aliveParticles, maxParticles, grantedEmitters, droppedEmitters);
+		}
+	}
+}
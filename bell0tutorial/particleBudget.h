@@ -0,0 +1,101 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		26/08/2019 - Lenningen - Luxembourg
+*
+* Desc:		a global budget for all particle systems
+*			the governor observes the frame time and scales the number, the width and the lifetime of
+*			newly spawned particles down when the frame takes longer than the target; low priority
+*			emitters are dropped entirely under heavy load
+*
+* History:
+*
+* ToDo:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// bell0bytes mathematics
+#include "vectors.h"
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace physics
+{
+	namespace particles
+	{
+		// the priority of a particle emitter
+		// - low: purely decorative, dropped first
+		// - normal: scaled with the load of the system
+		// - high: gameplay relevant, only limited by the global budget
+		enum EmitterPriority { Low, Normal, High };
+
+		// the result of a spawn request
+		struct SpawnGrant
+		{
+			unsigned int nParticles;			// the number of particles the emitter is allowed to spawn
+			float detail;						// scales the width and lifetime of the particles, between 0 and 1
+		};
+
+		// Particle Budget - Singleton
+		class ParticleBudget
+		{
+		private:
+			// budget
+			unsigned int maxParticles = 5000;		// the maximal number of particles alive at the same time
+			unsigned int aliveParticles = 0;		// the number of particles currently alive
+
+			// frame time
+			double targetFrameTime = 8.0;			// the frame time the governor tries to hold (in milliseconds)
+			double smoothedFrameTime = 0.0;			// exponential moving average of the frame time (in milliseconds)
+			float load = 1.0f;						// the fraction of the budget currently available, between minLoad and 1
+			const float minLoad = 0.1f;				// the load never drops below this value
+			const float lowPriorityLoad = 0.5f;		// below this load, low priority emitters are dropped
+
+			// level of detail
+			mathematics::linearAlgebra::Vector2F focus;		// the point of interest, i.e. the paddle
+			float lodDistance = 1000.0f;			// the distance at which the level of detail reaches its minimum (in pixels)
+			const float minDetail = 0.25f;			// the minimal level of detail due to distance
+
+			// telemetry
+			unsigned int grantedEmitters = 0;		// the number of emitters allowed to spawn since the last report
+			unsigned int droppedEmitters = 0;		// the number of emitters dropped since the last report
+			double telemetryTime = 0.0;				// the time since the last report (in milliseconds)
+			void printTelemetry();					// prints the statistics of the governor to the log file
+
+		protected:
+			// protected constructor -> singleton
+			ParticleBudget() {};
+
+		public:
+			// create a single instance
+			static ParticleBudget& getInstance()
+			{
+				static ParticleBudget instance;
+				return instance;
+			};
+
+			// delete copy and assignment operators
+			ParticleBudget(ParticleBudget const&) = delete;
+			ParticleBudget& operator = (ParticleBudget const&) = delete;
+
+			// spawning and dying
+			SpawnGrant requestSpawn(const EmitterPriority priority, const unsigned int desiredParticles, const mathematics::linearAlgebra::Vector2F& position);	// asks the governor how many particles an emitter at the given position may spawn
+			void releaseParticles(const unsigned int n);		// must be called when particles die
+
+			// feed the governor, called once per frame
+			void reportFrameTime(const double milliseconds);
+
+			// getters
+			unsigned int getAliveParticles() const { return aliveParticles; };
+			float getLoad() const { return load; };
+			double getSmoothedFrameTime() const { return smoothedFrameTime; };
+
+			// setters
+			void setMaxParticles(const unsigned int mp) { maxParticles = mp; };
+			void setTargetFrameTime(const double ms) { targetFrameTime = ms; };
+			void setFocus(const mathematics::linearAlgebra::Vector2F& f) { focus = f; };
+			void setLODDistance(const float d) { lodDistance = d; };
+		};
+	}
+}
@@ -1,5 +1,6 @@
 #include "particleSystem.h"
 #include "kinematics.h"
+#include "collisionGrid.h"
 #include <cmath>
 
 namespace physics
@@ -9,22 +10,27 @@ namespace physics
 		/////////////////////////////////////////////////////////////////////////////////////////
 		/////////////////////////////////// PARTICLE ////////////////////////////////////////////
 		/////////////////////////////////////////////////////////////////////////////////////////
-		Particle::Particle() : position(0.0f, 0.0f), velocity(0.0f, 0.0f), acceleration(0.0f, 0.0f), age(0), colour(L"Black")
+		Particle::Particle() : position(0.0f, 0.0f), velocity(0.0f, 0.0f), acceleration(0.0f, 0.0f), age(0), brush(0)
 		{
 			// add environment variables
 			acceleration = Environment::getInstance().getGravity() + Environment::getInstance().getWind();
 		}
 
-		Particle::Particle(const mathematics::linearAlgebra::Vector2F& pos, const mathematics::linearAlgebra::Vector2F& vel, const mathematics::linearAlgebra::Vector2F& acc, const float ag, const std::wstring& col, const float width) : position(pos), velocity(vel), acceleration(acc), age(ag), colour(col), width(width)
+		Particle::Particle(const mathematics::linearAlgebra::Vector2F& pos, const mathematics::linearAlgebra::Vector2F& vel, const mathematics::linearAlgebra::Vector2F& acc, const float ag, const std::wstring& col, const float width) : position(pos), velocity(vel), acceleration(acc), age(ag), brush(graphics::BrushHandles::getInstance().getHandle(col)), width(width)
 		{
 			// add environment variables
 			acceleration += Environment::getInstance().getGravity() - Environment::getInstance().getWind();
 		}
 
-		void Particle::update(double deltaTime,float maxLifeSpan)
+		void Particle::update(double deltaTime, float maxLifeSpan, const CollisionGrid* const grid, const float restitution)
 		{
 			// update position and velocity
+			mathematics::linearAlgebra::Vector2F previousPosition = position;
 			physics::Kinematics::semiImplicitEuler(position, velocity, acceleration, deltaTime);
+
+			// bounce off the game world
+			if (grid)
+				grid->collide(position, velocity, previousPosition, restitution);
 			
 			// update the age and intensity
 			age += 0.1f;
@@ -35,21 +41,82 @@ namespace physics
 		/////////////////////////////////////////////////////////////////////////////////////////
 		Environment::Environment() : gravity(mathematics::linearAlgebra::Vector2F(0.0f, 9.81f)), wind(mathematics::linearAlgebra::Vector2F(7.5f, -1.0f)) {};
 
+		mathematics::linearAlgebra::Vector2F Environment::getWind(const mathematics::linearAlgebra::Vector2F& position) const
+		{
+			if (!hasTurbulence())
+				return wind;
+
+			float vx, vy;
+			noise.curl2D(position.x * turbulenceScale, position.y * turbulenceScale, (float)(time * turbulenceSpeed), vx, vy);
+			return mathematics::linearAlgebra::Vector2F(wind.x + turbulence * vx, wind.y + turbulence * vy);
+		}
+
+		void Environment::getTurbulence(const float* const x, const float* const y, float* const ax, float* const ay, const size_t n) const
+		{
+			// the curl noise expects the coordinates in noise space, the results are scaled in place
+			for (size_t i = 0; i < n; i++)
+			{
+				ax[i] = x[i] * turbulenceScale;
+				ay[i] = y[i] * turbulenceScale;
+			}
+			noise.curl2D(ax, ay, (float)(time * turbulenceSpeed), ax, ay, n);
+			for (size_t i = 0; i < n; i++)
+			{
+				ax[i] *= turbulence;
+				ay[i] *= turbulence;
+			}
+		}
+
 		/////////////////////////////////////////////////////////////////////////////////////////
 		/////////////////////////////////// PARTICLE SYSTEM /////////////////////////////////////
 		/////////////////////////////////////////////////////////////////////////////////////////
-		void ParticleSystem::draw(double /*farSeer*/) const
+		std::atomic<uint64_t> ParticleSystem::nextEmitterID(0);
+
+		ParticleSystem::~ParticleSystem()
 		{
-			// draw particles
-			for (auto particle : particles)
+			ParticleBudget::getInstance().releaseParticles(nParticles());
+		}
+
+		void ParticleSystem::applyTurbulence(const double deltaTime)
+		{
+			const Environment& environment = Environment::getInstance();
+			if (!environment.hasTurbulence() || particles.empty())
+				return;
+
+			// gather the positions as structure of arrays to evaluate the noise in batches
+			const size_t n = particles.size();
+			for (auto& v : soa)
+				v.resize(n);
+			for (size_t i = 0; i < n; i++)
+			{
+				soa[0][i] = particles[i].position.x;
+				soa[1][i] = particles[i].position.y;
+			}
+
+			environment.getTurbulence(soa[0].data(), soa[1].data(), soa[2].data(), soa[3].data(), n);
+
+			// the acceleration only lasts for this frame, thus it is applied to the velocity directly
+			for (size_t i = 0; i < n; i++)
 			{
-				if(particle.colour == L"Black")
-					gc.fillRectangle(particle.position.x - particle.width, particle.position.y - particle.width, particle.position.x + particle.width, particle.position.y + particle.width, particle.intensity);
-				else
-					gc.fillRectangle(particle.position.x - particle.width, particle.position.y - particle.width, particle.position.x + particle.width, particle.position.y + particle.width, particle.intensity, &gc.getBrush(particle.colour));
+				particles[i].velocity.x += (float)(soa[2][i] * deltaTime);
+				particles[i].velocity.y += (float)(soa[3][i] * deltaTime);
 			}
 		}
 
+		void ParticleSystem::draw(double /*farSeer*/) const
+		{
+			// collect the quads of the current frame and submit one batch per brush
+			batch.clear();
+			writeQuads(batch);
+			batch.submit(gc);
+		}
+
+		void ParticleSystem::writeQuads(graphics::QuadBatch& quadBatch) const
+		{
+			for (const auto& particle : particles)
+				quadBatch.add(particle.brush, particle.position.x - particle.width, particle.position.y - particle.width, particle.position.x + particle.width, particle.position.y + particle.width, particle.intensity);
+		}
+
 		unsigned int ParticleSystem::nParticles() const
 		{
 			return (unsigned int)this->particles.size();
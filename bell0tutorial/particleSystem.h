@@ -7,6 +7,11 @@
 * Desc:		this class defines a basic particle system
 *
 * History:	- 23/07/2019: basics
+*			- 24/08/2019: particles are drawn as a batch of quads grouped by brush
+*			- 26/08/2019: particle systems are governed by a global particle budget
+*			- 28/08/2019: optional collisions with the game world
+*			- 01/09/2019: each system has a unique id to key its counter-based random numbers
+*			- 02/09/2019: turbulent wind from curl noise
 *
 * ToDo:
 ****************************************************************************************/
@@ -16,9 +21,14 @@
 // C++ includes
 #include <string>
 #include <vector>
+#include <atomic>
+#include <cstdint>
 
 // bell0bytes includes
 #include "vectors.h"
+#include "noise.h"
+#include "quadBatch.h"
+#include "particleBudget.h"
 #include "graphicsComponent2D.h"
 #include "app.h"
 
@@ -34,6 +44,8 @@ namespace mathematics
 
 namespace physics
 {
+	class CollisionGrid;
+
 	namespace particles
 	{
 		// a single particle
@@ -44,7 +56,7 @@ namespace physics
 			mathematics::linearAlgebra::Vector2F velocity;				// the velocity vector
 			mathematics::linearAlgebra::Vector2F acceleration;			// the acceleration vector, depends on environmental factors
 			float age;									// the age of the particle; a particle is deleted once its age surpasses the maximal lifespan defined by the particle system
-			std::wstring colour;						// the colour of the particle
+			graphics::BrushHandle brush;				// the handle of the brush with the colour of the particle
 			float intensity = 1.0f;						// the intensity diminishes as the particle nears the end of its life
 			float width = 1.0f;							// the width of each particle
 
@@ -54,7 +66,7 @@ namespace physics
 			Particle(const mathematics::linearAlgebra::Vector2F& position, const mathematics::linearAlgebra::Vector2F& velocity, const mathematics::linearAlgebra::Vector2F& acc, const float age = 0.0f, const std::wstring& colour = L"Black", const float width = 1.0f);
 
 			// update
-			void update(double deltaTime, float maxLifeSpan);		// returns false iff the particle should be destroyed (for example, because its lifespan is reached)
+			void update(double deltaTime, float maxLifeSpan, const CollisionGrid* const grid = nullptr, const float restitution = 0.5f);		// if a collision grid is given, the particle bounces off solid cells
 
 			// getters
 			float getAge() const { return age; };
@@ -74,6 +86,13 @@ namespace physics
 			mathematics::linearAlgebra::Vector2F gravity;				// force due to gravity
 			mathematics::linearAlgebra::Vector2F wind;					// force due to wind
 
+			// turbulence: a divergence-free flow added to the wind, varying over space and time
+			mathematics::noise::SimplexNoise noise;			// the noise field
+			float turbulence = 0.0f;						// the strength of the turbulence, no turbulence if zero
+			float turbulenceScale = 0.005f;					// the spatial frequency of the turbulence (per pixel)
+			float turbulenceSpeed = 0.25f;					// the rate at which the turbulence changes (per second)
+			double time = 0.0;								// the time of the environment
+
 		protected:
 			// protected constructor -> singleton
 			Environment();
@@ -94,10 +113,19 @@ namespace physics
 			// getters
 			mathematics::linearAlgebra::Vector2F getGravity() const { return gravity; };
 			mathematics::linearAlgebra::Vector2F getWind() const { return wind; };
+			mathematics::linearAlgebra::Vector2F getWind(const mathematics::linearAlgebra::Vector2F& position) const;	// the wind at the given position, including the turbulence
+			bool hasTurbulence() const { return turbulence != 0.0f; };
 
 			// setters
 			void setGravity(mathematics::linearAlgebra::Vector2F& grav) { gravity = grav; };
 			void setWind(mathematics::linearAlgebra::Vector2F& wi) { wind = wi; };
+			void setTurbulence(const float strength, const float scale = 0.005f, const float speed = 0.25f) { turbulence = strength; turbulenceScale = scale; turbulenceSpeed = speed; };
+
+			// advance the time of the environment, called once per frame
+			void update(const double deltaTime) { time += deltaTime; };
+
+			// computes the turbulent accelerations for a batch of positions, stored as separate arrays
+			void getTurbulence(const float* const x, const float* const y, float* const ax, float* const ay, const size_t n) const;
 		};
 
 		// abstract particle system class
@@ -107,6 +135,7 @@ namespace physics
 		private:
 			unsigned int maxParticles = 150;				// the maximal number of particles
 			float maxLifeSpan = 2500.0f;					// the maximal lifespan of a particle
+			static std::atomic<uint64_t> nextEmitterID;		// the id of the next particle system
 
 		protected:
 			core::DirectXApp& dxApp;							// the DirectXApp
@@ -115,6 +144,12 @@ namespace physics
 			std::vector<Particle> particles;					// the array containing the actual particles in the system
 			bool regenerate = false;							// true iff the particles shoul regenerate over time (think of a water fountain)
 			mathematics::linearAlgebra::Vector2F position;					// central position of the particle system
+			mutable graphics::QuadBatch batch;					// the quads of the current frame, grouped by brush
+			const EmitterPriority priority;						// the priority of the system in the global particle budget
+			const CollisionGrid* collisionGrid = nullptr;		// the game world to collide with, no collisions if null
+			float restitution = 0.5f;							// the fraction of the velocity kept after a collision
+			std::vector<float> soa[4];							// scratch arrays: the positions and accelerations of the particles as structure of arrays
+			const uint64_t emitterID;							// unique id, given in order of creation; the random numbers of the system only depend on the seed and this id
 
 			virtual void GenerateParticle(const mathematics::linearAlgebra::Vector2F& position, mathematics::linearAlgebra::Vector2F& velocity, const mathematics::linearAlgebra::Vector2F& acceleration, const float age = 0.0f, const std::wstring& colour = L"Black", const float width = 1.0f) = 0;
 
@@ -122,11 +157,20 @@ namespace physics
 			void setMaxParticles(unsigned int mp) { maxParticles = mp; };
 			void setMaxLifeSpan(float mls) { maxLifeSpan = mls; };
 
+			// environment
+			void applyTurbulence(const double deltaTime);		// accelerates each particle by the turbulence at its position
+
 		public:
-			ParticleSystem(core::DirectXApp& app, const graphics::GraphicsComponent2D& gc) : dxApp(app), gc(gc), nt(dxApp.getNumberTheoryComponent()) {};
+			ParticleSystem(core::DirectXApp& app, const graphics::GraphicsComponent2D& gc, const EmitterPriority priority = EmitterPriority::Normal) : dxApp(app), gc(gc), nt(dxApp.getNumberTheoryComponent()), priority(priority), emitterID(nextEmitterID++) {};
+			virtual ~ParticleSystem();						// returns the remaining particles to the budget
 
 			virtual bool update(double deltaTime) = 0;		// returns false iff there are no more particles alive in the system
 			virtual void draw(double farSeer) const;		// render the particles
+			void writeQuads(graphics::QuadBatch& quadBatch) const;	// adds one quad per particle to the batch; allows several systems to share a single batch
+
+			// collisions
+			void enableCollisions(const CollisionGrid& grid, const float restitution = 0.5f) { collisionGrid = &grid; this->restitution = restitution; };
+			void disableCollisions() { collisionGrid = nullptr; };
 
 			unsigned int nParticles() const;				// returns the number of particles in the system
 			float getMaxLifeSpan() const;					// returns the maximal life span possible
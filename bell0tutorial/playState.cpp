@@ -19,6 +19,9 @@
 #include "graphicsComponentWrite.h"
 #include "sprites.h"
 
+// the game board
+#include "board.h"
+
 
 // bell0bytes mathematics
 #include "geometry.h"
@@ -31,10 +34,12 @@ namespace game
 	/////////////////////////////////////////////////////////////////////////////////////////
 	///////////////////////////// Constructor and Destructor ////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
-	PlayState::PlayState(core::DirectXApp& app, const std::wstring& name) : GameState(app, name)
+	PlayState::PlayState(core::DirectXApp& app, const std::wstring& name) : GameState(app, name), gb(nullptr)
 	{ }
 	PlayState::~PlayState()
-	{ }
+	{
+		delete gb;
+	}
 	PlayState& PlayState::createInstance(core::DirectXApp& app, const std::wstring& stateName)
 	{
 		static PlayState instance(app, stateName);
@@ -53,6 +58,13 @@ namespace game
 		dxApp.getInputComponent().getInputHandler().activeKeyboard = true;
 		dxApp.getInputComponent().getInputHandler().activeMouse = true;
 
+		// create the game board
+		if (gb == nullptr)
+		{
+			try { gb = new GameBoard(dxApp); }
+			catch (std::exception& e) { return e; }
+		}
+
 		// notify the main application class that the game is running
 		isPaused = false;
 
@@ -82,6 +94,9 @@ namespace game
 	/////////////////////////////////////////////////////////////////////////////////////////
 	util::Expected<void> PlayState::handleInput(std::unordered_map<input::GameCommands, input::GameCommand&>& activeKeyMap)
 	{
+		if (gb == nullptr)
+			return { };
+
 		// act on user input
 		for (auto x : activeKeyMap)
 		{
@@ -92,6 +107,14 @@ namespace game
 				dxApp.quitGame();
 				break;
 
+			case input::GameCommands::MoveLeft:
+				gb->moveLeft();
+				break;
+
+			case input::GameCommands::MoveRight:
+				gb->moveRight();
+				break;
+
 			default:
 				break;
 			}
@@ -117,11 +140,14 @@ namespace game
 	/////////////////////////////////////////////////////////////////////////////////////////
 	//////////////////////////////////// Update /////////////////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
-	util::Expected<void> PlayState::update(const double /*deltaTime*/)
+	util::Expected<void> PlayState::update(const double deltaTime)
 	{
-		if (isPaused)
+		if (isPaused || gb == nullptr)
 			return { };
 
+		// update the game world
+		gb->update(deltaTime);
+
 		// return success
 		return { };
 	}
@@ -131,6 +157,10 @@ namespace game
 	/////////////////////////////////////////////////////////////////////////////////////////
 	util::Expected<void> PlayState::render(const double /*farSeer*/)
 	{
+		// draw the game world
+		if (gb != nullptr)
+			gb->draw();
+
 		// print FPS information
 		dxApp.getGraphicsComponent().getWriteComponent().printFPS();
 
@@ -145,6 +175,10 @@ namespace game
 	{
 		isPaused = true;
 
+		// delete the game board
+		delete gb;
+		gb = nullptr;
+
 		// return success
 		return { };
 	}
@@ -6,7 +6,7 @@
 *
 * Desc:		main state of the running game
 *
-* Hist:
+* Hist:	- 20/09/2019: the state creates the game board and forwards the input, the updates and the rendering to it
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
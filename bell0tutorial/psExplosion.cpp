@@ -1,6 +1,7 @@
 #include "psExplosion.h"
 #include "kinematics.h"
 #include <algorithm>
+#include <vector>
 #include "numberTheory.h"
 
 namespace physics
@@ -10,24 +11,36 @@ namespace physics
 		/////////////////////////////////////////////////////////////////////////////////////////
 		/////////////////////////////////// CONSTRUCTOR /////////////////////////////////////////
 		/////////////////////////////////////////////////////////////////////////////////////////
-		ExplosionPS::ExplosionPS(core::DirectXApp& app, const graphics::GraphicsComponent2D& gc, const mathematics::linearAlgebra::Vector2F& pos, const mathematics::linearAlgebra::Vector2F& velocity) : ParticleSystem(app, gc)
+		ExplosionPS::ExplosionPS(core::DirectXApp& app, const graphics::GraphicsComponent2D& gc, const mathematics::linearAlgebra::Vector2F& pos, const mathematics::linearAlgebra::Vector2F& velocity, const EmitterPriority priority) : ParticleSystem(app, gc, priority)
 		{
 			this->position = pos;
 			float velo = velocity.getLength()*0.5f;
 
-			for (unsigned int i = 0; i < getMaxParticles(); i++)
+			// ask the particle budget how many particles may be spawned, and how detailed they may be
+			SpawnGrant grant = ParticleBudget::getInstance().requestSpawn(priority, getMaxParticles(), pos);
+			setMaxLifeSpan(getMaxLifeSpan() * grant.detail);
+			particles.reserve(grant.nParticles);
+
+			// draw all random numbers at once: position (2), velocity (2), age and width
+			// the numbers are counter-based, i.e. the i-th particle always gets the numbers 6i, ..., 6i+5 of the stream of this emitter, no matter which thread spawns it
+			std::vector<float> random(6 * grant.nParticles);
+			nt.createCounterStream(emitterID).fill(random.data(), random.size(), 0, 0.0f, 1.0f);
+
+			for (unsigned int i = 0; i < grant.nParticles; i++)
 			{
-				mathematics::linearAlgebra::Vector2F posi(pos.x + nt.generateRandomFloat(-50.0f, 50.0f), pos.y - nt.generateRandomFloat(-50.0f, 50.0f));
-				mathematics::linearAlgebra::Vector2F vel(nt.generateRandomFloat(-velo, velo), nt.generateRandomFloat(-velo, velo));
+				const float* r = &random[6 * i];
+				mathematics::linearAlgebra::Vector2F posi(pos.x + 100.0f * r[0] - 50.0f, pos.y - (100.0f * r[1] - 50.0f));
+				mathematics::linearAlgebra::Vector2F vel(velo * (2.0f * r[2] - 1.0f), velo * (2.0f * r[3] - 1.0f));
 				mathematics::linearAlgebra::Vector2F acc(0.0f, 0.0f);
-				float age = nt.generateRandomFloat(0.0f, 500.0f);
+				float age = grant.detail * 500.0f * r[4];
+				float width = grant.detail * (0.25f + 2.25f * r[5]);
 
 				if(i % 3 == 0)
-					GenerateParticle(posi, vel, acc, age, L"Black", nt.generateRandomFloat(0.25f, 2.5f));
+					GenerateParticle(posi, vel, acc, age, L"Black", width);
 				else if(i % 3 == 1)
-					GenerateParticle(posi, vel, acc, age, L"DarkGoldenrod", nt.generateRandomFloat(0.25f, 2.5f));
+					GenerateParticle(posi, vel, acc, age, L"DarkGoldenrod", width);
 				else
-					GenerateParticle(posi, vel, acc, age, L"DarkRed", nt.generateRandomFloat(0.25f, 2.5f));
+					GenerateParticle(posi, vel, acc, age, L"DarkRed", width);
 			}
 		}
 
@@ -41,11 +54,16 @@ namespace physics
 		/////////////////////////////////////////////////////////////////////////////////////////
 		bool ExplosionPS::update(double deltaTime)
 		{
+			applyTurbulence(deltaTime);
+
 			for (auto it = particles.begin(); it != particles.end();)
 			{
-				it->update(deltaTime, getMaxLifeSpan());
+				it->update(deltaTime, getMaxLifeSpan(), collisionGrid, restitution);
 				if (it->getAge() > getMaxLifeSpan())
+				{
 					it = particles.erase(it);
+					ParticleBudget::getInstance().releaseParticles(1);
+				}
 				else
 					it++;
 			}
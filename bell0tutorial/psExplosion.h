@@ -6,7 +6,7 @@
 *
 * Desc:		this class defines an explosion particle system
 *
-* History:
+* History:	- 26/08/2019: the number, width and lifespan of the particles are limited by the particle budget
 *
 * ToDo:
 ****************************************************************************************/
@@ -29,7 +29,7 @@ namespace physics
 			virtual void GenerateParticle(const mathematics::linearAlgebra::Vector2F& position, mathematics::linearAlgebra::Vector2F& velocity, const mathematics::linearAlgebra::Vector2F& acceleration, const float age = 0, const std::wstring& colour = L"Black", const float width = 1.0f) override;
 
 		public:
-			ExplosionPS(core::DirectXApp& app, const graphics::GraphicsComponent2D& gc, const mathematics::linearAlgebra::Vector2F& pos, const mathematics::linearAlgebra::Vector2F& velocity);
+			ExplosionPS(core::DirectXApp& app, const graphics::GraphicsComponent2D& gc, const mathematics::linearAlgebra::Vector2F& pos, const mathematics::linearAlgebra::Vector2F& velocity, const EmitterPriority priority = EmitterPriority::Normal);
 			virtual bool update(double deltaTime) override;
 		};
 	}
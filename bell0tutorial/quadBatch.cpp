@@ -0,0 +1,97 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// C++ includes
+#include <chrono>
+
+// the header
+#include "quadBatch.h"
+
+namespace graphics
+{
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// BRUSH HANDLES ///////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	BrushHandles::BrushHandles()
+	{
+		// the black brush is the default brush and always gets the handle 0
+		getHandle(L"Black");
+	}
+
+	BrushHandle BrushHandles::getHandle(const std::wstring& name)
+	{
+		std::unordered_map<std::wstring, BrushHandle>::const_iterator it = handles.find(name);
+		if (it != handles.end())
+			return it->second;
+
+		// register new brush name
+		BrushHandle handle = (BrushHandle)names.size();
+		names.push_back(name);
+		handles[name] = handle;
+		return handle;
+	}
+
+	const std::wstring& BrushHandles::getName(const BrushHandle handle) const
+	{
+		// unknown handles are mapped to the black brush
+		if (handle < names.size())
+			return names[handle];
+		else
+			return names[0];
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// RECORDING BACKEND ///////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void RecordingQuadBatchBackend::submit(const BrushHandle /*brush*/, const Quad* const quads, const unsigned int nQuads) const
+	{
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+		// touch the quad data, as a real backend would
+		volatile float area = 0.0f;
+		for (unsigned int i = 0; i < nQuads; i++)
+			area = area + (quads[i].lrX - quads[i].ulX) * (quads[i].lrY - quads[i].ulY) * quads[i].opacity;
+
+		drawCalls++;
+		this->quads += nQuads;
+		submissionTime += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	void RecordingQuadBatchBackend::reset()
+	{
+		drawCalls = 0;
+		quads = 0;
+		submissionTime = 0.0;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// QUAD BATCH //////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void QuadBatch::add(const BrushHandle brush, const float ulX, const float ulY, const float lrX, const float lrY, const float opacity)
+	{
+		if (brush >= groups.size())
+			groups.resize(brush + 1);
+
+		groups[brush].push_back({ ulX, ulY, lrX, lrY, opacity });
+	}
+
+	void QuadBatch::submit(const QuadBatchBackend& backend) const
+	{
+		for (unsigned int i = 0; i < groups.size(); i++)
+			if (!groups[i].empty())
+				backend.submit(i, groups[i].data(), (unsigned int)groups[i].size());
+	}
+
+	void QuadBatch::clear()
+	{
+		for (auto& group : groups)
+			group.clear();
+	}
+
+	unsigned int QuadBatch::nQuads() const
+	{
+		unsigned int n = 0;
+		for (auto& group : groups)
+			n += (unsigned int)group.size();
+		return n;
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		24/08/2019 - Lenningen - Luxembourg
+*
+* Desc:		batched rendering of axis-aligned quads
+*			quads are collected into per-frame arrays grouped by brush handle, each group is then
+*			handed to a backend in a single call; the backend interface does not depend on Direct2D,
+*			thus the recording backend can be used to count draw calls on any platform
+*
+* History:
+*
+* ToDo:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// C++ includes
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace graphics
+{
+	// handle to a named brush, handles are stable for the lifetime of the application
+	typedef unsigned int BrushHandle;
+
+	// a single quad, the first four members have the same layout as a D2D1_RECT_F
+	struct Quad
+	{
+		float ulX, ulY;								// the upper left corner
+		float lrX, lrY;								// the lower right corner
+		float opacity;								// the opacity of the quad
+	};
+
+	// Brush Handles - Singleton
+	// maps colour names to small integers once, such that renderers do not have to compare or hash strings each frame
+	class BrushHandles
+	{
+	private:
+		std::vector<std::wstring> names;							// the name of each handle
+		std::unordered_map<std::wstring, BrushHandle> handles;		// the handle of each name
+
+	protected:
+		// protected constructor -> singleton
+		BrushHandles();
+
+	public:
+		// create a single instance
+		static BrushHandles& getInstance()
+		{
+			static BrushHandles instance;
+			return instance;
+		};
+
+		// delete copy and assignment operators
+		BrushHandles(BrushHandles const&) = delete;
+		BrushHandles& operator = (BrushHandles const&) = delete;
+
+		BrushHandle getHandle(const std::wstring& name);			// returns the handle of the brush with the given name, registers the name if necessary
+		const std::wstring& getName(const BrushHandle handle) const;// returns the name of the brush
+		unsigned int size() const { return (unsigned int)names.size(); };
+	};
+
+	// the interface each quad renderer has to implement
+	class QuadBatchBackend
+	{
+	public:
+		virtual ~QuadBatchBackend() {};
+
+		// draws all the quads with the specified brush in a single call
+		virtual void submit(const BrushHandle brush, const Quad* const quads, const unsigned int nQuads) const = 0;
+	};
+
+	// the recording backend does not draw anything, it only keeps statistics about the submitted batches
+	class RecordingQuadBatchBackend : public QuadBatchBackend
+	{
+	private:
+		mutable unsigned int drawCalls = 0;			// the number of submitted batches
+		mutable unsigned int quads = 0;				// the number of submitted quads
+		mutable double submissionTime = 0.0;		// the time spent inside the submit function (in seconds)
+
+	public:
+		void submit(const BrushHandle brush, const Quad* const quads, const unsigned int nQuads) const override;
+
+		// statistics
+		unsigned int getNumberOfDrawCalls() const { return drawCalls; };
+		unsigned int getNumberOfQuads() const { return quads; };
+		double getSubmissionTime() const { return submissionTime; };
+		void reset();
+	};
+
+	// the actual quad batch
+	class QuadBatch
+	{
+	private:
+		std::vector<std::vector<Quad> > groups;		// the quads of the current frame, indexed by brush handle
+
+	public:
+		QuadBatch() {};
+
+		// add a quad to the current frame
+		void add(const BrushHandle brush, const float ulX, const float ulY, const float lrX, const float lrY, const float opacity = 1.0f);
+
+		// send one batch per non-empty group to the backend
+		void submit(const QuadBatchBackend& backend) const;
+
+		// clears all groups but keeps their capacity, call once per frame
+		void clear();
+
+		unsigned int nQuads() const;				// returns the number of quads in the current frame
+	};
+}
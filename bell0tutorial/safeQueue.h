@@ -6,68 +6,183 @@
 *
 * Desc:		a thread-safe queue to be used in the event pattern
 *
-* History:
+* History:	- 08/09/2019: blocking mode for worker threads: waits with and without timeout, batch pops and closing the queue
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
 
 // c++ includes
 #include <queue>
+#include <vector>
 #include <mutex>
+#include <chrono>
+#include <utility>
 #include <condition_variable>
 
 // CLASSES //////////////////////////////////////////////////////////////////////////////
 namespace util
 {
+	// the queue can be polled, or consumers can sleep until a message arrives
+	// once the queue is closed, no more messages are accepted; the consumers still get the remaining messages, then they are woken up for good
 	template<class T>
 	class ThreadSafeQueue
 	{
 	public:
 		// constructor and destructor
-		ThreadSafeQueue() : queue(), mutex(), condition() {};
+		ThreadSafeQueue() : queue(), mutex(), condition(), closed(false) {};
 		~ThreadSafeQueue() {};
 
 		// add a message to the queue
-		void enqueue(T& t)
+		// returns false if the queue was closed
+		bool enqueue(const T& t)
 		{
-			// lock the mutex
-			std::lock_guard<std::mutex> lock(mutex);
+			{
+				// lock the mutex
+				std::lock_guard<std::mutex> lock(mutex);
+				if (closed)
+					return false;
 
-			// push the element to the queue
-			queue.push(t);
+				// push the element to the queue
+				queue.push(t);
+			}
 
-			// unlock the thread
+			// wake up a waiting thread, after the lock was released, such that it does not immediately block on the mutex
 			condition.notify_one();
+			return true;
+		}
+
+		bool enqueue(T&& t)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (closed)
+					return false;
+
+				queue.push(std::move(t));
+			}
+
+			condition.notify_one();
+			return true;
 		}
 
 		// get the front message from the queue
-		// if the queue is empty, wait until a message is available
+		// if the queue is empty, a default constructed message is returned
 		const T dequeue()
+		{
+			T message = T();
+			tryDequeue(message);
+			return message;
+		}
+
+		// get the front message from the queue, if there is one
+		bool tryDequeue(T& t)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return pop(t);
+		}
+
+		// get the front message from the queue, wait until a message is available
+		// returns false if the queue was closed and all its messages were consumed
+		bool waitDequeue(T& t)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+
+			// release the lock while waiting
+			condition.wait(lock, [this] { return !queue.empty() || closed; });
+			return pop(t);
+		}
+
+		// get the front message from the queue, wait at most for the given time
+		// returns false if the time ran out or if the queue was closed and all its messages were consumed
+		template<class Rep, class Period>
+		bool waitDequeue(T& t, const std::chrono::duration<Rep, Period>& timeout)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait_for(lock, timeout, [this] { return !queue.empty() || closed; });
+			return pop(t);
+		}
+
+		// move up to maxMessages messages to the back of the vector, under a single lock
+		// returns the number of messages that were moved
+		size_t dequeueBatch(std::vector<T>& messages, const size_t maxMessages)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return popBatch(messages, maxMessages);
+		}
+
+		// as above, but wait until at least one message is available or the queue was closed
+		size_t waitDequeueBatch(std::vector<T>& messages, const size_t maxMessages)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this] { return !queue.empty() || closed; });
+			return popBatch(messages, maxMessages);
+		}
+
+		// as above, but wait at most for the given time
+		template<class Rep, class Period>
+		size_t waitDequeueBatch(std::vector<T>& messages, const size_t maxMessages, const std::chrono::duration<Rep, Period>& timeout)
 		{
 			std::unique_lock<std::mutex> lock(mutex);
-			//while (queue.empty())
-			//	// release the lock while waiting
-			//	condition.wait(lock);
+			condition.wait_for(lock, timeout, [this] { return !queue.empty() || closed; });
+			return popBatch(messages, maxMessages);
+		}
 
-			if (!queue.empty())
+		// stop accepting messages and wake up all waiting threads
+		void close()
+		{
 			{
-				T message = queue.front();
-				queue.pop();
-				return message;
+				std::lock_guard<std::mutex> lock(mutex);
+				closed = true;
 			}
-			else
-				return T();
+			condition.notify_all();
 		}
 
-		// do nothing if the queue is empty
+		// the state of the queue (by the time the caller looks at the result, other threads might have changed it already)
 		const bool isEmpty() const
 		{
+			std::lock_guard<std::mutex> lock(mutex);
 			return queue.empty();
 		}
-		
+
+		const size_t size() const
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return queue.size();
+		}
+
+		const bool isClosed() const
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			return closed;
+		}
+
 	private:
 		std::queue<T> queue;				// the actual queue
 		mutable std::mutex mutex;			// the mutex (basically telling which thread is allowed to access the queue)
 		std::condition_variable condition;	// block the calling thread until notified to resume
+		bool closed;						// true iff the queue no longer accepts messages
+
+		// the mutex must be locked by the caller
+		bool pop(T& t)
+		{
+			if (queue.empty())
+				return false;
+
+			t = std::move(queue.front());
+			queue.pop();
+			return true;
+		}
+
+		size_t popBatch(std::vector<T>& messages, const size_t maxMessages)
+		{
+			size_t n = 0;
+			while (n < maxMessages && !queue.empty())
+			{
+				messages.push_back(std::move(queue.front()));
+				queue.pop();
+				n++;
+			}
+			return n;
+		}
 	};
 }
@@ -0,0 +1,174 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// the header
+#include "saveFile.h"
+
+// c++ includes
+#include <cstdio>
+#include <stdexcept>
+
+// bell0bytes file system
+#include "packArchive.h"
+
+#ifdef _WIN32
+// windows includes
+#include <Windows.h>
+#else
+// posix includes
+#include <fcntl.h>
+#include <unistd.h>
+#include <filesystem>
+#endif
+
+namespace fileSystem
+{
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// CHECKSUMS ///////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	namespace save
+	{
+		namespace
+		{
+			struct CRCTable
+			{
+				uint32_t values[256];
+
+				CRCTable()
+				{
+					for (uint32_t i = 0; i < 256; i++)
+					{
+						uint32_t value = i;
+						for (int bit = 0; bit < 8; bit++)
+							value = (value & 1) ? (value >> 1) ^ 0xEDB88320u : value >> 1;
+						values[i] = value;
+					}
+				}
+			};
+		}
+
+		uint32_t crc32(const void* const data, const size_t size, const uint32_t previousCRC)
+		{
+			static const CRCTable table;
+
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			uint32_t crc = ~previousCRC;
+			for (size_t i = 0; i < size; i++)
+				crc = table.values[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+			return ~crc;
+		}
+
+		/////////////////////////////////////////////////////////////////////////////////////////
+		/////////////////////////////////// RECORDS /////////////////////////////////////////////
+		/////////////////////////////////////////////////////////////////////////////////////////
+		util::Expected<void> writeRecords(const std::wstring& file, const char magic[4], const uint16_t version, const void* const records, const uint16_t recordSize, const uint32_t nRecords)
+		{
+			Header header;
+			std::memcpy(header.magic, magic, sizeof(header.magic));
+			header.version = version;
+			header.recordSize = recordSize;
+			header.nRecords = nRecords;
+
+			const size_t recordsSize = (size_t)recordSize * nRecords;
+			header.crc = crc32(records, recordsSize);
+
+			// the whole file is written at once
+			std::vector<uint8_t> data;
+			try { data.resize(sizeof(Header) + recordsSize); }
+			catch (std::exception& e) { return e; }
+
+			std::memcpy(data.data(), &header, sizeof(Header));
+			if (recordsSize > 0)
+				std::memcpy(data.data() + sizeof(Header), records, recordsSize);
+
+			return writeFileAtomically(file, data.data(), data.size());
+		}
+
+		util::Expected<void> readRecords(const std::wstring& file, const char magic[4], const uint16_t version, const uint16_t recordSize, std::vector<uint8_t>& records, uint32_t& nRecords)
+		{
+			MappedFile mappedFile;
+			util::Expected<void> result = mappedFile.open(file);
+			if (!result.isValid())
+				return result;
+
+			// validate the header
+			if (mappedFile.getSize() < sizeof(Header))
+				return std::runtime_error("The save file is too small!");
+
+			Header header;
+			std::memcpy(&header, mappedFile.getData(), sizeof(Header));
+			if (std::memcmp(header.magic, magic, sizeof(header.magic)) != 0 || header.version != version || header.recordSize != recordSize)
+				return std::runtime_error("The save file is not of the expected type or version!");
+
+			// validate the records
+			const uint8_t* const data = mappedFile.getData() + sizeof(Header);
+			const uint64_t recordsSize = (uint64_t)header.recordSize * header.nRecords;
+			if (recordsSize != mappedFile.getSize() - sizeof(Header))
+				return std::runtime_error("The save file is truncated!");
+
+			if (crc32(data, (size_t)recordsSize) != header.crc)
+				return std::runtime_error("The save file is corrupt!");
+
+			try { records.assign(data, data + recordsSize); }
+			catch (std::exception& e) { return e; }
+			nRecords = header.nRecords;
+
+			// return success
+			return { };
+		}
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// ATOMIC WRITE ////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	util::Expected<void> writeFileAtomically(const std::wstring& file, const void* const data, const size_t size)
+	{
+		const std::wstring temporaryFile = file + L".tmp";
+
+#ifdef _WIN32
+		// write the temporary file and flush it to the disk
+		HANDLE handle = CreateFileW(temporaryFile.c_str(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (handle == INVALID_HANDLE_VALUE)
+			return std::runtime_error("Unable to create the temporary file!");
+
+		DWORD bytesWritten = 0;
+		const bool written = WriteFile(handle, data, (DWORD)size, &bytesWritten, NULL) && bytesWritten == size && FlushFileBuffers(handle);
+		CloseHandle(handle);
+		if (!written)
+		{
+			DeleteFileW(temporaryFile.c_str());
+			return std::runtime_error("Unable to write the temporary file!");
+		}
+
+		// replace the file
+		if (!MoveFileExW(temporaryFile.c_str(), file.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+		{
+			DeleteFileW(temporaryFile.c_str());
+			return std::runtime_error("Unable to replace the file!");
+		}
+#else
+		// write the temporary file and flush it to the disk
+		const std::string temporaryPath = std::filesystem::path(temporaryFile).string();
+		const int handle = open(temporaryPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (handle < 0)
+			return std::runtime_error("Unable to create the temporary file!");
+
+		const bool written = ::write(handle, data, size) == (ssize_t)size && fsync(handle) == 0;
+		close(handle);
+		if (!written)
+		{
+			std::remove(temporaryPath.c_str());
+			return std::runtime_error("Unable to write the temporary file!");
+		}
+
+		// replace the file
+		if (std::rename(temporaryPath.c_str(), std::filesystem::path(file).string().c_str()) != 0)
+		{
+			std::remove(temporaryPath.c_str());
+			return std::runtime_error("Unable to replace the file!");
+		}
+#endif
+
+		// return success
+		return { };
+	}
+}
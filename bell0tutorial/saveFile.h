@@ -0,0 +1,88 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		19/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		binary save files: a small header followed by an array of fixed-size records
+*			the records are plain structures with fixed-width members, written as they are in memory (little endian, like all
+*			targets of the engine); the header stores the type and the version of the records and a CRC32 of the records
+*			a save file is written with a single atomic write (temporary file, flush, rename), thus a crash leaves either the
+*			old or the new file behind; it is loaded with a single read and validated before any record is used
+*
+*			layout: header | records
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// bell0bytes util
+#include "expected.h"
+
+// DEFINITIONS //////////////////////////////////////////////////////////////////////////
+namespace fileSystem
+{
+	namespace save
+	{
+		#pragma pack(push, 1)
+		struct Header
+		{
+			char magic[4];				// the type of the records, i.e. "b0hs" for highscores
+			uint16_t version;			// the version of the records
+			uint16_t recordSize;		// the size of a single record
+			uint32_t nRecords;
+			uint32_t crc;				// the CRC32 of the records
+		};
+		#pragma pack(pop)
+
+		static_assert(sizeof(Header) == 16, "The layout of the save files must not change!");
+
+		// CRC32 (IEEE 802.3), pass the previous result to continue the checksum
+		uint32_t crc32(const void* const data, const size_t size, const uint32_t previousCRC = 0);
+
+		// the records are read and written without any conversion
+		util::Expected<void> writeRecords(const std::wstring& file, const char magic[4], const uint16_t version, const void* const records, const uint16_t recordSize, const uint32_t nRecords);
+		util::Expected<void> readRecords(const std::wstring& file, const char magic[4], const uint16_t version, const uint16_t recordSize, std::vector<uint8_t>& records, uint32_t& nRecords);
+	}
+
+	// writes the file to a temporary file, flushes it to the disk, and then replaces the file
+	util::Expected<void> writeFileAtomically(const std::wstring& file, const void* const data, const size_t size);
+
+	// FUNCTIONS ////////////////////////////////////////////////////////////////////////////
+
+	// writes an array of records to a save file
+	template<typename Record>
+	util::Expected<void> writeSaveFile(const std::wstring& file, const char magic[4], const uint16_t version, const std::vector<Record>& records)
+	{
+		static_assert(std::is_trivially_copyable<Record>::value && sizeof(Record) <= UINT16_MAX, "Save files only store plain records!");
+		return save::writeRecords(file, magic, version, records.data(), (uint16_t)sizeof(Record), (uint32_t)records.size());
+	}
+
+	// reads the records of a save file; the file must have the given type and version and must not be corrupt
+	template<typename Record>
+	util::Expected<void> readSaveFile(const std::wstring& file, const char magic[4], const uint16_t version, std::vector<Record>& records)
+	{
+		static_assert(std::is_trivially_copyable<Record>::value && sizeof(Record) <= UINT16_MAX, "Save files only store plain records!");
+
+		std::vector<uint8_t> data;
+		uint32_t nRecords = 0;
+		util::Expected<void> result = save::readRecords(file, magic, version, (uint16_t)sizeof(Record), data, nRecords);
+		if (!result.isValid())
+			return result;
+
+		records.resize(nRecords);
+		if (nRecords > 0)
+			std::memcpy(records.data(), data.data(), data.size());
+
+		// return success
+		return { };
+	}
+}
@@ -4,6 +4,9 @@
 // bell0bytes graphics
 #include "d2d.h"
 
+// bell0bytes file system
+#include "assets.h"
+
 // bell0bytes util
 #include "serviceLocator.h"
 #include "expected.h"
@@ -22,6 +25,15 @@ namespace graphics
 
 		size = bitmap->GetSize();
 	}
+	Sprite::Sprite(const Direct2D& d2d, const fileSystem::AssetId imageAsset, const float x, const float y, const Layers layer, const unsigned int drawOrder) : d2d(d2d), x(x), y(y), layer(layer), drawOrder(drawOrder)
+	{
+		d2d.createBitmapFromWICBitmap(imageAsset, bitmap);
+
+		if (bitmap == nullptr)
+			throw std::runtime_error("Critical error: failed to create the sprite bitmap!");
+
+		size = bitmap->GetSize();
+	}
 	Sprite::Sprite(const Direct2D& d2d, const float x, const float y, const Layers layer, const unsigned int drawOrder) : d2d(d2d), bitmap(bitmap), x(x), y(y), layer(layer), drawOrder(drawOrder)
 	{ }
 	Sprite::Sprite(const Direct2D& d2d, ID2D1Bitmap1* const bitmap, const float x, const float y, const Layers layer, const unsigned int drawOrder) : d2d(d2d), bitmap(bitmap), x(x), y(y), layer(layer), drawOrder(drawOrder)
@@ -48,6 +60,30 @@ namespace graphics
 		if (spriteSheet == nullptr)
 			throw std::runtime_error("Critical error: Unable to create sprite sheet from file!");
 	}
+	AnimationData::AnimationData(const Direct2D& d2d, const fileSystem::AssetId spriteSheetAsset, const std::vector<AnimationCycleData>& cyclesData) : cyclesData(cyclesData)
+	{
+		d2d.createBitmapFromWICBitmap(spriteSheetAsset, spriteSheet);
+
+		if (spriteSheet == nullptr)
+			throw std::runtime_error("Critical error: Unable to create sprite sheet from file!");
+	}
+	AnimationData::AnimationData(const Direct2D& d2d, const fileSystem::AssetId spriteSheetAsset, const AnimationCycleData& cycleData)
+	{
+		cyclesData.clear();
+		cyclesData.push_back(cycleData);
+
+		d2d.createBitmapFromWICBitmap(spriteSheetAsset, spriteSheet);
+
+		if (spriteSheet == nullptr)
+			throw std::runtime_error("Critical error: Unable to create sprite sheet from file!");
+	}
+	AnimationData::AnimationData(const Direct2D& d2d, const fileSystem::FileData& spriteSheetData, const std::vector<AnimationCycleData>& cyclesData) : cyclesData(cyclesData)
+	{
+		d2d.createBitmapFromWICBitmap(spriteSheetData, spriteSheet);
+
+		if (spriteSheet == nullptr)
+			throw std::runtime_error("Critical error: Unable to create sprite sheet from file!");
+	}
 	SpriteMap::SpriteMap()
 	{
 
@@ -164,6 +200,14 @@ namespace graphics
 		// return success
 		return { };
 	}
+	util::Expected<void> SpriteMap::addSprite(const Direct2D& d2d, const fileSystem::AssetId imageAsset, const float x, const float y, const Layers layer, unsigned int drawOrder)
+	{
+		try { addSprite(*new Sprite(d2d, imageAsset, x, y, layer, drawOrder)); }
+		catch (std::runtime_error& e) { return e; }
+
+		// return success
+		return { };
+	}
 
 	/////////////////////////////////////////////////////////////////////////////////////////
 	////////////////////////////////// Drawing //////////////////////////////////////////////
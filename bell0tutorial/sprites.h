@@ -7,6 +7,8 @@
 * Desc:		Sprites!
 *
 * History: - 29/05/18: AnimatedSprites added
+*			- 18/09/2019: sprites and animations can be loaded from interned assets
+*			- 20/09/2019: animations can be created from images that were read by the file IO service
 *
 * To Do:	- add sprites with multiple sheets
 ****************************************************************************************/
@@ -30,6 +32,12 @@ namespace util
 	class Expected;
 }
 
+namespace fileSystem
+{
+	struct AssetId;
+	class FileData;
+}
+
 namespace graphics
 {
 	// forward declaration
@@ -56,6 +64,7 @@ namespace graphics
 		Sprite(const Direct2D& d2d, const float x = 0.0f, const float y = 0.0f, const Layers layer = Layers::Characters, const unsigned int drawOrder = 0);		// create a sprite from an existing bitmap
 		Sprite(const Direct2D& d2d, ID2D1Bitmap1* const bitmap, const float x = 0.0f, const float y = 0.0f, const Layers layer = Layers::Characters, const unsigned int drawOrder = 0);		// create a sprite from an existing bitmap
 		Sprite(const Direct2D& d2d, LPCWSTR imageFile, const float x = 0.0f, const float y = 0.0f, const Layers layer = Layers::Characters, const unsigned int drawOrder = 0);	// loads an image from the disk and saves it as a sprite
+		Sprite(const Direct2D& d2d, const fileSystem::AssetId imageAsset, const float x = 0.0f, const float y = 0.0f, const Layers layer = Layers::Characters, const unsigned int drawOrder = 0);	// loads an interned image and saves it as a sprite
 		virtual ~Sprite();
 
 		// drawing
@@ -101,6 +110,9 @@ namespace graphics
 	public:
 		AnimationData(const Direct2D& d2d, LPCWSTR spriteSheetFile, const std::vector<AnimationCycleData>& frameData);
 		AnimationData(const Direct2D& d2d, LPCWSTR spriteSheetFile, const AnimationCycleData& frameData);
+		AnimationData(const Direct2D& d2d, const fileSystem::AssetId spriteSheetAsset, const std::vector<AnimationCycleData>& frameData);
+		AnimationData(const Direct2D& d2d, const fileSystem::AssetId spriteSheetAsset, const AnimationCycleData& frameData);
+		AnimationData(const Direct2D& d2d, const fileSystem::FileData& spriteSheetData, const std::vector<AnimationCycleData>& frameData);
 		virtual ~AnimationData();
 
 		friend class AnimatedSprite;
@@ -150,6 +162,7 @@ namespace graphics
 		// populate the sprite map
 		void addSprite(Sprite& sprite);							// adds an existing sprite to its correct map
 		util::Expected<void> addSprite(const Direct2D& d2d, LPCWSTR imageFile, const float x = 0.0f, const float y = 0.0f, const Layers layer = Layers::Characters, unsigned int drawOrder = 0);	// create a new sprite and adds it to sprite map
+		util::Expected<void> addSprite(const Direct2D& d2d, const fileSystem::AssetId imageAsset, const float x = 0.0f, const float y = 0.0f, const Layers layer = Layers::Characters, unsigned int drawOrder = 0);	// as above, from an interned image
 
 		// draw the sprites
 		void draw(D2D1_RECT_F* const destRect, D2D1_RECT_F* const sourceRect, const DrawCommands drawCommand = DrawCommands::All, const float opacity = 1.0f, const D2D1_BITMAP_INTERPOLATION_MODE interPol = D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR) const;	// draw sprites based on layers and draw orders
@@ -0,0 +1,140 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		10/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		a bounded lock-free single-producer single-consumer ring buffer of variable-length records, i.e. log messages
+*			each record is stored as its size followed by its bytes, padded to eight bytes; a record never wraps around the end of the buffer,
+*			if it does not fit before the end, the rest of the lap is skipped;
+*			the producer and the consumer each keep a copy of the position of the other side, thus they only touch the shared cache lines when necessary
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// bell0bytes util
+#include "mpscQueue.h"
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace util
+{
+	template<size_t capacity = 64 * 1024>
+	class SPSCRingBuffer
+	{
+		static_assert(capacity >= 64 && (capacity & (capacity - 1)) == 0, "The capacity of the ring buffer must be a power of two!");
+
+	private:
+		static const size_t mask = capacity - 1;
+		static const uint32_t skipMarker = 0xFFFFFFFF;				// the rest of the lap is unused
+
+		static size_t recordSize(const size_t size) { return (sizeof(uint32_t) + size + 7) & ~(size_t)7; };
+
+		std::unique_ptr<uint64_t[]> storage;						// the buffer, 8-byte aligned
+		char* const data;
+
+		// producer
+		alignas(cacheLineSize) std::atomic<size_t> writePosition;	// the number of bytes written so far, only written by the producer
+		size_t readCache;											// the last known read position
+		size_t pendingPosition;										// the position after the record that is being written
+
+		// consumer
+		alignas(cacheLineSize) std::atomic<size_t> readPosition;	// the number of bytes read so far, only written by the consumer
+
+	public:
+		SPSCRingBuffer() : storage(new uint64_t[capacity / sizeof(uint64_t)]), data(reinterpret_cast<char*>(storage.get())), writePosition(0), readCache(0), pendingPosition(0), readPosition(0) {};
+
+		SPSCRingBuffer(SPSCRingBuffer const&) = delete;
+		SPSCRingBuffer& operator = (SPSCRingBuffer const&) = delete;
+
+		// the largest record that can be stored
+		static constexpr size_t getMaxRecordSize() { return capacity / 2 - sizeof(uint32_t); };
+
+		// reserves space for a record of the given size (producer only)
+		// returns null if the buffer is full, otherwise the record must be published with commit before the next call
+		char* reserve(const size_t size)
+		{
+			if (size > getMaxRecordSize())
+				return nullptr;
+
+			const size_t needed = recordSize(size);
+			size_t position = writePosition.load(std::memory_order_relaxed);
+			const size_t offset = position & mask;
+			const size_t skip = capacity - offset < needed ? capacity - offset : 0;
+
+			// check the free space, only read the position of the consumer if the cached value is not good enough
+			if (position + skip + needed - readCache > capacity)
+			{
+				readCache = readPosition.load(std::memory_order_acquire);
+				if (position + skip + needed - readCache > capacity)
+					return nullptr;
+			}
+
+			if (skip > 0)
+			{
+				// the record does not fit before the end of the buffer: skip the rest of the lap
+				std::memcpy(data + offset, &skipMarker, sizeof(uint32_t));
+				position += skip;
+			}
+
+			const uint32_t size32 = (uint32_t)size;
+			std::memcpy(data + (position & mask), &size32, sizeof(uint32_t));
+			pendingPosition = position + needed;
+			return data + (position & mask) + sizeof(uint32_t);
+		}
+
+		// publishes the reserved record to the consumer (producer only)
+		void commit()
+		{
+			writePosition.store(pendingPosition, std::memory_order_release);
+		}
+
+		// hands each record to the callback, then frees the records (consumer only)
+		// returns the number of records that were read
+		template<class Callback>
+		size_t consume(Callback&& callback)
+		{
+			size_t position = readPosition.load(std::memory_order_relaxed);
+			const size_t end = writePosition.load(std::memory_order_acquire);
+
+			size_t n = 0;
+			while (position != end)
+			{
+				const size_t offset = position & mask;
+				uint32_t size;
+				std::memcpy(&size, data + offset, sizeof(uint32_t));
+
+				if (size == skipMarker)
+				{
+					position += capacity - offset;
+					continue;
+				}
+
+				callback(static_cast<const char*>(data + offset + sizeof(uint32_t)), (size_t)size);
+				position += recordSize(size);
+				n++;
+			}
+
+			readPosition.store(position, std::memory_order_release);
+			return n;
+		}
+
+		// the number of bytes in use (an estimate while the other side is active)
+		size_t size() const
+		{
+			const size_t read = readPosition.load(std::memory_order_relaxed);
+			const size_t write = writePosition.load(std::memory_order_relaxed);
+			return write > read ? write - read : 0;
+		}
+
+		static constexpr size_t getCapacity() { return capacity; };
+	};
+}
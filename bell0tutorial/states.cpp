@@ -14,7 +14,7 @@ namespace core
 	/////////////////////////////////////////////////////////////////////////////////////////
 	///////////////////////////// Constructor and Destructor ////////////////////////////////
 	/////////////////////////////////////////////////////////////////////////////////////////
-	GameState::GameState(DirectXApp& app, const std::wstring& name) : dxApp(app), name(name), gc(dxApp.getGraphicsComponent()), isPaused(false), firstCreation(true)
+	GameState::GameState(DirectXApp& app, const std::wstring& name) : dxApp(app), name(name), gc(dxApp.getGraphicsComponent()), isPaused(false), firstCreation(true), subscriptions((1u << DepescheTypes::ActiveKeyMap) | (1u << DepescheTypes::Gamepad) | (1u << DepescheTypes::TextInput) | (1u << DepescheTypes::TextDelete))
 	{ }
 
 	GameState::~GameState()
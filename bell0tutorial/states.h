@@ -6,7 +6,7 @@
 *
 * Desc:		the states / scenes of a game
 *
-* Hist:
+* Hist:		- 05/09/2019: states subscribe to message types
 ****************************************************************************************/
 
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
@@ -40,6 +40,12 @@ namespace core
 
 
 		bool firstCreation;						// boolean to make sure the fixed layouts are not created more than once
+
+		// subscriptions to multicast messages; by default, each state receives the user input
+		// changes take effect the next time the state stack changes, thus they should be made before the state is pushed
+		unsigned int subscriptions;				// bit i is set iff the state subscribes to messages of type i
+		void subscribe(const DepescheTypes type) { subscriptions |= 1u << type; };
+		void unsubscribe(const DepescheTypes type) { subscriptions &= ~(1u << type); };
 		
 		// protected constructor -> singleton
 		GameState(DirectXApp& app, const std::wstring& name);
@@ -48,6 +54,7 @@ namespace core
 		virtual ~GameState();
 
 		bool isPaused;							// true iff the scene is paused
+		bool isSubscribedTo(const DepescheTypes type) const { return (subscriptions & (1u << type)) != 0; };
 
 		// delete copy and assignment operators
 		GameState(GameState const &) = delete;
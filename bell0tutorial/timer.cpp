@@ -8,6 +8,7 @@
 
 // bell0bytes util
 #include "serviceLocator.h"
+#include "logFilter.h"
 #include "expected.h"
 
 namespace core
@@ -23,10 +24,8 @@ namespace core
 		{
 			// compute the secondsPerCount as the reciprocal of the frequency
 			secondsPerCount = 1.0 / (double)frequency;
-#ifndef NDEBUG
 			// log success
-			util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("The high-precision timer was created successfully.");
-#endif
+			LOG_DEBUG(CoreLog, "The high-precision timer was created successfully.");
 		}
 		else
 			// the hardware does not support a high-precision timer -> throw an error
@@ -35,10 +34,8 @@ namespace core
 
 	Timer::~Timer()
 	{
-#ifndef NDEBUG
 		// log success
-		util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("The timer was successfully destroyed.");
-#endif
+		LOG_DEBUG(CoreLog, "The timer was successfully destroyed.");
 	}
 
 	/////////////////////////////////////////////////////////////////////////////////////////
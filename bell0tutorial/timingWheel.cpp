@@ -0,0 +1,88 @@
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// the header
+#include "timingWheel.h"
+
+namespace core
+{
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// CONSTRUCTOR /////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	TimingWheel::TimingWheel(const double tickLength) : tickLength(tickLength), currentTick(0), nextID(1), nEntries(0)
+	{ }
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// SCHEDULING //////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	uint64_t TimingWheel::scheduleAtTick(const Depesche& depesche, const uint64_t tick)
+	{
+		// messages that are already due are delivered with the next tick
+		const uint64_t deadline = tick > currentTick ? tick : currentTick + 1;
+
+		insert(Entry(nextID, deadline, depesche));
+		scheduled.insert(nextID);
+		nEntries++;
+		return nextID++;
+	}
+
+	bool TimingWheel::cancel(const uint64_t id)
+	{
+		// unknown, delivered and cancelled messages can not be cancelled
+		if (scheduled.erase(id) == 0)
+			return false;
+
+		// the entry stays in the wheel until its slot comes up
+		cancelled.insert(id);
+		nEntries--;
+		return true;
+	}
+
+	/////////////////////////////////////////////////////////////////////////////////////////
+	/////////////////////////////////// WHEEL ///////////////////////////////////////////////
+	/////////////////////////////////////////////////////////////////////////////////////////
+	void TimingWheel::insert(const Entry& entry)
+	{
+		const uint64_t distance = entry.deadline - currentTick;
+
+		// find the lowest level that can hold the distance
+		unsigned int level = 0;
+		while (level < nLevels - 1 && distance >= ((uint64_t)1 << (slotBits * (level + 1))))
+			level++;
+
+		// deadlines beyond the range of the wheel are stored in the last slot that is reached, and reinserted once they come up
+		uint64_t tick = entry.deadline;
+		if (distance >= ((uint64_t)1 << (slotBits * nLevels)))
+			tick = currentTick + ((uint64_t)1 << (slotBits * nLevels)) - 1;
+
+		slots[level][(tick >> (slotBits * level)) & slotMask].push_back(entry);
+	}
+
+	void TimingWheel::clear()
+	{
+		for (auto& level : slots)
+			for (auto& slot : level)
+				slot.clear();
+		scheduled.clear();
+		cancelled.clear();
+	}
+
+	void TimingWheel::cascade(const unsigned int level)
+	{
+		std::vector<Entry>& slot = slots[level][(currentTick >> (slotBits * level)) & slotMask];
+		if (slot.empty())
+			return;
+
+		// the entries are due within the next revolution of the level below
+		std::vector<Entry> entries;
+		entries.swap(slot);
+		for (const Entry& entry : entries)
+			insert(entry);
+
+		// keep the memory of the slot, unless entries beyond the range of the wheel were put back into it
+		if (slot.empty())
+		{
+			entries.clear();
+			slot.swap(entries);
+		}
+	}
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		06/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		a hierarchical timing wheel to deliver messages at a later time, i.e. power-up expiry, delayed sounds or respawns
+*			the wheel has four levels of 256 slots each; a message is stored in the level matching the distance to its deadline,
+*			each time a level completes a revolution, the next slot of the level above is cascaded down:
+*				- scheduling a message takes constant time
+*				- advancing the wheel by one tick takes constant time, plus the time to cascade or deliver the messages that are due
+*			the wheel is driven by the game time, i.e. the sum of the frame times, thus it does not advance while the game is paused
+*			and it delivers the messages on the same frames while a recording is replayed
+*
+* History:	- 20/09/2019: only scheduled messages can be cancelled; cancelled messages are no longer counted
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
+
+// bell0bytes core
+#include "depesche.h"
+
+// CLASSES //////////////////////////////////////////////////////////////////////////////
+namespace core
+{
+	class TimingWheel
+	{
+	private:
+		static const unsigned int nLevels = 4;			// the number of levels
+		static const unsigned int slotBits = 8;			// each level has 2^slotBits slots
+		static const unsigned int nSlots = 1 << slotBits;
+		static const uint64_t slotMask = nSlots - 1;
+
+		struct Entry
+		{
+			uint64_t id;								// the handle of the message, used to cancel it
+			uint64_t deadline;							// the tick at which the message is due
+			Depesche depesche;							// the message
+
+			Entry(const uint64_t id, const uint64_t deadline, const Depesche& depesche) : id(id), deadline(deadline), depesche(depesche) {};
+		};
+
+		const double tickLength;						// the length of a tick in seconds
+		uint64_t currentTick;							// the last tick that was processed
+		uint64_t nextID;								// the handle of the next message
+		size_t nEntries;								// the number of scheduled messages, without the cancelled ones
+
+		std::vector<Entry> slots[nLevels][nSlots];		// the wheel
+		std::vector<Entry> due;							// scratch list of the slot that is being processed
+		std::unordered_set<uint64_t> scheduled;			// the handles of the messages that were neither delivered nor cancelled
+		std::unordered_set<uint64_t> cancelled;			// the handles of the cancelled messages that are still in the wheel
+
+		void insert(const Entry& entry);				// puts an entry into the slot matching its distance to the current tick
+		void cascade(const unsigned int level);			// moves the entries of the current slot of a level to the levels below
+		void clear();									// removes all entries from the wheel
+
+	public:
+		TimingWheel(const double tickLength = 0.001);
+
+		// schedule a message at the given tick or game time; messages that are already due are delivered with the next tick
+		// only messages with inline payloads can be scheduled, as the payloads in the arena only live for a frame
+		// returns a handle to cancel the message
+		uint64_t scheduleAtTick(const Depesche& depesche, const uint64_t tick);
+		uint64_t scheduleAt(const Depesche& depesche, const double time) { return scheduleAtTick(depesche, (uint64_t)(time / tickLength)); };
+
+		bool cancel(const uint64_t id);					// the message will not be delivered; returns false if the message was already delivered or cancelled
+
+		// advances the wheel to the given game time, handing each due message to the callback
+		template<class Callback>
+		void advance(const double time, Callback&& deliver)
+		{
+			const uint64_t targetTick = (uint64_t)(time / tickLength);
+
+			while (currentTick < targetTick)
+			{
+				// nothing to deliver: drop the cancelled entries and jump to the target
+				if (nEntries == 0)
+				{
+					if (!cancelled.empty())
+						clear();
+					currentTick = targetTick;
+					break;
+				}
+
+				currentTick++;
+
+				// cascade the levels whose lower level completed a revolution, the highest level first
+				if ((currentTick & slotMask) == 0)
+				{
+					unsigned int level = 1;
+					while (level < nLevels - 1 && ((currentTick >> (slotBits * level)) & slotMask) == 0)
+						level++;
+					for (; level > 0; level--)
+						cascade(level);
+				}
+
+				// deliver the messages of the current slot
+				std::vector<Entry>& slot = slots[0][currentTick & slotMask];
+				if (slot.empty())
+					continue;
+
+				due.swap(slot);
+				for (const Entry& entry : due)
+				{
+					// cancelled entries were already removed from the count
+					if (!cancelled.empty() && cancelled.erase(entry.id) > 0)
+						continue;
+
+					if (entry.deadline > currentTick)
+						// the deadline was further away than the wheel can hold, the entry stays scheduled
+						insert(entry);
+					else
+					{
+						nEntries--;
+						scheduled.erase(entry.id);
+						Depesche depesche(entry.depesche);
+						deliver(depesche);
+					}
+				}
+				due.clear();
+			}
+		}
+
+		// getters
+		size_t size() const { return nEntries; };		// the number of scheduled messages that were neither delivered nor cancelled
+		uint64_t getCurrentTick() const { return currentTick; };
+		double getTickLength() const { return tickLength; };
+	};
+}
@@ -1,15 +1,5 @@
 // INCLUDES /////////////////////////////////////////////////////////////////////////////
 
-// Lua and Sol
-
-// warning supression no longer needed with C++-17
-//#pragma warning( push )
-//#pragma warning( disable : 4127)	// disable constant if expr warning
-//#pragma warning( disable : 4702)	// disable unreachable code warning
-#include <sol.hpp>
-//#pragma warning( pop ) 
-#pragma comment(lib, "liblua53.a")
-
 // bell0bytes core
 #include "app.h"
 #include "window.h"
@@ -19,7 +9,7 @@
 
 // bell0bytes util
 #include "serviceLocator.h"
-#include "stringConverter.h"
+#include "logFilter.h"
 
 // bell0bytes file system
 #include "fileSystemComponent.h"
@@ -123,8 +113,8 @@ namespace core
 		ShowWindow(mainWindow, SW_SHOW);
 		UpdateWindow(mainWindow);
 
-		// register the application class as observer
-		addObserver(&dxApp);
+		// register the application class as observer of the window events
+		addObserver(&dxApp, eventBit(input::Events::PauseApplication) | eventBit(input::Events::ResumeApplication) | eventBit(input::Events::WindowChanged) | eventBit(input::Events::SwitchFullscreen));
 
 		// log and return success
 		util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>("The main window was successfully created.");
@@ -251,31 +241,10 @@ namespace core
 	/////////////////////////////////////////////////////////////////////////////////////////
 	void Window::readDesiredResolution()
 	{
-		if (dxApp.getFileSystemComponent().hasValidConfigurationFile())
-		{
-			// configuration file exists, try to read from it
-			std::wstring pathToPrefFile = dxApp.getFileSystemComponent().getPathToConfigurationFiles() + L"\\bell0prefs.lua";
-
-			try
-			{
-				sol::state lua;
-				lua.script_file(util::StringConverter::ws2s(pathToPrefFile));
-
-				// read from the configuration file, default to 640 x 480
-				clientWidth = lua["config"]["resolution"]["width"].get_or(640);
-				clientHeight = lua["config"]["resolution"]["height"].get_or(480);
-#ifndef NDEBUG
-				std::stringstream res;
-				res << "The client resolution was read from the Lua configuration file: " << clientWidth << " x " << clientHeight << ".";
-				util::ServiceLocator::getFileLogger()->print<util::SeverityType::info>(res.str());
-#endif
-			}
-			catch (std::exception)
-			{
-				clientWidth = 640;
-				clientHeight = 480;
-				util::ServiceLocator::getFileLogger()->print<util::SeverityType::warning>("Unable to read configuration file. Starting with a default resolution.");
-			}
-		}
+		// the configuration file was read by the configuration service
+		const fileSystem::Configuration& configuration = dxApp.getFileSystemComponent().getConfigService().getConfiguration();
+		clientWidth = configuration.width;
+		clientHeight = configuration.height;
+		LOG_DEBUG(CoreLog, "The client resolution was read from the configuration: %u x %u.", clientWidth, clientHeight);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,95 @@
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		20/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		measures the latency of Logger::print (bell0tutorial/log.h) while 8 threads log at the same time
+*			each thread prints its messages in bursts of 50, with a short pause after each burst, like the systems of a game
+*			during a frame; the latency is the time spent in print, the daemon writes the messages to the log file meanwhile
+*			usage: logBenchmark <log file> [<messages per thread>], the default is 20000
+*			build in release mode together with bell0tutorial/log.cpp and bell0tutorial/logFormat.cpp
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+
+// bell0bytes util
+#include "../../bell0tutorial/log.h"
+
+namespace
+{
+	const unsigned int nThreads = 8;
+	const unsigned int burstLength = 50;
+	const std::chrono::microseconds pause(100);
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2 || argc > 3)
+	{
+		std::cerr << "usage: logBenchmark <log file> [<messages per thread>]" << std::endl;
+		return -1;
+	}
+
+	const std::string file(argv[1]);
+	const unsigned int messagesPerThread = argc == 3 ? (unsigned int)std::stoul(argv[2]) : 20000;
+
+	// the latencies of all threads, in nanoseconds
+	std::vector<double> latencies;
+	std::mutex latenciesMutex;
+
+	{
+		util::Logger<util::FileLogPolicy> logger(std::wstring(file.begin(), file.end()));
+
+		std::vector<std::thread> threads;
+		for (unsigned int t = 0; t < nThreads; t++)
+			threads.emplace_back([&, t]
+			{
+				logger.setThreadName("worker " + std::to_string(t));
+
+				std::vector<double> threadLatencies;
+				threadLatencies.reserve(messagesPerThread);
+				const std::string message = "The particle system of worker " + std::to_string(t) + " was updated.";
+
+				for (unsigned int i = 0; i < messagesPerThread; i++)
+				{
+					const auto begin = std::chrono::steady_clock::now();
+					logger.print<util::SeverityType::info>(message);
+					threadLatencies.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count());
+
+					if (i % burstLength == burstLength - 1)
+						std::this_thread::sleep_for(pause);
+				}
+
+				std::lock_guard<std::mutex> lock(latenciesMutex);
+				latencies.insert(latencies.end(), threadLatencies.begin(), threadLatencies.end());
+			});
+
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	const size_t n = latencies.size();
+	if (n == 0)
+		return 0;
+
+	std::cout << "threads: " << nThreads << ", messages: " << n << ", hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+	std::cout << std::fixed << std::setprecision(0)
+		<< "print latency in ns: p50 " << latencies[n / 2]
+		<< ", p99 " << latencies[n * 99 / 100]
+		<< ", p99.9 " << latencies[n * 999 / 1000]
+		<< ", max " << latencies.back() << std::endl;
+
+	return 0;
+}
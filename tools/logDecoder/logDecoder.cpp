@@ -0,0 +1,63 @@
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		11/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		decodes binary log files into the layout of the text log files
+*			usage: logDecoder <binary log file> [<text file>], the text is written to the standard output if no text file is given
+*			build together with bell0tutorial/logFormat.cpp
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <iostream>
+#include <fstream>
+#include <exception>
+
+// bell0bytes util
+#include "../../bell0tutorial/logFormat.h"
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2 || argc > 3)
+	{
+		std::cerr << "usage: logDecoder <binary log file> [<text file>]" << std::endl;
+		return -1;
+	}
+
+	std::ifstream in(argv[1], std::ios_base::binary | std::ios_base::in);
+	if (!in.is_open())
+	{
+		std::cerr << "Unable to open " << argv[1] << "!" << std::endl;
+		return -1;
+	}
+
+	std::ofstream outputFile;
+	if (argc == 3)
+	{
+		outputFile.open(argv[2], std::ios_base::binary | std::ios_base::out);
+		if (!outputFile.is_open())
+		{
+			std::cerr << "Unable to create " << argv[2] << "!" << std::endl;
+			return -1;
+		}
+	}
+
+	util::Expected<void> result = util::decodeBinaryLog(in, argc == 3 ? static_cast<std::ostream&>(outputFile) : std::cout);
+	if (!result.isValid())
+	{
+		try
+		{
+			result.get();
+		}
+		catch (std::exception& e)
+		{
+			std::cerr << e.what() << std::endl;
+		}
+		return -1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,168 @@
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		20/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		throughput test of the file log policy (bell0tutorial/log.h)
+*				- 4 threads log 250000 formatted messages each to a text file and to a binary file, the time until the logger
+*				  wrote all messages is measured; the test checks that each line is in the file, numbered in order
+*				- 4 threads log 2500 messages each to a text file that is rotated every 16 KB, the test checks that no file is larger
+*				  than that and that the files hold all lines, in order
+*			usage: logThroughputTest <directory>, the log files are written to the directory
+*			returns 0 if all checks passed
+*			build in release mode together with bell0tutorial/log.cpp and bell0tutorial/logFormat.cpp
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+
+// bell0bytes util
+#include "../../bell0tutorial/log.h"
+
+namespace
+{
+	const unsigned int nThreads = 4;
+
+	// logs the messages from all threads, returns the time until the logger was destroyed, i.e. all messages were written, in seconds
+	double logMessages(const std::filesystem::path& file, const util::LogFileFormat format, const util::LogRotation& rotation, const unsigned int messagesPerThread)
+	{
+		const auto begin = std::chrono::steady_clock::now();
+		{
+			util::Logger<util::FileLogPolicy> logger(file.wstring(), format, rotation);
+
+			std::vector<std::thread> threads;
+			for (unsigned int t = 0; t < nThreads; t++)
+				threads.emplace_back([&, t]
+				{
+					logger.setThreadName("worker " + std::to_string(t));
+					for (unsigned int i = 0; i < messagesPerThread; i++)
+						logger.printFormatted<util::SeverityType::info>(LOG_FORMAT("frame %u took %.3f ms in %s"), i, 0.01 * i, "render");
+				});
+
+			for (auto& thread : threads)
+				thread.join();
+		}
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+	}
+
+	// checks that the lines are numbered from the expected line number on, increments the expected line number for each line
+	bool checkLines(std::istream& in, uint64_t& expectedLineNumber)
+	{
+		std::string line;
+		while (std::getline(in, line))
+		{
+			if (line.empty() || line.back() != '\r')
+				return false;
+
+			if (std::stoull(line) != expectedLineNumber)
+				return false;
+			expectedLineNumber++;
+		}
+		return true;
+	}
+
+	bool fail(const std::string& message)
+	{
+		std::cerr << "FAILED: " << message << std::endl;
+		return false;
+	}
+
+	bool testThroughput(const std::filesystem::path& directory)
+	{
+		const unsigned int messagesPerThread = 250000;
+		const uint64_t nMessages = (uint64_t)nThreads * messagesPerThread;
+
+		// text files
+		const std::filesystem::path textFile = directory / "throughput.log";
+		const double textTime = logMessages(textFile, util::LogFileFormat::textFile, util::LogRotation(), messagesPerThread);
+
+		std::ifstream text(textFile, std::ios_base::binary);
+		uint64_t nLines = 0;
+		if (!checkLines(text, nLines) || nLines != nMessages)
+			return fail("the text file does not hold all messages in order");
+
+		// binary files, decoded into the layout of the text files
+		const std::filesystem::path binaryFile = directory / "throughput.bin";
+		const double binaryTime = logMessages(binaryFile, util::LogFileFormat::binaryFile, util::LogRotation(), messagesPerThread);
+
+		std::ifstream binary(binaryFile, std::ios_base::binary);
+		std::stringstream decoded;
+		if (!util::decodeBinaryLog(binary, decoded).isValid())
+			return fail("the binary file could not be decoded");
+
+		nLines = 0;
+		if (!checkLines(decoded, nLines) || nLines != nMessages)
+			return fail("the binary file does not hold all messages in order");
+
+		std::cout << std::fixed << std::setprecision(2)
+			<< "text file:   " << nMessages / textTime / 1e6 << " M messages/s, " << std::filesystem::file_size(textFile) / textTime / 1e6 << " MB/s" << std::endl
+			<< "binary file: " << nMessages / binaryTime / 1e6 << " M messages/s, " << std::filesystem::file_size(binaryFile) / binaryTime / 1e6 << " MB/s" << std::endl;
+		return true;
+	}
+
+	bool testRotation(const std::filesystem::path& directory)
+	{
+		const unsigned int messagesPerThread = 2500;
+		const uint64_t nMessages = (uint64_t)nThreads * messagesPerThread;
+
+		// enough old files are kept to hold all messages
+		util::LogRotation rotation;
+		rotation.maxFileSize = 16 * 1024;
+		rotation.maxFiles = 1000;
+
+		const std::filesystem::path file = directory / "rotation.log";
+		for (unsigned int i = 1; i <= rotation.maxFiles; i++)
+			std::filesystem::remove(file.string() + "." + std::to_string(i));
+		logMessages(file, util::LogFileFormat::textFile, rotation, messagesPerThread);
+
+		// the oldest file has the highest number
+		std::vector<std::filesystem::path> files;
+		for (unsigned int i = rotation.maxFiles; i > 0; i--)
+			if (std::filesystem::exists(file.string() + "." + std::to_string(i)))
+				files.push_back(file.string() + "." + std::to_string(i));
+		files.push_back(file);
+
+		uint64_t nLines = 0;
+		for (const auto& f : files)
+		{
+			if (std::filesystem::file_size(f) > rotation.maxFileSize)
+				return fail(f.string() + " is larger than the maximal file size");
+
+			std::ifstream in(f, std::ios_base::binary);
+			if (!checkLines(in, nLines))
+				return fail(f.string() + " does not continue the previous file");
+		}
+		if (nLines != nMessages)
+			return fail("the rotated files do not hold all messages");
+
+		std::cout << "rotation:    " << nMessages << " messages in " << files.size() << " files" << std::endl;
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2)
+	{
+		std::cerr << "usage: logThroughputTest <directory>" << std::endl;
+		return -1;
+	}
+
+	const std::filesystem::path directory(argv[1]);
+	if (!testThroughput(directory) || !testRotation(directory))
+		return -1;
+
+	std::cout << "all checks passed" << std::endl;
+	return 0;
+}
@@ -0,0 +1,182 @@
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		16/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		builds a pack archive (see bell0tutorial/packArchive.h) from the data folder
+*			usage: packer <data folder> <pack file>, i.e. packer ..\Data ..\Data.pak
+*			files that do not shrink by at least 1/16 (images, compressed audio, ...) are stored, such that the game can read
+*			them without a copy; all other files are compressed
+*			build together with bell0tutorial/packArchive.cpp and bell0tutorial/compression.cpp
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <string>
+
+// bell0bytes util
+#include "../../bell0tutorial/packArchive.h"
+#include "../../bell0tutorial/compression.h"
+
+namespace
+{
+	struct PackedFile
+	{
+		std::string name;					// the normalized name
+		uint64_t hash;
+		std::vector<uint8_t> data;			// the data as it is stored in the archive
+		uint64_t size;						// the size of the file
+		uint32_t compression;
+	};
+
+	// the data is aligned to 8 bytes
+	void pad(std::ofstream& out, uint64_t& position)
+	{
+		static const char zeros[8] = { 0 };
+		const uint64_t padding = (8 - (position & 7)) & 7;
+		out.write(zeros, (std::streamsize)padding);
+		position += padding;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		std::cerr << "usage: packer <data folder> <pack file>" << std::endl;
+		return -1;
+	}
+
+	const std::filesystem::path dataFolder = argv[1];
+	const std::filesystem::path packFile = argv[2];
+
+	// read and compress all files
+	std::vector<PackedFile> files;
+	uint64_t totalSize = 0, totalPackedSize = 0;
+	std::error_code error;
+	for (std::filesystem::recursive_directory_iterator it(dataFolder, error), end; !error && it != end; it.increment(error))
+	{
+		std::error_code sameFile;
+		if (!it->is_regular_file() || std::filesystem::equivalent(it->path(), packFile, sameFile))
+			continue;
+
+		std::ifstream in(it->path(), std::ios_base::binary | std::ios_base::in);
+		if (!in.is_open())
+		{
+			std::cerr << "Unable to open " << it->path().string() << "!" << std::endl;
+			return -1;
+		}
+		std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+		PackedFile file;
+		file.name = fileSystem::pack::normalizeName(it->path().lexically_relative(dataFolder).wstring());
+		file.hash = fileSystem::pack::hashName(file.name);
+		file.size = data.size();
+
+		std::vector<uint8_t> compressedData = util::compressBlock(data.data(), data.size());
+		if (compressedData.size() < data.size() - data.size() / 16)
+		{
+			file.data.swap(compressedData);
+			file.compression = fileSystem::pack::Compressed;
+		}
+		else
+		{
+			file.data.swap(data);
+			file.compression = fileSystem::pack::Stored;
+		}
+
+		totalSize += file.size;
+		totalPackedSize += file.data.size();
+		files.push_back(std::move(file));
+	}
+	if (error)
+	{
+		std::cerr << "Unable to read the data folder " << dataFolder.string() << "!" << std::endl;
+		return -1;
+	}
+
+	// the table of contents is sorted by hash
+	std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) { return a.hash != b.hash ? a.hash < b.hash : a.name < b.name; });
+	for (size_t i = 1; i < files.size(); i++)
+		if (files[i].name == files[i - 1].name)
+		{
+			std::cerr << "The file names " << files[i].name << " only differ by case!" << std::endl;
+			return -1;
+		}
+
+	// write the archive to a temporary file, then replace the old archive
+	std::filesystem::path temporaryFile = packFile;
+	temporaryFile += ".tmp";
+	{
+		std::ofstream out(temporaryFile, std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
+		if (!out.is_open())
+		{
+			std::cerr << "Unable to create " << temporaryFile.string() << "!" << std::endl;
+			return -1;
+		}
+
+		// the header is written once the offsets are known
+		fileSystem::pack::Header header = { };
+		std::copy(std::begin(fileSystem::pack::magic), std::end(fileSystem::pack::magic), header.magic);
+		header.version = fileSystem::pack::version;
+		header.nEntries = (uint32_t)files.size();
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		uint64_t position = sizeof(header);
+
+		// the data
+		std::vector<fileSystem::pack::Entry> entries(files.size());
+		uint32_t nameOffset = 0;
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			pad(out, position);
+			entries[i].hash = files[i].hash;
+			entries[i].offset = position;
+			entries[i].size = files[i].size;
+			entries[i].packedSize = files[i].data.size();
+			entries[i].nameOffset = nameOffset;
+			entries[i].nameLength = (uint32_t)files[i].name.size();
+			entries[i].compression = files[i].compression;
+			entries[i].reserved = 0;
+
+			out.write(reinterpret_cast<const char*>(files[i].data.data()), (std::streamsize)files[i].data.size());
+			position += files[i].data.size();
+			nameOffset += (uint32_t)files[i].name.size();
+		}
+
+		// the table of contents and the names
+		pad(out, position);
+		header.tocOffset = position;
+		out.write(reinterpret_cast<const char*>(entries.data()), (std::streamsize)(entries.size() * sizeof(fileSystem::pack::Entry)));
+		position += entries.size() * sizeof(fileSystem::pack::Entry);
+
+		header.namesOffset = position;
+		for (const auto& file : files)
+			out.write(file.name.data(), (std::streamsize)file.name.size());
+
+		out.seekp(0);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if (!out.good())
+		{
+			std::cerr << "Unable to write " << temporaryFile.string() << "!" << std::endl;
+			return -1;
+		}
+	}
+
+	std::filesystem::rename(temporaryFile, packFile, error);
+	if (error)
+	{
+		std::cerr << "Unable to replace " << packFile.string() << "!" << std::endl;
+		return -1;
+	}
+
+	std::cout << files.size() << " files packed: " << totalSize << " bytes, " << totalPackedSize << " bytes in the archive." << std::endl;
+	return 0;
+}
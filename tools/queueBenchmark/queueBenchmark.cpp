@@ -0,0 +1,167 @@
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		20/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		contention benchmark of the event queue: 1 to 16 producer threads add messages, a single consumer reads them
+*			the lock-free queue (bell0tutorial/mpscQueue.h) is compared with the mutex-based queue (bell0tutorial/safeQueue.h)
+*			that the event queue used before; the consumer polls both queues, like DirectXApp::dispatchMessages
+*			usage: queueBenchmark [<messages per producer>], the default is 100000
+*			the results are the time per message, from the start of the producers until the consumer read the last message,
+*			and the number of times a producer found the lock-free queue full
+*			header only, build in release mode
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// bell0bytes util
+#include "../../bell0tutorial/mpscQueue.h"
+#include "../../bell0tutorial/safeQueue.h"
+
+namespace
+{
+	// a message with the size of a Depesche: sender, destination, type and the inline payload
+	struct Message
+	{
+		void* sender = nullptr;
+		void* destination = nullptr;
+		uint32_t type = 0;
+		uint32_t producer = 0;
+		unsigned char payload[48] = { };
+	};
+
+	struct Result
+	{
+		double nanosecondsPerMessage;
+		uint64_t fullQueue;						// the number of failed pushes
+	};
+
+	Result runLockFree(const unsigned int nProducers, const unsigned int messagesPerProducer)
+	{
+		util::MPSCQueue<Message> queue;
+		std::atomic<uint64_t> fullQueue(0);
+		std::atomic<bool> start(false);
+
+		std::vector<std::thread> producers;
+		for (unsigned int p = 0; p < nProducers; p++)
+			producers.emplace_back([&, p]
+			{
+				Message message;
+				message.producer = p;
+				uint64_t failedPushes = 0;
+
+				while (!start.load(std::memory_order_acquire))
+					std::this_thread::yield();
+
+				for (unsigned int i = 0; i < messagesPerProducer; i++)
+				{
+					message.type = i;
+					while (!queue.tryPush(message))
+					{
+						failedPushes++;
+						std::this_thread::yield();
+					}
+				}
+				fullQueue += failedPushes;
+			});
+
+		const uint64_t nMessages = (uint64_t)nProducers * messagesPerProducer;
+		uint64_t nRead = 0;
+
+		const auto begin = std::chrono::steady_clock::now();
+		start.store(true, std::memory_order_release);
+		while (nRead < nMessages)
+		{
+			const size_t n = queue.drain([](const Message&) { return true; });
+			if (n == 0)
+				std::this_thread::yield();
+			nRead += n;
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		for (auto& producer : producers)
+			producer.join();
+
+		return { std::chrono::duration<double, std::nano>(end - begin).count() / nMessages, fullQueue.load() };
+	}
+
+	Result runMutex(const unsigned int nProducers, const unsigned int messagesPerProducer)
+	{
+		util::ThreadSafeQueue<Message> queue;
+		std::atomic<bool> start(false);
+
+		std::vector<std::thread> producers;
+		for (unsigned int p = 0; p < nProducers; p++)
+			producers.emplace_back([&, p]
+			{
+				Message message;
+				message.producer = p;
+				message.destination = &queue;			// dequeue returns an empty message, without a destination, if the queue is empty
+
+				while (!start.load(std::memory_order_acquire))
+					std::this_thread::yield();
+
+				for (unsigned int i = 0; i < messagesPerProducer; i++)
+				{
+					message.type = i;
+					queue.enqueue(message);
+				}
+			});
+
+		const uint64_t nMessages = (uint64_t)nProducers * messagesPerProducer;
+		uint64_t nRead = 0;
+
+		const auto begin = std::chrono::steady_clock::now();
+		start.store(true, std::memory_order_release);
+		while (nRead < nMessages)
+			if (queue.dequeue().destination != nullptr)
+				nRead++;
+			else
+				std::this_thread::yield();
+		const auto end = std::chrono::steady_clock::now();
+
+		for (auto& producer : producers)
+			producer.join();
+
+		return { std::chrono::duration<double, std::nano>(end - begin).count() / nMessages, 0 };
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int messagesPerProducer = 100000;
+	if (argc == 2)
+		messagesPerProducer = (unsigned int)std::stoul(argv[1]);
+	else if (argc > 2)
+	{
+		std::cerr << "usage: queueBenchmark [<messages per producer>]" << std::endl;
+		return -1;
+	}
+
+	std::cout << "hardware threads: " << std::thread::hardware_concurrency() << ", messages per producer: " << messagesPerProducer << std::endl;
+	std::cout << "producers    lock-free ns/msg    full queue    mutex ns/msg" << std::endl;
+
+	for (unsigned int nProducers = 1; nProducers <= 16; nProducers *= 2)
+	{
+		const Result lockFree = runLockFree(nProducers, messagesPerProducer);
+		const Result mutex = runMutex(nProducers, messagesPerProducer);
+
+		std::cout << std::setw(9) << nProducers << std::fixed << std::setprecision(1)
+			<< std::setw(20) << lockFree.nanosecondsPerMessage
+			<< std::setw(14) << lockFree.fullQueue
+			<< std::setw(16) << mutex.nanosecondsPerMessage << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,146 @@
+/****************************************************************************************
+* Author:	Gilles Bellot
+* Date:		20/09/2019 - Lenningen - Luxembourg
+*
+* Desc:		compares the wake-up latency and the CPU time of a worker thread that waits for messages (bell0tutorial/safeQueue.h)
+*			a producer adds a time-stamped message at a fixed interval, the worker reads the messages:
+*				- polling, sleeping for 1 ms whenever the queue is empty
+*				- polling, yielding whenever the queue is empty
+*				- blocking, with waitDequeue
+*			usage: wakeUpBenchmark [<messages> [<interval in microseconds>]], the defaults are 500 messages every 2000 us
+*			the latency is the time from adding a message until the worker read it, the CPU time is the time of the worker thread
+*			header only, build in release mode
+*
+* History:
+****************************************************************************************/
+
+// INCLUDES /////////////////////////////////////////////////////////////////////////////
+
+// c++ includes
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+#ifdef _WIN32
+// windows includes
+#include <Windows.h>
+#else
+// posix includes
+#include <time.h>
+#endif
+
+// bell0bytes util
+#include "../../bell0tutorial/safeQueue.h"
+
+namespace
+{
+	typedef std::chrono::steady_clock::time_point TimeStamp;
+
+	// the CPU time of the calling thread in milliseconds
+	double getThreadTime()
+	{
+#ifdef _WIN32
+		FILETIME creationTime, exitTime, kernelTime, userTime;
+		GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime);
+		const ULONGLONG kernel = ((ULONGLONG)kernelTime.dwHighDateTime << 32) | kernelTime.dwLowDateTime;
+		const ULONGLONG user = ((ULONGLONG)userTime.dwHighDateTime << 32) | userTime.dwLowDateTime;
+		return (kernel + user) / 10000.0;
+#else
+		timespec time;
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+		return time.tv_sec * 1000.0 + time.tv_nsec / 1000000.0;
+#endif
+	}
+
+	double getLatency(const TimeStamp& timeStamp)
+	{
+		return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - timeStamp).count();
+	}
+
+	// runs the worker until the queue is closed and prints the results
+	template<class Worker>
+	void run(const std::string& name, const unsigned int nMessages, const std::chrono::microseconds interval, Worker worker)
+	{
+		util::ThreadSafeQueue<TimeStamp> queue;
+		std::vector<double> latencies;
+		latencies.reserve(nMessages);
+		double cpuTime = 0.0;
+
+		std::thread workerThread([&]
+		{
+			const double start = getThreadTime();
+			worker(queue, latencies);
+			cpuTime = getThreadTime() - start;
+		});
+
+		for (unsigned int i = 0; i < nMessages; i++)
+		{
+			std::this_thread::sleep_for(interval);
+			queue.enqueue(std::chrono::steady_clock::now());
+		}
+
+		// give the worker time to read the last message, then let it return
+		std::this_thread::sleep_for(interval);
+		queue.close();
+		workerThread.join();
+
+		std::sort(latencies.begin(), latencies.end());
+		const size_t n = latencies.size();
+		std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(12) << (n ? latencies[n / 2] : 0.0)
+			<< std::setw(12) << (n ? latencies[n * 99 / 100] : 0.0)
+			<< std::setw(12) << (n ? latencies.back() : 0.0)
+			<< std::setw(16) << cpuTime << std::endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	unsigned int nMessages = 500;
+	std::chrono::microseconds interval(2000);
+	if (argc > 3)
+	{
+		std::cerr << "usage: wakeUpBenchmark [<messages> [<interval in microseconds>]]" << std::endl;
+		return -1;
+	}
+	if (argc > 1)
+		nMessages = (unsigned int)std::stoul(argv[1]);
+	if (argc > 2)
+		interval = std::chrono::microseconds(std::stoul(argv[2]));
+
+	std::cout << "messages: " << nMessages << ", interval: " << interval.count() << " us" << std::endl;
+	std::cout << "worker           p50 us      p99 us      max us    worker cpu ms" << std::endl;
+
+	run("poll + sleep", nMessages, interval, [](util::ThreadSafeQueue<TimeStamp>& queue, std::vector<double>& latencies)
+	{
+		TimeStamp timeStamp;
+		while (!queue.isClosed() || !queue.isEmpty())
+			if (queue.tryDequeue(timeStamp))
+				latencies.push_back(getLatency(timeStamp));
+			else
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	});
+
+	run("poll + yield", nMessages, interval, [](util::ThreadSafeQueue<TimeStamp>& queue, std::vector<double>& latencies)
+	{
+		TimeStamp timeStamp;
+		while (!queue.isClosed() || !queue.isEmpty())
+			if (queue.tryDequeue(timeStamp))
+				latencies.push_back(getLatency(timeStamp));
+			else
+				std::this_thread::yield();
+	});
+
+	run("blocking", nMessages, interval, [](util::ThreadSafeQueue<TimeStamp>& queue, std::vector<double>& latencies)
+	{
+		TimeStamp timeStamp;
+		while (queue.waitDequeue(timeStamp))
+			latencies.push_back(getLatency(timeStamp));
+	});
+
+	return 0;
+}